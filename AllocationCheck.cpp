@@ -0,0 +1,279 @@
+/**
+ * Audio Sandbox - Allocation Check
+ * Renders a scene that uses every bounded subsystem and fails if the render thread touches the heap
+ * after FSandboxManager::SealAllocations. Meant for SANDBOX_STATIC_CAPACITY builds, where CTest runs it.
+ *
+ * Usage:
+ *   AudioSandboxAllocCheck                 Render an hour of audio; exit code 1 on any heap call
+ *   AudioSandboxAllocCheck --seconds <n>   Render n seconds instead
+ */
+
+#include "SandboxManager.h"
+#include "Offline/StressScene.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+// ============================================================================
+// Heap Call Counting
+// ============================================================================
+
+namespace
+{
+	/** A heap call made while counting; Size is 0 for frees */
+	struct FHeapCall
+	{
+		size_t Size;
+		int64 Block;
+	};
+
+	constexpr int32 MaxRecordedCalls = 16;
+
+	// Only the thread that renders counts, so helper threads of the runtime do not fail the check
+	thread_local bool bCountingThread = false;
+	std::atomic<int64> NumHeapCalls(0);
+	std::atomic<int64> CurrentBlock(0);
+	FHeapCall RecordedCalls[MaxRecordedCalls];
+
+	void RecordHeapCall(size_t Size)
+	{
+		if (!bCountingThread)
+		{
+			return;
+		}
+		const int64 Index = NumHeapCalls.fetch_add(1, std::memory_order_relaxed);
+		if (Index < MaxRecordedCalls)
+		{
+			RecordedCalls[Index].Size = Size;
+			RecordedCalls[Index].Block = CurrentBlock.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+#if defined(__GLIBC__)
+
+// glibc lets an executable replace the allocator entry points and still reach its own; this sees
+// every allocation, including those of the C runtime and of operator new
+extern "C"
+{
+	void* __libc_malloc(size_t Size);
+	void* __libc_calloc(size_t Count, size_t Size);
+	void* __libc_realloc(void* Pointer, size_t Size);
+	void* __libc_memalign(size_t Alignment, size_t Size);
+	void __libc_free(void* Pointer);
+
+	void* malloc(size_t Size) noexcept
+	{
+		RecordHeapCall(Size);
+		return __libc_malloc(Size);
+	}
+
+	void* calloc(size_t Count, size_t Size) noexcept
+	{
+		RecordHeapCall(Count * Size);
+		return __libc_calloc(Count, Size);
+	}
+
+	void* realloc(void* Pointer, size_t Size) noexcept
+	{
+		RecordHeapCall(Size);
+		return __libc_realloc(Pointer, Size);
+	}
+
+	void* aligned_alloc(size_t Alignment, size_t Size) noexcept
+	{
+		RecordHeapCall(Size);
+		return __libc_memalign(Alignment, Size);
+	}
+
+	int posix_memalign(void** OutPointer, size_t Alignment, size_t Size) noexcept
+	{
+		RecordHeapCall(Size);
+		*OutPointer = __libc_memalign(Alignment, Size);
+		return *OutPointer ? 0 : ENOMEM;
+	}
+
+	void free(void* Pointer) noexcept
+	{
+		if (Pointer)
+		{
+			RecordHeapCall(0);
+		}
+		__libc_free(Pointer);
+	}
+}
+
+#else
+
+// Elsewhere only operator new and delete can be replaced portably
+void* operator new(size_t Size)
+{
+	RecordHeapCall(Size);
+	if (void* Pointer = std::malloc(Size ? Size : 1))
+	{
+		return Pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t Size)
+{
+	return operator new(Size);
+}
+
+void operator delete(void* Pointer) noexcept
+{
+	if (Pointer)
+	{
+		RecordHeapCall(0);
+	}
+	std::free(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+	operator delete(Pointer);
+}
+
+void operator delete(void* Pointer, size_t) noexcept
+{
+	operator delete(Pointer);
+}
+
+void operator delete[](void* Pointer, size_t) noexcept
+{
+	operator delete(Pointer);
+}
+
+#endif
+
+// ============================================================================
+// Scene
+// ============================================================================
+
+namespace
+{
+	constexpr float SampleRate = 48000.0f;
+	constexpr int32 BlockFrames = 512;
+
+	/**
+	 * Stress scene plus timeline spawns, impulses, parameter changes and generator swaps spread over
+	 * the whole render, a rhythm pattern striking a body, and wind on every body
+	 */
+	void BuildScene(FSandboxManager& Sandbox, int64 TotalFrames)
+	{
+		FStressSceneConfig Config;
+		Config.NumBodies = FMath::Min(8, FSandboxCapacity::MaxBodies / 2);
+		Config.NumVoices = FMath::Min(4, FSandboxCapacity::MaxVoices);
+		FStressSceneGenerator::Build(Sandbox, Config);
+		const int32 NumBodies = FMath::Max(Sandbox.GetPhysicsWorld()->GetObjects().Num(), 1);
+
+		FSceneTimeline* Timeline = Sandbox.GetTimeline();
+		const int32 NumSpawns = FSandboxCapacity::MaxBodies - Sandbox.GetPhysicsWorld()->GetObjects().Num();
+		const int32 NumEvents = FMath::Max(FMath::Min(FSandboxCapacity::MaxEvents, Timeline->GetMaxEvents()) - NumSpawns, 0);
+		for (int32 i = 0; i < NumSpawns; ++i)
+		{
+			const int64 Frame = TotalFrames * (i + 1) / (NumSpawns + 1);
+			Timeline->AddSpawnSphere(Frame, FVector3((float)(i % 5) - 2.0f, 6.0f, (float)(i % 3) - 1.0f), 0.3f, 2.0f);
+		}
+
+		const EProceduralGeneratorType SwapTypes[] =
+		{
+			EProceduralGeneratorType::PerlinNoise,
+			EProceduralGeneratorType::Chaotic,
+			EProceduralGeneratorType::Spectral,
+			EProceduralGeneratorType::Markov
+		};
+		for (int32 i = 0; i < NumEvents; ++i)
+		{
+			const int64 Frame = TotalFrames * (2 * i + 1) / (2 * NumEvents);
+			switch (i % 3)
+			{
+			case 0:
+				Timeline->AddImpulse(Frame, i % NumBodies, FVector3(0.0f, 4.0f, 0.0f));
+				break;
+			case 1:
+				Timeline->AddParameterChange(Frame, ETimelineParameter::FrequencyMax, (i % 2) ? 1500.0f : 2500.0f);
+				break;
+			default:
+				// Two slots keep the generator pool at two per type plus one in flight
+				Timeline->AddGeneratorSwap(Frame, (i % 2) ? EProceduralParameter::Amplitude : EProceduralParameter::Frequency,
+					SwapTypes[(i / 3) % 4], (uint32)i);
+				break;
+			}
+		}
+
+		FRhythmGenerator* Rhythm = Sandbox.GetRhythmGenerator();
+		const int32 Pulse = Rhythm->AddEuclideanPattern(3, 8);
+		FTimelineEvent Strike;
+		Strike.Type = ETimelineEventType::ApplyImpulse;
+		Strike.BodyIndex = 0;
+		Strike.Vector = FVector3(0.0f, 3.0f, 0.0f);
+		Sandbox.SetRhythmAction(Pulse, Strike);
+
+		Sandbox.GetForceFields()->AddWind(FVector3(1.0f, 0.0f, 0.0f), 0.5f, 2.0f);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	double Seconds = 3600.0;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--seconds") == 0)
+		{
+			Seconds = std::atof(argv[++i]);
+		}
+	}
+	const int64 NumBlocks = FMath::Max((int64)(Seconds * SampleRate) / BlockFrames, (int64)1);
+
+	FSandboxManager Sandbox(SampleRate, BlockFrames);
+	BuildScene(Sandbox, NumBlocks * BlockFrames);
+	if (!Sandbox.SealAllocations())
+	{
+		std::cout << "Warning: the scene spawns or swaps more than the capacity allows; excess is refused" << std::endl;
+	}
+
+	static float Output[BlockFrames * 2];
+
+	std::cout << "Rendering " << NumBlocks << " blocks of " << BlockFrames << " frames ("
+		<< Seconds << " s at " << SampleRate << " Hz), static capacity "
+		<< (SANDBOX_STATIC_CAPACITY ? "on" : "off") << std::endl;
+
+	bCountingThread = true;
+	for (int64 Block = 0; Block < NumBlocks; ++Block)
+	{
+		CurrentBlock.store(Block, std::memory_order_relaxed);
+		Sandbox.Update(Output, BlockFrames);
+	}
+	bCountingThread = false;
+
+	FSandboxManager::FSandboxStats Stats;
+	Sandbox.GetStats(Stats);
+	std::cout << Stats.ActivePhysicsObjects << " bodies, " << Stats.RefusedSpawns << " refused spawns" << std::endl;
+
+	const int64 NumCalls = NumHeapCalls.load();
+	if (NumCalls == 0)
+	{
+		std::cout << "No heap calls while rendering" << std::endl;
+		return 0;
+	}
+
+	std::cout << NumCalls << " heap calls while rendering; first ones:" << std::endl;
+	for (int64 i = 0; i < FMath::Min(NumCalls, (int64)MaxRecordedCalls); ++i)
+	{
+		std::cout << "  block " << RecordedCalls[i].Block << ": ";
+		if (RecordedCalls[i].Size > 0)
+		{
+			std::cout << "allocate " << RecordedCalls[i].Size << " bytes" << std::endl;
+		}
+		else
+		{
+			std::cout << "free" << std::endl;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,591 @@
+#include "AssetHotReload.h"
+#include "Procedural/ExpressionGenerator.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	struct FAssetField
+	{
+		FString Key;
+		FString Value;
+	};
+
+	bool IsBlank(TCHAR Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\r';
+	}
+
+	/**
+	 * Split text into "key = value" fields
+	 * Blank lines and lines starting with '#' are skipped; values run to the end of the line
+	 */
+	bool ParseFields(const FString& Text, TArray<FAssetField>& OutFields, FString& OutError)
+	{
+		const TCHAR* Chars = *Text;
+		const int32 Length = Text.Len();
+		int32 Line = 1;
+
+		for (int32 Start = 0; Start < Length; ++Line)
+		{
+			int32 End = Start;
+			while (End < Length && Chars[End] != '\n')
+			{
+				++End;
+			}
+			const int32 Next = End + 1;
+
+			while (Start < End && IsBlank(Chars[Start]))
+			{
+				++Start;
+			}
+			while (End > Start && IsBlank(Chars[End - 1]))
+			{
+				--End;
+			}
+
+			if (Start < End && Chars[Start] != '#')
+			{
+				int32 Equals = Start;
+				while (Equals < End && Chars[Equals] != '=')
+				{
+					++Equals;
+				}
+				if (Equals == End)
+				{
+					OutError = FString::Printf(TEXT("line %d: expected 'key = value'"), Line);
+					return false;
+				}
+
+				int32 KeyEnd = Equals;
+				while (KeyEnd > Start && IsBlank(Chars[KeyEnd - 1]))
+				{
+					--KeyEnd;
+				}
+				int32 ValueStart = Equals + 1;
+				while (ValueStart < End && IsBlank(Chars[ValueStart]))
+				{
+					++ValueStart;
+				}
+
+				FAssetField Field;
+				Field.Key = FString(KeyEnd - Start, Chars + Start);
+				Field.Value = FString(End - ValueStart, Chars + ValueStart);
+				OutFields.Add(MoveTemp(Field));
+			}
+
+			Start = Next;
+		}
+		return true;
+	}
+
+	/** Decimal number with optional sign and fraction */
+	bool ParseFloat(const FString& Value, float& OutValue)
+	{
+		const TCHAR* Chars = *Value;
+		int32 Position = 0;
+		const bool bNegative = Chars[0] == '-';
+		if (Chars[0] == '-' || Chars[0] == '+')
+		{
+			++Position;
+		}
+
+		double Result = 0.0;
+		int32 Digits = 0;
+		for (; Chars[Position] >= '0' && Chars[Position] <= '9'; ++Position, ++Digits)
+		{
+			Result = Result * 10.0 + (Chars[Position] - '0');
+		}
+		if (Chars[Position] == '.')
+		{
+			++Position;
+			for (double Scale = 0.1; Chars[Position] >= '0' && Chars[Position] <= '9'; ++Position, ++Digits, Scale *= 0.1)
+			{
+				Result += (Chars[Position] - '0') * Scale;
+			}
+		}
+
+		if (Digits == 0 || Position != Value.Len())
+		{
+			return false;
+		}
+		OutValue = (float)(bNegative ? -Result : Result);
+		return true;
+	}
+
+	/** Parse Field as a number into the entry of Keys that names it */
+	struct FFloatKey
+	{
+		const TCHAR* Key;
+		float* Target;
+	};
+
+	bool ApplyFloatField(const FAssetField& Field, const FFloatKey* Keys, int32 NumKeys, FString& OutError)
+	{
+		for (int32 i = 0; i < NumKeys; ++i)
+		{
+			if (Field.Key == Keys[i].Key)
+			{
+				if (!ParseFloat(Field.Value, *Keys[i].Target))
+				{
+					OutError = FString::Printf(TEXT("'%s' is not a number"), *Field.Key);
+					return false;
+				}
+				return true;
+			}
+		}
+		OutError = FString::Printf(TEXT("unknown key '%s'"), *Field.Key);
+		return false;
+	}
+
+	bool ParseSlot(const FString& Value, EProceduralParameter& OutSlot)
+	{
+		static const TCHAR* Names[] = { TEXT("frequency"), TEXT("amplitude"), TEXT("richness"), TEXT("duration") };
+		for (int32 i = 0; i < (int32)EProceduralParameter::Count; ++i)
+		{
+			if (Value == Names[i])
+			{
+				OutSlot = (EProceduralParameter)i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool GetAssetType(const std::filesystem::path& Path, EHotAssetType& OutType)
+	{
+		const std::filesystem::path Extension = Path.extension();
+		if (Extension == ".material")
+		{
+			OutType = EHotAssetType::Material;
+		}
+		else if (Extension == ".preset")
+		{
+			OutType = EHotAssetType::SynthPreset;
+		}
+		else if (Extension == ".graph")
+		{
+			OutType = EHotAssetType::GeneratorGraph;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadTextFile(const std::filesystem::path& Path, FString& OutText)
+	{
+		std::ifstream Stream(Path, std::ios::binary);
+		if (!Stream)
+		{
+			return false;
+		}
+		Stream.seekg(0, std::ios::end);
+		const std::streamoff Size = Stream.tellg();
+		Stream.seekg(0, std::ios::beg);
+
+		TArray<char> Bytes;
+		Bytes.SetNum((int32)FMath::Max<std::streamoff>(Size, 0));
+		Stream.read(Bytes.GetData(), Bytes.Num());
+		if (!Stream)
+		{
+			return false;
+		}
+		OutText = FString(Bytes.Num(), Bytes.GetData());
+		return true;
+	}
+}
+
+// ============================================================================
+// FEpochReclaimer Implementation
+// ============================================================================
+
+FEpochReclaimer::FEpochReclaimer()
+	: GlobalEpoch(1)
+{
+	for (FReaderSlot& Reader : Readers)
+	{
+		Reader.Epoch.store(IdleEpoch, std::memory_order_relaxed);
+		Reader.bClaimed.store(false, std::memory_order_relaxed);
+	}
+}
+
+FEpochReclaimer::~FEpochReclaimer()
+{
+	for (const FRetiredObject& Object : Retired)
+	{
+		Object.Deleter(Object.Object);
+	}
+}
+
+int32 FEpochReclaimer::RegisterReader()
+{
+	for (int32 i = 0; i < MaxReaders; ++i)
+	{
+		bool bExpected = false;
+		if (Readers[i].bClaimed.compare_exchange_strong(bExpected, true, std::memory_order_acq_rel))
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FEpochReclaimer::UnregisterReader(int32 Slot)
+{
+	Readers[Slot].Epoch.store(IdleEpoch, std::memory_order_release);
+	Readers[Slot].bClaimed.store(false, std::memory_order_release);
+}
+
+void FEpochReclaimer::RetireObject(void* Object, void (*Deleter)(void*))
+{
+	std::lock_guard<std::mutex> Lock(RetireLock);
+
+	// Readers that enter after this increment can only see the replacement
+	FRetiredObject Entry;
+	Entry.Object = Object;
+	Entry.Deleter = Deleter;
+	Entry.Epoch = GlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+	Retired.Add(Entry);
+}
+
+int32 FEpochReclaimer::Reclaim()
+{
+	std::lock_guard<std::mutex> Lock(RetireLock);
+
+	uint64 OldestReader = IdleEpoch;
+	for (const FReaderSlot& Reader : Readers)
+	{
+		OldestReader = FMath::Min(OldestReader, Reader.Epoch.load(std::memory_order_seq_cst));
+	}
+
+	int32 Deleted = 0;
+	for (int32 i = 0; i < Retired.Num();)
+	{
+		if (Retired[i].Epoch < OldestReader)
+		{
+			Retired[i].Deleter(Retired[i].Object);
+			Retired.RemoveAtSwap(i);
+			++Deleted;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	return Deleted;
+}
+
+int32 FEpochReclaimer::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> Lock(RetireLock);
+	return Retired.Num();
+}
+
+// ============================================================================
+// FAssetHotReloader Implementation
+// ============================================================================
+
+FAssetHotReloader::FAssetHotReloader()
+	: Material(Reclaimer)
+	, Preset(Reclaimer)
+	, PublishedVersion(0)
+	, ReloadCount(0)
+	, FailedCount(0)
+	, NextVersion(0)
+	, bStopRequested(false)
+	, bWakeRequested(false)
+	, PollInterval(0.25f)
+{
+	for (int32 i = 0; i < NumSlots; ++i)
+	{
+		Graphs[i] = MakeUnique<THotAsset<FGeneratorGraphAsset>>(Reclaimer);
+	}
+}
+
+FAssetHotReloader::~FAssetHotReloader()
+{
+	Stop();
+}
+
+bool FAssetHotReloader::Start(const FString& Directory, float PollIntervalSeconds)
+{
+	if (IsRunning())
+	{
+		return false;
+	}
+
+	WatchDirectory = Directory;
+	PollInterval = FMath::Max(PollIntervalSeconds, 0.001f);
+	bStopRequested = false;
+	LoaderThread = std::thread(&FAssetHotReloader::LoaderMain, this);
+	return true;
+}
+
+void FAssetHotReloader::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(WakeLock);
+		bStopRequested = true;
+	}
+	WakeSignal.notify_one();
+	LoaderThread.join();
+
+	Reclaimer.Reclaim();
+}
+
+void FAssetHotReloader::Submit(EHotAssetType Type, const FString& Text)
+{
+	{
+		std::lock_guard<std::mutex> Lock(QueueLock);
+		FSubmission Submission;
+		Submission.Type = Type;
+		Submission.Text = Text;
+		Submission.Origin = TEXT("(submitted)");
+		Queue.Add(MoveTemp(Submission));
+	}
+	{
+		std::lock_guard<std::mutex> Lock(WakeLock);
+		bWakeRequested = true;
+	}
+	WakeSignal.notify_one();
+}
+
+void FAssetHotReloader::LoaderMain()
+{
+	std::unique_lock<std::mutex> Lock(WakeLock);
+	while (!bStopRequested)
+	{
+		bWakeRequested = false;
+		Lock.unlock();
+		Poll();
+		Lock.lock();
+
+		WakeSignal.wait_for(Lock, std::chrono::duration<float>(PollInterval), [this]() { return bStopRequested || bWakeRequested; });
+	}
+}
+
+int32 FAssetHotReloader::Poll()
+{
+	std::lock_guard<std::mutex> Guard(PollLock);
+
+	TArray<FSubmission> Pending;
+	{
+		std::lock_guard<std::mutex> Lock(QueueLock);
+		Swap(Pending, Queue);
+	}
+	if (!WatchDirectory.IsEmpty())
+	{
+		ScanDirectory(Pending);
+	}
+
+	int32 Published = 0;
+	for (const FSubmission& Submission : Pending)
+	{
+		Published += Load(Submission.Type, Submission.Text, Submission.Origin) ? 1 : 0;
+	}
+
+	Reclaimer.Reclaim();
+	return Published;
+}
+
+void FAssetHotReloader::ScanDirectory(TArray<FSubmission>& OutChanged)
+{
+	std::error_code Error;
+	for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator(*WatchDirectory, Error))
+	{
+		EHotAssetType Type;
+		if (!Entry.is_regular_file(Error) || !GetAssetType(Entry.path(), Type))
+		{
+			continue;
+		}
+
+		const int64 ModifiedTime = (int64)Entry.last_write_time(Error).time_since_epoch().count();
+		const FString Path(Entry.path().string().c_str());
+
+		FWatchedFile* Watched = nullptr;
+		for (FWatchedFile& File : WatchedFiles)
+		{
+			if (File.Path == Path)
+			{
+				Watched = &File;
+				break;
+			}
+		}
+		if (Watched && Watched->ModifiedTime == ModifiedTime)
+		{
+			continue;
+		}
+
+		FSubmission Submission;
+		Submission.Type = Type;
+		Submission.Origin = Path;
+		if (!ReadTextFile(Entry.path(), Submission.Text))
+		{
+			// Probably mid-write; try again on the next poll
+			continue;
+		}
+
+		if (Watched)
+		{
+			Watched->ModifiedTime = ModifiedTime;
+		}
+		else
+		{
+			WatchedFiles.Add({ Path, ModifiedTime });
+		}
+		OutChanged.Add(MoveTemp(Submission));
+	}
+}
+
+bool FAssetHotReloader::Load(EHotAssetType Type, const FString& Text, const FString& Origin)
+{
+	TArray<FAssetField> Fields;
+	FString Error;
+	if (!ParseFields(Text, Fields, Error))
+	{
+		SetError(FString::Printf(TEXT("%s: %s"), *Origin, *Error));
+		return false;
+	}
+
+	switch (Type)
+	{
+	case EHotAssetType::Material:
+	{
+		TUniquePtr<FMaterialAsset> Asset = MakeUnique<FMaterialAsset>();
+		const FFloatKey Keys[] = {
+			{ TEXT("hardness"), &Asset->Hardness },
+			{ TEXT("damping"), &Asset->Damping } };
+		for (const FAssetField& Field : Fields)
+		{
+			if (!ApplyFloatField(Field, Keys, 2, Error))
+			{
+				SetError(FString::Printf(TEXT("%s: %s"), *Origin, *Error));
+				return false;
+			}
+		}
+
+		Asset->Hardness = FMath::Clamp(Asset->Hardness, 0.0f, 1.0f);
+		const float HardnessScale = 0.2f + 0.8f * Asset->Hardness;
+		Asset->MinFrequency = 100.0f * HardnessScale;
+		Asset->MaxFrequency = 4000.0f * HardnessScale;
+		Asset->Version = ++NextVersion;
+		Material.Publish(MoveTemp(Asset));
+		PublishedVersion.store(NextVersion, std::memory_order_release);
+		break;
+	}
+
+	case EHotAssetType::SynthPreset:
+	{
+		TUniquePtr<FSynthPresetAsset> Asset = MakeUnique<FSynthPresetAsset>();
+		const FFloatKey Keys[] = {
+			{ TEXT("volume"), &Asset->MasterVolume },
+			{ TEXT("resonance_frequency"), &Asset->ResonanceFrequency },
+			{ TEXT("resonance_quality"), &Asset->ResonanceQuality },
+			{ TEXT("resonance_damping"), &Asset->ResonanceDamping },
+			{ TEXT("frequency_min"), &Asset->FrequencyMin },
+			{ TEXT("frequency_max"), &Asset->FrequencyMax },
+			{ TEXT("amplitude_min"), &Asset->AmplitudeMin },
+			{ TEXT("amplitude_max"), &Asset->AmplitudeMax },
+			{ TEXT("duration_min"), &Asset->DurationMin },
+			{ TEXT("duration_max"), &Asset->DurationMax } };
+		for (const FAssetField& Field : Fields)
+		{
+			if (!ApplyFloatField(Field, Keys, 10, Error))
+			{
+				SetError(FString::Printf(TEXT("%s: %s"), *Origin, *Error));
+				return false;
+			}
+		}
+
+		Asset->Version = ++NextVersion;
+		Preset.Publish(MoveTemp(Asset));
+		PublishedVersion.store(NextVersion, std::memory_order_release);
+		break;
+	}
+
+	case EHotAssetType::GeneratorGraph:
+	{
+		TUniquePtr<FGeneratorGraphAsset> Asset = MakeUnique<FGeneratorGraphAsset>();
+		float Seed = 12345.0f;
+		float TimeStep = -1.0f;
+		bool bHasSlot = false;
+		const FFloatKey Keys[] = {
+			{ TEXT("seed"), &Seed },
+			{ TEXT("timestep"), &TimeStep } };
+		for (const FAssetField& Field : Fields)
+		{
+			if (Field.Key == TEXT("slot"))
+			{
+				bHasSlot = ParseSlot(Field.Value, Asset->Slot);
+				if (!bHasSlot)
+				{
+					Error = FString::Printf(TEXT("unknown slot '%s'"), *Field.Value);
+				}
+			}
+			else if (Field.Key == TEXT("expression"))
+			{
+				Asset->Source = Field.Value;
+			}
+			else
+			{
+				ApplyFloatField(Field, Keys, 2, Error);
+			}
+			if (!Error.IsEmpty())
+			{
+				SetError(FString::Printf(TEXT("%s: %s"), *Origin, *Error));
+				return false;
+			}
+		}
+		if (!bHasSlot || Asset->Source.IsEmpty())
+		{
+			SetError(FString::Printf(TEXT("%s: a graph needs a slot and an expression"), *Origin));
+			return false;
+		}
+
+		TUniquePtr<FExpressionGenerator> Generator = MakeUnique<FExpressionGenerator>((uint32)Seed);
+		if (!Generator->Compile(Asset->Source, &Error))
+		{
+			SetError(FString::Printf(TEXT("%s: %s"), *Origin, *Error));
+			return false;
+		}
+		if (TimeStep > 0.0f)
+		{
+			Generator->SetTimeStep(TimeStep);
+		}
+
+		const int32 Slot = (int32)Asset->Slot;
+		Asset->Generator = MoveTemp(Generator);
+		Asset->Version = ++NextVersion;
+		Graphs[Slot]->Publish(MoveTemp(Asset));
+
+		// Announced right after the asset, never before it, so a reader that sees the version also sees the asset;
+		// readers track each asset's own version, so seeing the asset first is harmless
+		PublishedVersion.store(NextVersion, std::memory_order_release);
+		break;
+	}
+	}
+
+	ReloadCount.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void FAssetHotReloader::SetError(const FString& Error)
+{
+	std::lock_guard<std::mutex> Lock(QueueLock);
+	LastError = Error;
+	FailedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+FString FAssetHotReloader::GetLastError() const
+{
+	std::lock_guard<std::mutex> Lock(QueueLock);
+	return LastError;
+}
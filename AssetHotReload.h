@@ -0,0 +1,287 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Procedural/ProceduralGeneration.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * Epoch-based deferred reclamation for objects shared with real-time readers
+ *
+ * Readers publish the global epoch they entered at; writers tag each retired
+ * object with the epoch at which it was unlinked. An object is deleted once
+ * every active reader entered after it was retired. Entering and leaving a
+ * read section is two atomic stores: readers never block, allocate or free.
+ */
+class FEpochReclaimer
+{
+public:
+	static constexpr int32 MaxReaders = 8;
+
+	FEpochReclaimer();
+
+	/** Deletes everything still retired; no reader may be inside a read section */
+	~FEpochReclaimer();
+
+	/**
+	 * Claim a reader slot, once per reading thread
+	 * @return Slot index, or INDEX_NONE if all slots are taken
+	 */
+	int32 RegisterReader();
+	void UnregisterReader(int32 Slot);
+
+	// Reader side
+	void EnterRead(int32 Slot) { Readers[Slot].Epoch.store(GlobalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst); }
+	void ExitRead(int32 Slot) { Readers[Slot].Epoch.store(IdleEpoch, std::memory_order_release); }
+
+	// Writer side
+	/** Hand over an object that has already been unlinked from every shared pointer */
+	template<typename T>
+	void Retire(T* Object)
+	{
+		if (Object)
+		{
+			RetireObject(Object, [](void* Ptr) { delete static_cast<T*>(Ptr); });
+		}
+	}
+
+	/**
+	 * Delete retired objects that no reader can still hold
+	 * @return Number of objects deleted
+	 */
+	int32 Reclaim();
+
+	int32 GetPendingCount() const;
+
+private:
+	static constexpr uint64 IdleEpoch = ~(uint64)0;
+
+	struct alignas(64) FReaderSlot
+	{
+		std::atomic<uint64> Epoch;
+		std::atomic<bool> bClaimed;
+	};
+
+	struct FRetiredObject
+	{
+		void* Object;
+		void (*Deleter)(void*);
+		uint64 Epoch;
+	};
+
+	std::atomic<uint64> GlobalEpoch;
+	FReaderSlot Readers[MaxReaders];
+
+	mutable std::mutex RetireLock;
+	TArray<FRetiredObject> Retired;
+
+	void RetireObject(void* Object, void (*Deleter)(void*));
+};
+
+/**
+ * Pointer to an immutable asset, replaced by publishing a new one
+ * Readers load it inside a read section; the replaced asset is retired to the reclaimer.
+ */
+template<typename T>
+class THotAsset
+{
+public:
+	explicit THotAsset(FEpochReclaimer& InReclaimer)
+		: Reclaimer(InReclaimer)
+		, Current(nullptr)
+	{
+	}
+
+	~THotAsset() { delete Current.load(std::memory_order_acquire); }
+
+	THotAsset(const THotAsset&) = delete;
+	THotAsset& operator=(const THotAsset&) = delete;
+
+	/** Reader side, inside a read section; nullptr until the first Publish */
+	const T* Get() const { return Current.load(std::memory_order_seq_cst); }
+
+	/** Writer side */
+	void Publish(TUniquePtr<T> NewAsset)
+	{
+		Reclaimer.Retire(Current.exchange(NewAsset.Release(), std::memory_order_seq_cst));
+	}
+
+private:
+	FEpochReclaimer& Reclaimer;
+	std::atomic<T*> Current;
+};
+
+/**
+ * Reloadable asset kinds, chosen by file extension
+ */
+enum class EHotAssetType : uint8
+{
+	Material,        // *.material
+	SynthPreset,     // *.preset
+	GeneratorGraph   // *.graph
+};
+
+/**
+ * Material: how struck bodies sound and lose energy
+ *   hardness = 0..1    Scales the impact frequency range as the parameter sweep does
+ *   damping  = 0..1    Applied to every body (omit to leave bodies untouched)
+ */
+struct FMaterialAsset
+{
+	uint32 Version = 0;
+	float Hardness = 0.5f;
+	float Damping = -1.0f;       // < 0 leaves body damping unchanged
+	float MinFrequency = 60.0f;  // Derived from Hardness
+	float MaxFrequency = 2400.0f;
+};
+
+/**
+ * Synth preset: output level, resonator and procedural ranges
+ *   volume, resonance_frequency, resonance_quality, resonance_damping,
+ *   frequency_min/max, amplitude_min/max, duration_min/max
+ */
+struct FSynthPresetAsset
+{
+	uint32 Version = 0;
+	float MasterVolume = 0.8f;
+	float ResonanceFrequency = 440.0f;
+	float ResonanceQuality = 10.0f;
+	float ResonanceDamping = 0.1f;
+	float FrequencyMin = 100.0f, FrequencyMax = 2000.0f;
+	float AmplitudeMin = 0.1f, AmplitudeMax = 0.8f;
+	float DurationMin = 0.1f, DurationMax = 1.0f;
+};
+
+/**
+ * Generator graph: an expression generator for one procedural parameter
+ *   slot       = frequency | amplitude | richness | duration
+ *   expression = <FExpressionProgram source, rest of the line>
+ *   seed, timestep (optional)
+ */
+struct FGeneratorGraphAsset
+{
+	uint32 Version = 0;
+	EProceduralParameter Slot = EProceduralParameter::Frequency;
+	FString Source;
+
+	// Compiled and constructed on the loader thread. The consumer exchanges it for the
+	// generator it replaces, which is then deleted with this asset when it is reclaimed.
+	// Only one consumer can adopt it.
+	mutable TUniquePtr<FProceduralGenerator> Generator;
+};
+
+/**
+ * Background loader for materials, synth presets and generator graphs
+ *
+ * A loader thread watches a directory (and accepts submitted text), parses and
+ * compiles changed assets, builds their generators, and publishes each asset
+ * with a single pointer swap. The audio thread reads the current assets inside
+ * a read section and never waits for, allocates or frees anything; replaced
+ * assets are deleted on the loader thread once no reader can still see them.
+ */
+class FAssetHotReloader
+{
+public:
+	FAssetHotReloader();
+	~FAssetHotReloader();
+
+	/**
+	 * Start the loader thread on a directory of *.material, *.preset and *.graph files
+	 * Every file is loaded once, then again whenever its modification time changes
+	 * @param Directory Directory to watch; empty to only load submitted text
+	 * @return false if already running
+	 */
+	bool Start(const FString& Directory, float PollIntervalSeconds = 0.25f);
+	void Stop();
+	bool IsRunning() const { return LoaderThread.joinable(); }
+
+	/** Queue asset text for the loader thread (editor or network pushes) */
+	void Submit(EHotAssetType Type, const FString& Text);
+
+	/**
+	 * Load queued text and changed files, then reclaim replaced assets
+	 * Called by the loader thread; call directly when no thread was started
+	 * @return Number of assets published
+	 */
+	int32 Poll();
+
+	// Audio thread
+	/**
+	 * Read section; assets obtained inside it stay valid until it ends
+	 * ReaderSlot comes from RegisterReader
+	 */
+	class FReadScope
+	{
+	public:
+		FReadScope(FAssetHotReloader& InReloader, int32 InSlot) : Reloader(InReloader), Slot(InSlot) { Reloader.Reclaimer.EnterRead(Slot); }
+		~FReadScope() { Reloader.Reclaimer.ExitRead(Slot); }
+
+	private:
+		FAssetHotReloader& Reloader;
+		int32 Slot;
+	};
+
+	int32 RegisterReader() { return Reclaimer.RegisterReader(); }
+	void UnregisterReader(int32 Slot) { Reclaimer.UnregisterReader(Slot); }
+
+	/** Version of the newest published asset; readers skip the read section while it is unchanged */
+	uint32 GetPublishedVersion() const { return PublishedVersion.load(std::memory_order_acquire); }
+
+	const FMaterialAsset* GetMaterial() const { return Material.Get(); }
+	const FSynthPresetAsset* GetPreset() const { return Preset.Get(); }
+	const FGeneratorGraphAsset* GetGraph(EProceduralParameter Slot) const { return Graphs[(int32)Slot]->Get(); }
+
+	// Diagnostics (not for the audio thread)
+	int32 GetReloadCount() const { return ReloadCount.load(std::memory_order_relaxed); }
+	int32 GetFailedCount() const { return FailedCount.load(std::memory_order_relaxed); }
+	int32 GetPendingReclaimCount() const { return Reclaimer.GetPendingCount(); }
+	FString GetLastError() const;
+
+private:
+	struct FSubmission
+	{
+		EHotAssetType Type;
+		FString Text;
+		FString Origin;   // File path, for error messages
+	};
+
+	struct FWatchedFile
+	{
+		FString Path;
+		int64 ModifiedTime;
+	};
+
+	static constexpr int32 NumSlots = (int32)EProceduralParameter::Count;
+
+	FEpochReclaimer Reclaimer;
+	THotAsset<FMaterialAsset> Material;
+	THotAsset<FSynthPresetAsset> Preset;
+	TUniquePtr<THotAsset<FGeneratorGraphAsset>> Graphs[NumSlots];
+
+	std::atomic<uint32> PublishedVersion;
+	std::atomic<int32> ReloadCount;
+	std::atomic<int32> FailedCount;
+	uint32 NextVersion;
+
+	// Loader thread
+	std::thread LoaderThread;
+	std::mutex WakeLock;
+	std::condition_variable WakeSignal;
+	bool bStopRequested;
+	bool bWakeRequested;
+	FString WatchDirectory;
+	float PollInterval;
+	TArray<FWatchedFile> WatchedFiles;
+	std::mutex PollLock;
+
+	mutable std::mutex QueueLock;
+	TArray<FSubmission> Queue;
+	FString LastError;
+
+	void LoaderMain();
+	void ScanDirectory(TArray<FSubmission>& OutChanged);
+	bool Load(EHotAssetType Type, const FString& Text, const FString& Origin);
+	void SetError(const FString& Error);
+};
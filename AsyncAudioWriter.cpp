@@ -0,0 +1,217 @@
+#include "AsyncAudioWriter.h"
+#include "Offline/WavWriter.h"
+
+// ============================================================================
+// FAsyncAudioWriter Implementation
+// ============================================================================
+
+FAsyncAudioWriter::FAsyncAudioWriter(int32 InMaxBlocks)
+	: MaxBlocks(FMath::Max(InMaxBlocks, 2))
+	, PoolMemory(EMemoryTag::IO)
+	, PeakBlocksInUse(0)
+	, bWriting(false)
+	, bStopping(false)
+{
+	// Under an I/O budget the pool shrinks to what fits, down to the two blocks it needs to make progress
+	while (MaxBlocks > 2 && !PoolMemory.TrySet((int64)MaxBlocks * BlockBytes))
+	{
+		MaxBlocks /= 2;
+	}
+	MaxBlocks = FMath::Max(MaxBlocks, 2);
+	PoolMemory.Set((int64)MaxBlocks * BlockBytes);
+
+	Pool.SetNum(MaxBlocks * BlockBytes);
+	FreeBlocks.Reserve(MaxBlocks);
+	for (int32 Block = MaxBlocks - 1; Block >= 0; --Block)
+	{
+		FreeBlocks.Add(Block);
+	}
+	Pending.Reserve(MaxBlocks);
+
+	WriterThread = std::thread([this]() { WriterLoop(); });
+}
+
+FAsyncAudioWriter::~FAsyncAudioWriter()
+{
+	{
+		std::lock_guard<std::mutex> Lock(QueueLock);
+		bStopping = true;
+	}
+	QueueSignal.notify_one();
+	WriterThread.join();
+}
+
+int32 FAsyncAudioWriter::OpenStream(const FString& Filename, int32 NumChannels, int32 SampleRate,
+	ESampleFormat Format, EDitherMode Dither, uint32 DitherSeed)
+{
+	if (NumChannels <= 0 || NumChannels > FSampleFormatConverter::MaxChannels || SampleRate <= 0)
+	{
+		return INDEX_NONE;
+	}
+
+	TUniquePtr<FStream> Stream = MakeUnique<FStream>();
+	Stream->File.open(*Filename, std::ios::binary | std::ios::trunc);
+	if (!Stream->File)
+	{
+		return INDEX_NONE;
+	}
+
+	TArray<uint8> Header;
+	FWavWriter::BuildHeader(Header, NumChannels, SampleRate, Format, 0);
+	Stream->File.write(reinterpret_cast<const char*>(Header.GetData()), Header.Num());
+
+	Stream->Converter.SetFormat(Format);
+	Stream->Converter.SetDither(Dither);
+	Stream->Converter.Reset(DitherSeed);
+	Stream->NumChannels = NumChannels;
+	Stream->SampleRate = SampleRate;
+	Stream->Format = Format;
+	Stream->DataBytes = 0;
+	Stream->bClosing = false;
+	Stream->bFailed = !Stream->File;
+
+	std::lock_guard<std::mutex> Lock(QueueLock);
+	return Streams.Add(MoveTemp(Stream));
+}
+
+bool FAsyncAudioWriter::Write(int32 StreamId, const float* Interleaved, int32 NumFrames)
+{
+	FStream* Stream = FindStream(StreamId);
+	if (!Stream || Stream->bClosing || Stream->bFailed)
+	{
+		return false;
+	}
+
+	const int32 FrameBytes = Stream->NumChannels * GetSampleFormatBytes(Stream->Format);
+	const int32 FramesPerBlock = BlockBytes / FrameBytes;
+	for (int32 Frame = 0; Frame < NumFrames; Frame += FramesPerBlock)
+	{
+		const int32 Count = FMath::Min(FramesPerBlock, NumFrames - Frame);
+		const int32 Block = AcquireBlock();
+
+		// Conversion and dither run here, so they scale with the number of producers
+		Stream->Converter.ConvertInterleaved(Interleaved + Frame * Stream->NumChannels, Stream->NumChannels, Count,
+			Pool.GetData() + Block * BlockBytes);
+		Enqueue({ Stream, Block, Count * FrameBytes });
+	}
+	return true;
+}
+
+void FAsyncAudioWriter::CloseStream(int32 StreamId)
+{
+	FStream* Stream = FindStream(StreamId);
+	if (!Stream || Stream->bClosing)
+	{
+		return;
+	}
+
+	Stream->bClosing = true;
+	Enqueue({ Stream, INDEX_NONE, 0 });
+}
+
+bool FAsyncAudioWriter::Flush()
+{
+	std::unique_lock<std::mutex> Lock(QueueLock);
+	DoneSignal.wait(Lock, [this]() { return Pending.Num() == 0 && !bWriting; });
+
+	bool bSucceeded = true;
+	for (const TUniquePtr<FStream>& Stream : Streams)
+	{
+		bSucceeded = bSucceeded && !Stream->bFailed;
+	}
+	return bSucceeded;
+}
+
+FAsyncAudioWriter::FStream* FAsyncAudioWriter::FindStream(int32 StreamId)
+{
+	std::lock_guard<std::mutex> Lock(QueueLock);
+	return Streams.IsValidIndex(StreamId) ? Streams[StreamId].Get() : nullptr;
+}
+
+int32 FAsyncAudioWriter::AcquireBlock()
+{
+	std::unique_lock<std::mutex> Lock(QueueLock);
+	DoneSignal.wait(Lock, [this]() { return FreeBlocks.Num() > 0; });
+
+	const int32 Block = FreeBlocks.Pop();
+	PeakBlocksInUse = FMath::Max(PeakBlocksInUse, MaxBlocks - FreeBlocks.Num());
+	return Block;
+}
+
+void FAsyncAudioWriter::Enqueue(const FWriteRequest& Request)
+{
+	{
+		std::lock_guard<std::mutex> Lock(QueueLock);
+		Pending.Add(Request);
+	}
+	QueueSignal.notify_one();
+}
+
+void FAsyncAudioWriter::WriterLoop()
+{
+	TArray<FWriteRequest> Batch;
+	Batch.Reserve(MaxBlocks);
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(QueueLock);
+			bWriting = false;
+			if (Pending.Num() == 0)
+			{
+				DoneSignal.notify_all();
+			}
+			QueueSignal.wait(Lock, [this]() { return Pending.Num() > 0 || bStopping; });
+			if (Pending.Num() == 0)
+			{
+				return;
+			}
+
+			// Take the whole queue; producers keep appending to the emptied array
+			Swap(Batch, Pending);
+			bWriting = true;
+		}
+
+		for (const FWriteRequest& Request : Batch)
+		{
+			Process(Request);
+		}
+		Batch.Reset();
+	}
+}
+
+void FAsyncAudioWriter::Process(const FWriteRequest& Request)
+{
+	FStream& Stream = *Request.Stream;
+
+	if (Request.Block == INDEX_NONE)
+	{
+		TArray<uint8> Header;
+		FWavWriter::BuildHeader(Header, Stream.NumChannels, Stream.SampleRate, Stream.Format, Stream.DataBytes);
+		Stream.File.seekp(0);
+		Stream.File.write(reinterpret_cast<const char*>(Header.GetData()), Header.Num());
+		Stream.File.close();
+		if (Stream.File.fail())
+		{
+			Stream.bFailed = true;
+		}
+		return;
+	}
+
+	if (!Stream.bFailed)
+	{
+		Stream.File.write(reinterpret_cast<const char*>(Pool.GetData() + Request.Block * BlockBytes), Request.Bytes);
+		Stream.DataBytes += (uint32)Request.Bytes;
+		if (!Stream.File)
+		{
+			Stream.bFailed = true;
+		}
+	}
+
+	// Return the block as soon as it is on disk so a waiting producer can continue
+	{
+		std::lock_guard<std::mutex> Lock(QueueLock);
+		FreeBlocks.Add(Request.Block);
+	}
+	DoneSignal.notify_all();
+}
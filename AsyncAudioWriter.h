@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Audio/SampleFormat.h"
+#include "MemoryAccounting.h"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+/**
+ * Streams many WAV files to disk from a background thread
+ *
+ * Callers convert their audio into blocks taken from a fixed pool and queue
+ * them; a single writer thread drains the queue in order and returns the
+ * blocks. When every block is in flight Write waits for one to come back, so
+ * memory stays at MaxBlocks * BlockBytes however fast audio is produced.
+ *
+ * Any number of threads may write at once, but each stream must be written
+ * and closed by one thread at a time.
+ */
+class FAsyncAudioWriter
+{
+public:
+	static constexpr int32 BlockBytes = 64 * 1024;
+
+	/** @param InMaxBlocks Size of the block pool (at least 2); halved until it fits the I/O memory budget */
+	explicit FAsyncAudioWriter(int32 InMaxBlocks = 64);
+
+	/** Writes everything still queued, then stops the writer thread */
+	~FAsyncAudioWriter();
+
+	FAsyncAudioWriter(const FAsyncAudioWriter&) = delete;
+	FAsyncAudioWriter& operator=(const FAsyncAudioWriter&) = delete;
+
+	/**
+	 * Create a file and write a placeholder header; sizes are filled in on close
+	 * @param DitherSeed Seed of the stream's dither noise; use distinct seeds for files that will be summed
+	 * @return Stream id, or INDEX_NONE if the file could not be created
+	 */
+	int32 OpenStream(const FString& Filename, int32 NumChannels, int32 SampleRate,
+		ESampleFormat Format = ESampleFormat::Float32, EDitherMode Dither = EDitherMode::TPDF, uint32 DitherSeed = 1);
+
+	/**
+	 * Convert and queue interleaved audio
+	 * @return false if the stream is unknown, closed or has failed
+	 */
+	bool Write(int32 StreamId, const float* Interleaved, int32 NumFrames);
+
+	/** Queue the end of a stream; its header is rewritten and the file closed in the background */
+	void CloseStream(int32 StreamId);
+
+	/**
+	 * Wait until everything queued so far has been written
+	 * @return false if any stream has failed to write
+	 */
+	bool Flush();
+
+	/** Most blocks ever queued at once; reaching the pool size means writers had to wait */
+	int32 GetPeakBlocksInUse() const { return PeakBlocksInUse; }
+	int32 GetMaxBlocks() const { return MaxBlocks; }
+
+private:
+	struct FStream
+	{
+		std::ofstream File;
+		FSampleFormatConverter Converter;
+		int32 NumChannels;
+		int32 SampleRate;
+		ESampleFormat Format;
+		uint32 DataBytes;            // Writer thread only
+		bool bClosing;               // Owning caller only
+		std::atomic<bool> bFailed;
+	};
+
+	struct FWriteRequest
+	{
+		FStream* Stream;
+		int32 Block;   // INDEX_NONE closes the stream
+		int32 Bytes;
+	};
+
+	int32 MaxBlocks;
+	TArray<uint8> Pool;
+	FMemoryCharge PoolMemory;
+	TArray<TUniquePtr<FStream>> Streams;
+
+	// Guards everything below
+	std::mutex QueueLock;
+	std::condition_variable QueueSignal;   // Work queued, or stopping
+	std::condition_variable DoneSignal;    // A block was returned, or the queue drained
+	TArray<int32> FreeBlocks;
+	TArray<FWriteRequest> Pending;
+	int32 PeakBlocksInUse;
+	bool bWriting;
+	bool bStopping;
+
+	std::thread WriterThread;
+
+	FStream* FindStream(int32 StreamId);
+	int32 AcquireBlock();
+	void Enqueue(const FWriteRequest& Request);
+	void WriterLoop();
+	void Process(const FWriteRequest& Request);
+};
@@ -0,0 +1,283 @@
+#include "AudioFeatures.h"
+#include <cmath>
+
+namespace
+{
+	constexpr float Pi = 3.14159265f;
+
+	// Fraction of spectral energy below the rolloff frequency
+	constexpr float RolloffFraction = 0.85f;
+
+	// Keeps logs finite on digital silence
+	constexpr float LogFloor = 1e-10f;
+
+	inline float HzToMel(float Hz)
+	{
+		return 2595.0f * std::log10(1.0f + Hz / 700.0f);
+	}
+
+	inline float MelToHz(float Mel)
+	{
+		return 700.0f * (std::pow(10.0f, Mel / 2595.0f) - 1.0f);
+	}
+
+	const TCHAR* const SpectralFeatureNames[] =
+	{
+		TEXT("rms"), TEXT("centroid"), TEXT("spread"), TEXT("rolloff"), TEXT("flatness"), TEXT("flux"), TEXT("onset")
+	};
+}
+
+// ============================================================================
+// FAudioFeatureExtractor Implementation
+// ============================================================================
+
+FAudioFeatureExtractor::FAudioFeatureExtractor(float InSampleRate, const FAudioFeatureConfig& InConfig)
+	: SampleRate(InSampleRate)
+	, Config(InConfig)
+{
+	Config.FrameSize = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Clamp(Config.FrameSize, 64, 1 << MaxFftSizeLog2));
+	Config.HopSize = FMath::Clamp(Config.HopSize, 1, Config.FrameSize);
+	Config.NumMelBands = FMath::Max(Config.NumMelBands, NumMfcc);
+	const float Nyquist = SampleRate * 0.5f;
+	Config.MaxFrequency = Config.MaxFrequency > 0.0f ? FMath::Min(Config.MaxFrequency, Nyquist) : Nyquist;
+	Config.MinFrequency = FMath::Clamp(Config.MinFrequency, 0.0f, Config.MaxFrequency);
+
+	const int32 N = Config.FrameSize;
+	NumBins = N / 2 + 1;
+
+	Fft = &GetFftTables(N);
+
+	// Triangular mel filters, stored sparsely as runs of bin weights
+	const float MelMin = HzToMel(Config.MinFrequency);
+	const float MelMax = HzToMel(Config.MaxFrequency);
+	const float BinHz = SampleRate / N;
+	MelBands.SetNum(Config.NumMelBands);
+	for (int32 Band = 0; Band < Config.NumMelBands; ++Band)
+	{
+		const float Lower = MelToHz(MelMin + (MelMax - MelMin) * Band / (Config.NumMelBands + 1));
+		const float Center = MelToHz(MelMin + (MelMax - MelMin) * (Band + 1) / (Config.NumMelBands + 1));
+		const float Upper = MelToHz(MelMin + (MelMax - MelMin) * (Band + 2) / (Config.NumMelBands + 1));
+
+		FMelBand& MelBand = MelBands[Band];
+		MelBand.FirstBin = FMath::Clamp(FMath::CeilToInt(Lower / BinHz), 0, NumBins - 1);
+		MelBand.FirstWeight = MelWeights.Num();
+		for (int32 Bin = MelBand.FirstBin; Bin < NumBins && Bin * BinHz <= Upper; ++Bin)
+		{
+			const float Hz = Bin * BinHz;
+			const float Weight = Hz <= Center
+				? (Hz - Lower) / FMath::Max(Center - Lower, 1e-6f)
+				: (Upper - Hz) / FMath::Max(Upper - Center, 1e-6f);
+			MelWeights.Add(FMath::Max(Weight, 0.0f));
+		}
+		MelBand.NumBins = MelWeights.Num() - MelBand.FirstWeight;
+	}
+
+	// Orthonormal DCT-II of the log mel energies
+	const int32 M = Config.NumMelBands;
+	Dct.SetNum(NumMfcc * M);
+	for (int32 k = 0; k < NumMfcc; ++k)
+	{
+		const float Scale = std::sqrt((k == 0 ? 1.0f : 2.0f) / M);
+		for (int32 m = 0; m < M; ++m)
+		{
+			Dct[k * M + m] = Scale * std::cos(Pi * k * (m + 0.5f) / M);
+		}
+	}
+
+	Input.SetNum(N);
+	PreviousMagnitude.SetNum(NumBins);
+	Real.SetNum(N);
+	Imag.SetNum(N);
+	Magnitude.SetNum(NumBins);
+	MelEnergy.SetNum(M);
+
+	Reset();
+}
+
+void FAudioFeatureExtractor::Reset()
+{
+	InputFill = 0;
+	FluxAverage = 0.0f;
+	bPreviousOnset = false;
+	NumAnalysisFrames = 0;
+	FMemory::Memzero(PreviousMagnitude.GetData(), sizeof(float) * PreviousMagnitude.Num());
+}
+
+int32 FAudioFeatureExtractor::Process(const float* Interleaved, int32 NumChannels, int32 NumFrames, TArray<float>& OutFeatures)
+{
+	const float ChannelScale = 1.0f / FMath::Max(NumChannels, 1);
+	int32 Emitted = 0;
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const float* Samples = Interleaved + Frame * NumChannels;
+		float Mono = 0.0f;
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			Mono += Samples[Channel];
+		}
+		Input[InputFill++] = Mono * ChannelScale;
+
+		if (InputFill == Config.FrameSize)
+		{
+			const int32 Row = OutFeatures.Num();
+			OutFeatures.SetNum(Row + NumFeatures);
+			AnalyseFrame(OutFeatures.GetData() + Row);
+			++Emitted;
+			++NumAnalysisFrames;
+
+			// Keep the overlap for the next frame
+			InputFill = Config.FrameSize - Config.HopSize;
+			FMemory::Memmove(Input.GetData(), Input.GetData() + Config.HopSize, sizeof(float) * InputFill);
+		}
+	}
+
+	return Emitted;
+}
+
+FString FAudioFeatureExtractor::GetFeatureName(int32 Feature)
+{
+	if (Feature >= (int32)EAudioFeature::Mfcc0)
+	{
+		return FString::Printf(TEXT("mfcc%d"), Feature - (int32)EAudioFeature::Mfcc0);
+	}
+	return FString(SpectralFeatureNames[Feature]);
+}
+
+void FAudioFeatureExtractor::AnalyseFrame(float* OutRow)
+{
+	const int32 N = Config.FrameSize;
+
+	float SumSquares = 0.0f;
+	const float* Window = Fft->Window.GetData();
+	float WindowSum = 0.0f;
+	for (int32 i = 0; i < N; ++i)
+	{
+		SumSquares += Input[i] * Input[i];
+		WindowSum += Window[i];
+		Real[i] = Input[i] * Window[i];
+		Imag[i] = 0.0f;
+	}
+
+	TransformInPlace();
+
+	// Magnitudes scaled so a full-scale sine peaks near 1
+	const float MagnitudeScale = 2.0f / WindowSum;
+	const float BinHz = SampleRate / N;
+	float SumPower = 0.0f;
+	float SumWeighted = 0.0f;
+	float SumLogPower = 0.0f;
+	float Flux = 0.0f;
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		const float Value = std::sqrt(Real[Bin] * Real[Bin] + Imag[Bin] * Imag[Bin]) * MagnitudeScale;
+		const float Power = Value * Value;
+		Magnitude[Bin] = Value;
+
+		SumPower += Power;
+		SumWeighted += Power * Bin * BinHz;
+		SumLogPower += std::log(Power + LogFloor);
+		Flux += FMath::Max(Value - PreviousMagnitude[Bin], 0.0f);
+		PreviousMagnitude[Bin] = Value;
+	}
+
+	const float Centroid = SumPower > 0.0f ? SumWeighted / SumPower : 0.0f;
+	float SumDeviation = 0.0f;
+	float Rolloff = 0.0f;
+	float Cumulative = 0.0f;
+	bool bRolloffFound = false;
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		const float Power = Magnitude[Bin] * Magnitude[Bin];
+		const float Deviation = Bin * BinHz - Centroid;
+		SumDeviation += Power * Deviation * Deviation;
+
+		Cumulative += Power;
+		if (!bRolloffFound && SumPower > 0.0f && Cumulative >= RolloffFraction * SumPower)
+		{
+			Rolloff = Bin * BinHz;
+			bRolloffFound = true;
+		}
+	}
+
+	const float MeanPower = SumPower / NumBins;
+	const float Flatness = MeanPower > LogFloor ? std::exp(SumLogPower / NumBins) / MeanPower : 0.0f;
+
+	// Onsets: flux jumping above its recent average, at most one frame per rise
+	const bool bOnset = Flux > Config.OnsetMinFlux && Flux > Config.OnsetThreshold * FluxAverage && !bPreviousOnset;
+	FluxAverage = 0.9f * FluxAverage + 0.1f * Flux;
+	bPreviousOnset = bOnset;
+
+	OutRow[(int32)EAudioFeature::RMS] = std::sqrt(SumSquares / N);
+	OutRow[(int32)EAudioFeature::Centroid] = Centroid;
+	OutRow[(int32)EAudioFeature::Spread] = SumPower > 0.0f ? std::sqrt(SumDeviation / SumPower) : 0.0f;
+	OutRow[(int32)EAudioFeature::Rolloff] = Rolloff;
+	OutRow[(int32)EAudioFeature::Flatness] = FMath::Clamp(Flatness, 0.0f, 1.0f);
+	OutRow[(int32)EAudioFeature::Flux] = Flux;
+	OutRow[(int32)EAudioFeature::Onset] = bOnset ? 1.0f : 0.0f;
+
+	for (int32 Band = 0; Band < MelBands.Num(); ++Band)
+	{
+		const FMelBand& MelBand = MelBands[Band];
+		float Energy = 0.0f;
+		for (int32 i = 0; i < MelBand.NumBins; ++i)
+		{
+			const float Value = Magnitude[MelBand.FirstBin + i];
+			Energy += MelWeights[MelBand.FirstWeight + i] * Value * Value;
+		}
+		MelEnergy[Band] = std::log(Energy + LogFloor);
+	}
+
+	const int32 M = MelBands.Num();
+	for (int32 k = 0; k < NumMfcc; ++k)
+	{
+		const float* Basis = Dct.GetData() + k * M;
+		float Coefficient = 0.0f;
+		for (int32 m = 0; m < M; ++m)
+		{
+			Coefficient += Basis[m] * MelEnergy[m];
+		}
+		OutRow[(int32)EAudioFeature::Mfcc0 + k] = Coefficient;
+	}
+}
+
+void FAudioFeatureExtractor::TransformInPlace()
+{
+	const int32 N = Config.FrameSize;
+	const int32* BitReverse = Fft->BitReverse.GetData();
+	const float* Cosines = Fft->Cosines.GetData();
+	const float* Sines = Fft->Sines.GetData();
+
+	for (int32 i = 0; i < N; ++i)
+	{
+		const int32 j = BitReverse[i];
+		if (i < j)
+		{
+			Swap(Real[i], Real[j]);
+			Swap(Imag[i], Imag[j]);
+		}
+	}
+
+	// Iterative radix-2 decimation in time
+	for (int32 Size = 2; Size <= N; Size *= 2)
+	{
+		const int32 Half = Size / 2;
+		const int32 Step = N / Size;
+		for (int32 Start = 0; Start < N; Start += Size)
+		{
+			for (int32 k = 0; k < Half; ++k)
+			{
+				const float C = Cosines[k * Step];
+				const float S = Sines[k * Step];
+				const int32 A = Start + k;
+				const int32 B = A + Half;
+				const float TempReal = Real[B] * C - Imag[B] * S;
+				const float TempImag = Real[B] * S + Imag[B] * C;
+				Real[B] = Real[A] - TempReal;
+				Imag[B] = Imag[A] - TempImag;
+				Real[A] += TempReal;
+				Imag[A] += TempImag;
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LookupTables.h"
+
+/**
+ * Per-frame features computed by FAudioFeatureExtractor, in row order
+ */
+enum class EAudioFeature : uint8
+{
+	RMS,
+	Centroid,      // Spectral centroid (Hz)
+	Spread,        // Standard deviation of the spectrum around the centroid (Hz)
+	Rolloff,       // Frequency below which 85% of the spectral energy lies (Hz)
+	Flatness,      // Geometric over arithmetic mean of the power spectrum, 0-1
+	Flux,          // Positive magnitude change since the previous frame
+	Onset,         // 1 on frames where an onset was detected, otherwise 0
+	Mfcc0,         // First of NumMfcc mel-frequency cepstral coefficients
+	Count = Mfcc0 + 13
+};
+
+/**
+ * Analysis settings
+ */
+struct FAudioFeatureConfig
+{
+	int32 FrameSize;        // FFT size, a power of two
+	int32 HopSize;          // Frames between analysis frames
+	int32 NumMelBands;
+	float MinFrequency;     // Mel filterbank range (Hz); MaxFrequency 0 = Nyquist
+	float MaxFrequency;
+	float OnsetThreshold;   // Flux over this multiple of its recent average is an onset
+	float OnsetMinFlux;     // Flux floor, so onsets are not found in near-silence
+
+	FAudioFeatureConfig()
+		: FrameSize(1024)
+		, HopSize(512)
+		, NumMelBands(40)
+		, MinFrequency(20.0f)
+		, MaxFrequency(0.0f)
+		, OnsetThreshold(2.0f)
+		, OnsetMinFlux(0.01f)
+	{
+	}
+};
+
+/**
+ * Streaming short-time feature extractor
+ *
+ * Audio is fed block by block as it is rendered and every completed analysis
+ * frame is emitted immediately, so features come out alongside the audio
+ * instead of from a second pass over a file. The window and FFT tables are
+ * shared by every analyzer of the same frame size; the mel filterbank and the
+ * DCT are built once at construction; Process does not
+ * allocate beyond growing the caller's output array.
+ */
+class FAudioFeatureExtractor
+{
+public:
+	static constexpr int32 NumMfcc = 13;
+	static constexpr int32 NumFeatures = (int32)EAudioFeature::Count;
+
+	FAudioFeatureExtractor(float InSampleRate, const FAudioFeatureConfig& InConfig = FAudioFeatureConfig());
+
+	/**
+	 * Analyse interleaved audio (channels are averaged)
+	 * @param OutFeatures Receives NumFeatures values per completed frame, appended in EAudioFeature order
+	 * @return Number of frames appended
+	 */
+	int32 Process(const float* Interleaved, int32 NumChannels, int32 NumFrames, TArray<float>& OutFeatures);
+
+	/** Forget buffered audio and onset history */
+	void Reset();
+
+	/** Frames emitted since the last reset */
+	int32 GetNumAnalysisFrames() const { return NumAnalysisFrames; }
+
+	/** Time of the first sample of an analysis frame (s) */
+	float GetFrameTime(int32 AnalysisFrame) const { return AnalysisFrame * Config.HopSize / SampleRate; }
+
+	const FAudioFeatureConfig& GetConfig() const { return Config; }
+
+	/** Column name of a feature, e.g. "centroid" or "mfcc3" */
+	static FString GetFeatureName(int32 Feature);
+
+private:
+	struct FMelBand
+	{
+		int32 FirstBin;
+		int32 NumBins;
+		int32 FirstWeight;   // Index into MelWeights
+	};
+
+	float SampleRate;
+	FAudioFeatureConfig Config;
+	int32 NumBins;   // FrameSize / 2 + 1
+
+	// Fixed tables
+	const FFftTables* Fft;   // Shared window, twiddles and bit reversal
+	TArray<FMelBand> MelBands;
+	TArray<float> MelWeights;
+	TArray<float> Dct;       // NumMfcc x NumMelBands
+
+	// Streaming state
+	TArray<float> Input;     // Last FrameSize mono samples, oldest first
+	int32 InputFill;         // Samples buffered; a frame is analysed each time it reaches FrameSize
+	TArray<float> PreviousMagnitude;
+	float FluxAverage;
+	bool bPreviousOnset;
+	int32 NumAnalysisFrames;
+
+	// Scratch
+	TArray<float> Real;
+	TArray<float> Imag;
+	TArray<float> Magnitude;
+	TArray<float> MelEnergy;
+
+	void AnalyseFrame(float* OutRow);
+	void TransformInPlace();
+};
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Audio/AudioSynthesizer.h"
 #include "Physics/PhysicsCore.h"
+#include "Integration/ImpactPredictor.h"
 
 /**
  * Maps physics impact events to audio synthesis parameters
@@ -40,14 +41,40 @@ public:
 	 */
 	void SetFrequencyRange(float MinHz, float MaxHz);
 
+	/**
+	 * Use a trained predictor for batched mapping instead of the linear mappings; null restores them
+	 * Predicted frequencies are still limited to the frequency range
+	 */
+	void SetPredictor(TSharedPtr<const FImpactPredictor> InPredictor) { Predictor = MoveTemp(InPredictor); }
+	const FImpactPredictor* GetPredictor() const { return Predictor.Get(); }
+
+	/**
+	 * Map a batch of impacts, e.g. everything dequeued in one block
+	 * With a loaded predictor the whole batch runs through one vectorized inference
+	 */
+	void MapImpactsToAudio(const FImpactEvent* Impacts, int32 Count, float* OutFrequency, float* OutAmplitude, float* OutDuration)
+	{
+		if (Predictor.IsValid() && Predictor->IsLoaded())
+		{
+			Predictor->PredictImpacts(Impacts, Count, MinFrequency, MaxFrequency, OutFrequency, OutAmplitude, OutDuration);
+			return;
+		}
+		for (int32 i = 0; i < Count; ++i)
+		{
+			MapImpactToAudio(Impacts[i], OutFrequency[i], OutAmplitude[i], OutDuration[i]);
+		}
+	}
+
 private:
 	float MinFrequency;   // Hz
 	float MaxFrequency;   // Hz
 	float FrequencyScale; // Multiplier for frequency generation
+	TSharedPtr<const FImpactPredictor> Predictor;
 };
 
 /**
  * Manages impact events from physics and routes to audio
+ * In the static-capacity profile at most FSandboxCapacity::MaxEvents impacts are queued
  */
 class FImpactEventQueue
 {
@@ -58,9 +85,12 @@ public:
 	bool DequeueImpact(FImpactEvent& OutImpact);
 	int32 GetQueueSize() const { return ImpactQueue.Num(); }
 	bool HasEvents() const { return ImpactQueue.Num() > 0; }
+	int64 GetAllocatedSize() const { return (int64)ImpactQueue.GetAllocatedSize(); }
+
+	void Serialize(FSandboxArchive& Ar) { Ar << ImpactQueue; }
 
 private:
-	TArray<FImpactEvent> ImpactQueue;
+	TSandboxArray<FImpactEvent, FSandboxCapacity::MaxEvents> ImpactQueue;
 	int32 MaxSize;
 };
 
@@ -86,6 +116,14 @@ public:
 
 	bool IsPlaying() const { return bIsPlaying; }
 
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		FBaseSynthesizer::Serialize(Ar);
+		Envelope.Serialize(Ar);
+		Oscillator.Serialize(Ar);
+		Ar << ImpactDuration << RemainingDuration << bIsPlaying << FrequencyDecay << InitialFrequency;
+	}
+
 private:
 	FEnvelopeGenerator Envelope;
 	FOscillator Oscillator;
@@ -124,6 +162,12 @@ public:
 	 */
 	void ExciteResonance(float Energy);
 
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		FBaseSynthesizer::Serialize(Ar);
+		Ar << Quality << ResonanceDamping << AccumulatedEnergy << FilterState1 << FilterState2;
+	}
+
 private:
 	float Quality;
 	float ResonanceDamping;
@@ -157,14 +201,30 @@ public:
 	void RegisterPhysicsObject(TSharedPtr<FPhysicsObject> Object);
 	void UnregisterPhysicsObject(TSharedPtr<FPhysicsObject> Object);
 
+	/** Room for NumObjects monitored bodies without reallocating */
+	void ReserveObjects(int32 NumObjects) { MonitoredObjects.Reserve(NumObjects); }
+
 	// Access components
 	FAudioMixer* GetMixer() { return &AudioMixer; }
 	FAudioPhysicsMapper* GetMapper() { return &PhysicsMapper; }
 	FImpactEventQueue* GetImpactQueue() { return &ImpactQueue; }
+	FResonanceSynthesizer* GetResonanceSynth() { return ResonanceSynth.Get(); }
 
 	void SetMasterVolume(float Volume) { MasterVolume = FMath::Clamp(Volume, 0.0f, 1.0f); }
 	float GetMasterVolume() const { return MasterVolume; }
 
+	/**
+	 * Save or restore voice and queue state
+	 * Monitored objects are owned by the physics world and restored there
+	 */
+	void Serialize(FSandboxArchive& Ar)
+	{
+		ImpactQueue.Serialize(Ar);
+		ImpactSynth->Serialize(Ar);
+		ResonanceSynth->Serialize(Ar);
+		Ar << MasterVolume;
+	}
+
 private:
 	FAudioMixer AudioMixer;
 	FAudioPhysicsMapper PhysicsMapper;
@@ -173,7 +233,7 @@ private:
 	TSharedPtr<FImpactSynthesizer> ImpactSynth;
 	TSharedPtr<FResonanceSynthesizer> ResonanceSynth;
 
-	TArray<TSharedPtr<FPhysicsObject>> MonitoredObjects;
+	FPhysicsObjectArray MonitoredObjects;
 	float MasterVolume;
 	float SampleRate;
 
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Containers/List.h"
+#include "SandboxArchive.h"
+#include "LookupTables.h"
 
 /**
  * Core audio synthesis interface for procedural audio generation
@@ -31,6 +33,15 @@ public:
 	float GetSampleRate() const { return SampleRate; }
 	float GetCurrentPhase() const { return CurrentPhase; }
 
+	/**
+	 * Save or restore voice state for sandbox snapshots
+	 * Derived voices append their own state after the base fields
+	 */
+	virtual void Serialize(FSandboxArchive& Ar)
+	{
+		Ar << SampleRate << CurrentPhase << CurrentFrequency << CurrentAmplitude;
+	}
+
 protected:
 	float SampleRate;
 	float CurrentPhase;
@@ -62,12 +73,21 @@ public:
 	void SetAmplitude(float InAmplitude);
 	void SetWaveform(EWaveform NewWaveform);
 
+	// Wavetables are derived data and are not part of the snapshot
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		FBaseSynthesizer::Serialize(Ar);
+		Ar << CurrentWaveform;
+	}
+
 private:
 	EWaveform CurrentWaveform;
-	TArray<float> SineTable;
+	const float* SineTable;   // Shared compile-time table, SineTableSize + 1 entries
 
 	float GenerateSample();
-	void BuildWavetables();
+
+	/** Binds the shared tables; nothing is generated per oscillator */
+	void BuildWavetables() { SineTable = GetSineTable(); }
 };
 
 /**
@@ -93,6 +113,11 @@ public:
 	void NoteOff();
 	bool IsActive() const { return bIsActive; }
 
+	void Serialize(FSandboxArchive& Ar)
+	{
+		Ar << Params << CurrentStage << EnvelopeValue << SampleCount << bIsActive;
+	}
+
 private:
 	enum class EEnvelopeStage : uint8
 	{
@@ -123,6 +148,8 @@ public:
 	void RemoveSource(TSharedPtr<FBaseSynthesizer> Source);
 	void MixAudio(TArray<float>& OutBuffer, int32 NumSamples);
 
+	int32 GetNumSources() const { return SourceCount; }
+
 private:
 	TList<TSharedPtr<FBaseSynthesizer>> SynthSources;
 	int32 SourceCount;
@@ -0,0 +1,687 @@
+/**
+ * Audio Sandbox - Benchmarks
+ * Timing harness for engine subsystems; run a Release build
+ */
+
+#include "SandboxManager.h"
+#include "Procedural/SimplexNoise.h"
+#include "Procedural/ExpressionGenerator.h"
+#include "Offline/StressScene.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define BENCHMARK_CAN_SPAWN 1
+extern char** environ;
+#else
+#define BENCHMARK_CAN_SPAWN 0
+#endif
+
+// ============================================================================
+// Utility Functions
+// ============================================================================
+
+/**
+ * Wall-clock timer in nanoseconds
+ */
+class FBenchmarkTimer
+{
+public:
+	FBenchmarkTimer() : Start(std::chrono::high_resolution_clock::now()) {}
+
+	double GetElapsedNanoseconds() const
+	{
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::high_resolution_clock::now() - Start).count();
+	}
+
+private:
+	std::chrono::high_resolution_clock::time_point Start;
+};
+
+/**
+ * Monotonic clock reading comparable between processes on the same machine
+ */
+int64 GetSteadyNanoseconds()
+{
+	return (int64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Heap bytes in use, or 0 where the allocator cannot report it
+ */
+int64 GetHeapBytesInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	const struct mallinfo2 Info = mallinfo2();
+	return (int64)(Info.uordblks + Info.hblkhd);
+#else
+	return 0;
+#endif
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+/**
+ * Script that wakes every Period frames for as long as the runner exists
+ */
+FSceneScript TickScript(FSceneScriptRunner& Runner, int32 Period)
+{
+	while (Runner.GetCurrentFrame() >= 0)
+	{
+		co_await Frames(Period);
+	}
+}
+
+/**
+ * Benchmark 1: Scene script resume overhead
+ * Thousands of active scripts with staggered periods, resumed at 64-frame blocks
+ */
+void Benchmark_ScriptResume()
+{
+	std::cout << "=== Benchmark 1: Scene Script Resume ===" << std::endl;
+
+	const int32 ScriptCounts[] = { 1000, 4000, 16000 };
+	const int32 BlockSize = 64;
+	const int64 TotalFrames = 48000 * 10;
+
+	for (int32 NumScripts : ScriptCounts)
+	{
+		FSceneScriptRunner Runner(48000.0f, NumScripts * 256, NumScripts);
+		for (int32 i = 0; i < NumScripts; ++i)
+		{
+			Runner.Start(TickScript(Runner, 64 + (i % 16) * 32));
+		}
+
+		FBenchmarkTimer Timer;
+		for (int64 Frame = 0; Frame < TotalFrames; Frame += BlockSize)
+		{
+			Runner.Resume(Frame);
+		}
+		const double Elapsed = Timer.GetElapsedNanoseconds();
+
+		const FScriptFrameArena& Arena = Runner.GetArena();
+		std::cout << NumScripts << " scripts: "
+			<< Runner.GetResumeCount() << " resumes, "
+			<< Elapsed / FMath::Max<double>((double)Runner.GetResumeCount(), 1.0) << " ns/resume, "
+			<< "arena " << Arena.GetUsedBytes() << " bytes, "
+			<< (NumScripts - Arena.GetLiveFrames()) << " heap frames" << std::endl;
+	}
+}
+
+/**
+ * Benchmark 2: Simplex noise, batched against per-point evaluation
+ * Fractal 4D noise at body-like positions, as used for spatially varying parameters
+ */
+void Benchmark_SimplexNoise()
+{
+	std::cout << "=== Benchmark 2: Simplex Noise ===" << std::endl;
+
+	const int32 NumPositions = 4096;
+	const int32 Iterations = 200;
+
+	FSimplexNoise Noise(1234);
+	TArray<float> X, Y, Z, W, Out;
+	X.SetNum(NumPositions);
+	Y.SetNum(NumPositions);
+	Z.SetNum(NumPositions);
+	W.SetNum(NumPositions);
+	Out.SetNum(NumPositions);
+	for (int32 i = 0; i < NumPositions; ++i)
+	{
+		X[i] = (i % 64) * 0.173f;
+		Y[i] = (i / 64) * 0.119f;
+		Z[i] = i * 0.0031f;
+		W[i] = 0.5f;
+	}
+
+	float Checksum = 0.0f;
+	{
+		FBenchmarkTimer Timer;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (int32 i = 0; i < NumPositions; ++i)
+			{
+				Out[i] = Noise.Noise4D(X[i], Y[i], Z[i], W[i]);
+			}
+			Checksum += Out[Iteration % NumPositions];
+		}
+		std::cout << "4D scalar:  " << Timer.GetElapsedNanoseconds() / ((double)NumPositions * Iterations) << " ns/point" << std::endl;
+	}
+	{
+		FBenchmarkTimer Timer;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Noise.Evaluate4D(X.GetData(), Y.GetData(), Z.GetData(), W.GetData(), Out.GetData(), NumPositions);
+			Checksum += Out[Iteration % NumPositions];
+		}
+		std::cout << "4D batched: " << Timer.GetElapsedNanoseconds() / ((double)NumPositions * Iterations) << " ns/point" << std::endl;
+	}
+	{
+		TArray<FVector3> Positions;
+		Positions.SetNum(NumPositions);
+		for (int32 i = 0; i < NumPositions; ++i)
+		{
+			Positions[i] = FVector3(X[i], Y[i], Z[i]);
+		}
+
+		const FSimplexFractalParams Params(0.5f, 4);
+		FBenchmarkTimer Timer;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Noise.EvaluateFractal(Positions, Iteration * 0.01f, Params, Out);
+			Checksum += Out[Iteration % NumPositions];
+		}
+		std::cout << "4D fractal (4 octaves): " << Timer.GetElapsedNanoseconds() / ((double)NumPositions * Iterations) << " ns/point"
+			<< " (checksum " << Checksum << ")" << std::endl;
+	}
+}
+
+/**
+ * Benchmark 3: Expression VM against the same generator written in C++
+ */
+void Benchmark_ExpressionVM()
+{
+	std::cout << "=== Benchmark 3: Expression VM ===" << std::endl;
+
+	const int32 NumValues = 48000;
+	const int32 Iterations = 100;
+	const float TimeStep = 1.0f / 48000.0f;
+
+	TArray<float> Values;
+	Values.SetNum(NumValues);
+	float Checksum = 0.0f;
+
+	FExpressionGenerator Generator;
+	Generator.SetTimeStep(TimeStep);
+	FString Error;
+	if (!Generator.Compile(TEXT("lfo = sin(t * tau * rate); n = noise(t * 3, 0.5); clamp(0.5 + 0.3 * lfo + 0.2 * n, 0, 1)"), &Error))
+	{
+		std::cout << "Compile error: " << *Error << std::endl;
+		return;
+	}
+	Generator.SetInput(TEXT("rate"), 2.0f);
+
+	double VMTime;
+	{
+		FBenchmarkTimer Timer;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Generator.Evaluate(Values.GetData(), NumValues);
+			Checksum += Values[Iteration];
+		}
+		VMTime = Timer.GetElapsedNanoseconds() / ((double)NumValues * Iterations);
+	}
+
+	double NativeTime;
+	{
+		FSimplexNoise Noise(12345);
+		const float Rate = 2.0f;
+		double Time = 0.0;
+		FBenchmarkTimer Timer;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (int32 i = 0; i < NumValues; ++i)
+			{
+				const float T = (float)(Time + (double)i * TimeStep);
+				const float Lfo = std::sin(T * 6.28318531f * Rate);
+				const float N = Noise.Noise2D(T * 3.0f, 0.5f);
+				Values[i] = FMath::Clamp(0.5f + 0.3f * Lfo + 0.2f * N, 0.0f, 1.0f);
+			}
+			Time += (double)NumValues * TimeStep;
+			Checksum += Values[Iteration];
+		}
+		NativeTime = Timer.GetElapsedNanoseconds() / ((double)NumValues * Iterations);
+	}
+
+	std::cout << Generator.GetProgram().Code.Num() << " instructions, "
+		<< Generator.GetProgram().NumRegisters << " registers" << std::endl;
+	std::cout << "VM:     " << VMTime << " ns/value" << std::endl;
+	std::cout << "Native: " << NativeTime << " ns/value (checksum " << Checksum << ")" << std::endl;
+}
+
+/**
+ * Benchmark 4: Fixed cost per Update against block size
+ * Fits time per call = Overhead + Cost * BlockSize over the measured sizes
+ */
+void Benchmark_BlockOverhead()
+{
+	std::cout << "=== Benchmark 4: Per-Call Overhead vs Block Size ===" << std::endl;
+
+	const int32 BlockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+	const int32 NumSizes = 7;
+	const int64 TotalFrames = 48000 * 4;
+
+	for (int32 Mode = 0; Mode < 2; ++Mode)
+	{
+		const bool bLowLatency = Mode == 1;
+		std::cout << (bLowLatency ? "Low-latency mode (control period 256):" : "Default mode:") << std::endl;
+
+		double CallTimes[NumSizes];
+		for (int32 SizeIndex = 0; SizeIndex < NumSizes; ++SizeIndex)
+		{
+			const int32 BlockSize = BlockSizes[SizeIndex];
+			FSandboxManager Sandbox(48000.0f, BlockSize);
+			Sandbox.EnableLowLatencyMode(bLowLatency);
+			for (int32 i = 0; i < 8; ++i)
+			{
+				auto Sphere = MakeShared<FPhysicsSphere>(0.1f, 1.0f);
+				Sphere->SetPosition(FVector3(i * 0.5f, 1.0f + i * 0.1f, 0));
+				Sandbox.AddPhysicsObject(Sphere);
+			}
+
+			TArray<float> AudioBuffer;
+			const float DeltaTime = BlockSize / 48000.0f;
+			Sandbox.Update(DeltaTime, AudioBuffer);
+
+			const int64 NumCalls = TotalFrames / BlockSize;
+			FBenchmarkTimer Timer;
+			for (int64 Call = 0; Call < NumCalls; ++Call)
+			{
+				Sandbox.Update(DeltaTime, AudioBuffer);
+			}
+			CallTimes[SizeIndex] = Timer.GetElapsedNanoseconds() / (double)NumCalls;
+
+			std::cout << "  " << BlockSize << " frames: " << CallTimes[SizeIndex] << " ns/call, "
+				<< CallTimes[SizeIndex] / BlockSize << " ns/frame" << std::endl;
+		}
+
+		// Least-squares line through (BlockSize, time per call)
+		double SumX = 0.0, SumY = 0.0, SumXX = 0.0, SumXY = 0.0;
+		for (int32 SizeIndex = 0; SizeIndex < NumSizes; ++SizeIndex)
+		{
+			const double X = BlockSizes[SizeIndex];
+			SumX += X;
+			SumY += CallTimes[SizeIndex];
+			SumXX += X * X;
+			SumXY += X * CallTimes[SizeIndex];
+		}
+		const double Cost = (NumSizes * SumXY - SumX * SumY) / (NumSizes * SumXX - SumX * SumX);
+		const double Overhead = (SumY - Cost * SumX) / NumSizes;
+		std::cout << "  Fixed overhead " << Overhead << " ns/call, marginal cost " << Cost << " ns/frame" << std::endl;
+	}
+}
+
+/**
+ * Benchmark 5: Batched impact parameter inference
+ * Events per second through the MLP predictor for a range of batch sizes
+ */
+void Benchmark_ImpactPredictor()
+{
+	std::cout << "=== Benchmark 5: Impact Predictor Inference ===" << std::endl;
+
+	const int32 BatchSizes[] = { 1, 16, 64, 256, 1024 };
+	const int32 TotalEvents = 1 << 20;
+
+	TArray<FImpactEvent> Impacts;
+	Impacts.SetNum(1024);
+	uint32 State = 1;
+	for (FImpactEvent& Impact : Impacts)
+	{
+		State = State * 1664525u + 1013904223u;
+		Impact.ImpactForce = (State >> 8) / 16777216.0f;
+		Impact.ImpactFrequency = 100.0f + Impact.ImpactForce * 3000.0f;
+		Impact.ImpactNormal = FVector3(0, 1, 0);
+		Impact.Position = FVector3(0, Impact.ImpactForce * 2.0f, 0);
+	}
+
+	TArray<float> Frequency, Amplitude, Duration;
+	Frequency.SetNum(1024);
+	Amplitude.SetNum(1024);
+	Duration.SetNum(1024);
+
+	// A compact model and a larger one
+	const int32 SmallModel[] = { FImpactPredictor::NumInputs, 16, FImpactPredictor::NumOutputs };
+	const int32 LargeModel[] = { FImpactPredictor::NumInputs, 32, 32, FImpactPredictor::NumOutputs };
+	const int32* Models[] = { SmallModel, LargeModel };
+	const int32 ModelSizes[] = { 3, 4 };
+
+	for (int32 Model = 0; Model < 2; ++Model)
+	{
+		FImpactPredictor Predictor;
+		if (!Predictor.InitializeRandom(Models[Model], ModelSizes[Model], 12345))
+		{
+			std::cout << "Model shape rejected" << std::endl;
+			continue;
+		}
+		std::cout << (Model == 0 ? "Model 8-16-3, " : "Model 8-32-32-3, ") << Predictor.GetNumMultiplyAdds() << " multiply-adds per event" << std::endl;
+
+		for (int32 BatchSize : BatchSizes)
+		{
+			const int32 NumBatches = TotalEvents / BatchSize;
+			float Checksum = 0.0f;
+
+			FBenchmarkTimer Timer;
+			for (int32 Batch = 0; Batch < NumBatches; ++Batch)
+			{
+				Predictor.PredictImpacts(Impacts.GetData(), BatchSize, 20.0f, 20000.0f,
+					Frequency.GetData(), Amplitude.GetData(), Duration.GetData());
+				Checksum += Amplitude[0];
+			}
+			const double Seconds = Timer.GetElapsedNanoseconds() * 1e-9;
+
+			const double EventsPerSecond = TotalEvents / Seconds;
+			std::cout << "  Batch " << BatchSize << ": " << EventsPerSecond / 1e6 << " M events/s, "
+				<< 256.0 / EventsPerSecond * 1e6 << " us per 256 events"
+				<< " (checksum " << Checksum << ")" << std::endl;
+		}
+	}
+}
+
+/**
+ * Cost of rendering one stress scene
+ */
+struct FStressMeasurement
+{
+	double Load;       // Mean render time over block duration; real time fails at 1
+	double PeakLoad;   // Slowest block over block duration
+	double HeapMB;     // Heap growth from building the scene and warming it up
+};
+
+FStressMeasurement MeasureStressScene(const FStressSceneConfig& Config)
+{
+	const float SampleRate = 48000.0f;
+	const int32 BlockSize = 512;
+	const int32 NumBlocks = 94;                  // About one second
+	const double MaxSeconds = 5.0;               // Cut short scenes far past the knee
+	const double BlockNanoseconds = BlockSize / SampleRate * 1e9;
+
+	FStressMeasurement Measurement;
+	const int64 HeapBefore = GetHeapBytesInUse();
+	{
+		FSandboxManager Sandbox(SampleRate, BlockSize);
+		FStressSceneGenerator::Build(Sandbox, Config);
+
+		TArray<float> AudioBuffer;
+		const float DeltaTime = BlockSize / SampleRate;
+		for (int32 Block = 0; Block < 8; ++Block)
+		{
+			Sandbox.Update(DeltaTime, AudioBuffer);
+		}
+		Measurement.HeapMB = (GetHeapBytesInUse() - HeapBefore) / (1024.0 * 1024.0);
+
+		double Total = 0.0;
+		double Peak = 0.0;
+		int32 Rendered = 0;
+		while (Rendered < NumBlocks && Total < MaxSeconds * 1e9)
+		{
+			FBenchmarkTimer Timer;
+			Sandbox.Update(DeltaTime, AudioBuffer);
+			const double Elapsed = Timer.GetElapsedNanoseconds();
+			Total += Elapsed;
+			Peak = FMath::Max(Peak, Elapsed);
+			++Rendered;
+		}
+		Measurement.Load = Total / Rendered / BlockNanoseconds;
+		Measurement.PeakLoad = Peak / BlockNanoseconds;
+	}
+	return Measurement;
+}
+
+/**
+ * Benchmark 6: Scene scalability
+ * Doubles one dimension of a seeded random scene at a time, holding the others
+ * at the base size, until real time fails; then bisects for the knee
+ */
+void Benchmark_SceneScalability()
+{
+	std::cout << "=== Benchmark 6: Scene Scalability ===" << std::endl;
+
+	struct FStressDimension
+	{
+		const char* Name;
+		int32 FStressSceneConfig::* Size;
+		int32 First;
+		int32 Last;
+	};
+	const FStressDimension Dimensions[] =
+	{
+		{ "Bodies", &FStressSceneConfig::NumBodies, 8, 16384 },
+		{ "Materials", &FStressSceneConfig::NumMaterials, 1, 256 },
+		{ "Routings", &FStressSceneConfig::NumRoutings, 1, FProceduralController::MaxBindings },
+		{ "Voices", &FStressSceneConfig::NumVoices, 8, 16384 },
+	};
+
+	FStressSceneConfig Base;
+	Base.Seed = 20240601;
+	std::cout << "Seed " << Base.Seed << ", base " << Base.NumBodies << " bodies, " << Base.NumMaterials << " materials, "
+		<< Base.NumRoutings << " routings, " << Base.NumVoices << " voices; 48 kHz, 512-frame blocks" << std::endl;
+
+	for (const FStressDimension& Dimension : Dimensions)
+	{
+		std::cout << Dimension.Name << ":" << std::endl;
+
+		FStressSceneConfig Config = Base;
+		int32 Passed = 0;
+		int32 Failed = 0;
+		double PreviousLoad = 0.0;
+		double Exponent = 0.0;
+		for (int32 Size = Dimension.First; Size <= Dimension.Last; Size *= 2)
+		{
+			Config.*Dimension.Size = Size;
+			const FStressMeasurement Measurement = MeasureStressScene(Config);
+			std::cout << "  " << Size << ": load " << Measurement.Load << " (peak " << Measurement.PeakLoad
+				<< "), heap " << Measurement.HeapMB << " MB" << std::endl;
+
+			// Growth of load per doubling, as the exponent of a power law
+			if (PreviousLoad > 0.0)
+			{
+				Exponent = std::log2(Measurement.Load / PreviousLoad);
+			}
+			PreviousLoad = Measurement.Load;
+
+			if (Measurement.Load >= 1.0)
+			{
+				Failed = Size;
+				break;
+			}
+			Passed = Size;
+		}
+
+		if (Failed == 0)
+		{
+			std::cout << "  Real time held up to " << Passed << ", load ~ N^" << Exponent << std::endl;
+			continue;
+		}
+
+		// Bisect between the last size that kept up and the first that did not
+		while (Failed - Passed > FMath::Max(Passed / 32, 1))
+		{
+			const int32 Size = Passed + (Failed - Passed) / 2;
+			Config.*Dimension.Size = Size;
+			if (MeasureStressScene(Config).Load >= 1.0)
+			{
+				Failed = Size;
+			}
+			else
+			{
+				Passed = Size;
+			}
+		}
+		std::cout << "  Knee: real time fails between " << Passed << " and " << Failed
+			<< ", load ~ N^" << Exponent << std::endl;
+	}
+}
+
+/**
+ * Child half of the cold-start benchmark: builds the default stress scene,
+ * renders one block, then repeats in the same process for the warm figure
+ * Prints steady-clock timestamps: main entry, scene built, first block,
+ * warm pass start, warm first block
+ */
+int RunColdStartChild()
+{
+	const int64 MainTime = GetSteadyNanoseconds();
+	int64 SceneTime = 0, BlockTime = 0, WarmStartTime = 0, WarmBlockTime = 0;
+
+	const float SampleRate = 48000.0f;
+	const int32 BlockSize = 512;
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		if (Pass == 1)
+		{
+			WarmStartTime = GetSteadyNanoseconds();
+		}
+		FSandboxManager Sandbox(SampleRate, BlockSize);
+		FStressSceneGenerator::Build(Sandbox, FStressSceneConfig());
+		if (Pass == 0)
+		{
+			SceneTime = GetSteadyNanoseconds();
+		}
+
+		TArray<float> AudioBuffer;
+		Sandbox.Update(BlockSize / SampleRate, AudioBuffer);
+		(Pass == 0 ? BlockTime : WarmBlockTime) = GetSteadyNanoseconds();
+	}
+
+	std::printf("%lld %lld %lld %lld %lld\n", (long long)MainTime, (long long)SceneTime, (long long)BlockTime,
+		(long long)WarmStartTime, (long long)WarmBlockTime);
+	return 0;
+}
+
+/**
+ * Benchmark 7: Cold start
+ * Time from spawning a fresh process to its first rendered block for the
+ * default stress scene, split into process start-up (loading and static
+ * initialization), scene construction and the first block; the same scene
+ * built again in the warm process shows what one-time initialization costs
+ */
+void Benchmark_ColdStart(const char* Executable)
+{
+	std::cout << "=== Benchmark 7: Cold Start ===" << std::endl;
+
+#if BENCHMARK_CAN_SPAWN
+	const int32 NumRuns = 9;
+	double Startup[NumRuns], Scene[NumRuns], FirstBlock[NumRuns], Total[NumRuns], Warm[NumRuns];
+	int32 Completed = 0;
+
+	for (int32 Run = 0; Run < NumRuns; ++Run)
+	{
+		int Pipe[2];
+		if (pipe(Pipe) != 0)
+		{
+			break;
+		}
+		posix_spawn_file_actions_t Actions;
+		posix_spawn_file_actions_init(&Actions);
+		posix_spawn_file_actions_adddup2(&Actions, Pipe[1], STDOUT_FILENO);
+		posix_spawn_file_actions_addclose(&Actions, Pipe[0]);
+
+		char Flag[] = "--cold-start";
+		char* Args[] = { const_cast<char*>(Executable), Flag, nullptr };
+		pid_t Child = 0;
+		const int64 SpawnTime = GetSteadyNanoseconds();
+		const int SpawnError = posix_spawn(&Child, Executable, &Actions, nullptr, Args, environ);
+		posix_spawn_file_actions_destroy(&Actions);
+		close(Pipe[1]);
+
+		char Output[256] = {};
+		int32 Length = 0;
+		ssize_t Bytes = 0;
+		while (SpawnError == 0 && Length < (int32)sizeof(Output) - 1
+			&& (Bytes = read(Pipe[0], Output + Length, sizeof(Output) - 1 - Length)) > 0)
+		{
+			Length += (int32)Bytes;
+		}
+		close(Pipe[0]);
+		if (SpawnError != 0)
+		{
+			std::cout << "Could not spawn " << Executable << std::endl;
+			return;
+		}
+		int Status = 0;
+		waitpid(Child, &Status, 0);
+
+		long long MainTime = 0, SceneTime = 0, BlockTime = 0, WarmStartTime = 0, WarmBlockTime = 0;
+		if (std::sscanf(Output, "%lld %lld %lld %lld %lld", &MainTime, &SceneTime, &BlockTime, &WarmStartTime, &WarmBlockTime) != 5)
+		{
+			continue;
+		}
+		Startup[Completed] = (MainTime - SpawnTime) * 1e-6;
+		Scene[Completed] = (SceneTime - MainTime) * 1e-6;
+		FirstBlock[Completed] = (BlockTime - SceneTime) * 1e-6;
+		Total[Completed] = (BlockTime - SpawnTime) * 1e-6;
+		Warm[Completed] = (WarmBlockTime - WarmStartTime) * 1e-6;
+		++Completed;
+	}
+
+	if (Completed == 0)
+	{
+		std::cout << "No child run reported timings" << std::endl;
+		return;
+	}
+
+	// Medians; the first spawn also pays for a cold page cache
+	auto Median = [Completed](double* Values)
+	{
+		std::sort(Values, Values + Completed);
+		return Values[Completed / 2];
+	};
+	std::cout << "Median of " << Completed << " fresh processes (ms):" << std::endl;
+	std::cout << "  Process start to main:  " << Median(Startup) << std::endl;
+	std::cout << "  Scene construction:     " << Median(Scene) << std::endl;
+	std::cout << "  First block:            " << Median(FirstBlock) << std::endl;
+	std::cout << "  Start to first block:   " << Median(Total) << std::endl;
+	std::cout << "  Both again, warm:       " << Median(Warm) << std::endl;
+#else
+	(void)Executable;
+	std::cout << "Not supported on this platform" << std::endl;
+#endif
+}
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && std::strcmp(argv[1], "--cold-start") == 0)
+	{
+		return RunColdStartChild();
+	}
+
+	std::cout << "Audio Sandbox - Benchmarks" << std::endl;
+	std::cout << "==========================" << std::endl;
+	std::cout << std::endl;
+
+	Benchmark_ScriptResume();
+	std::cout << std::endl;
+
+	Benchmark_SimplexNoise();
+	std::cout << std::endl;
+
+	Benchmark_ExpressionVM();
+	std::cout << std::endl;
+
+	Benchmark_BlockOverhead();
+	std::cout << std::endl;
+
+	Benchmark_ImpactPredictor();
+	std::cout << std::endl;
+
+	Benchmark_SceneScalability();
+	std::cout << std::endl;
+
+#if defined(__linux__)
+	Benchmark_ColdStart("/proc/self/exe");
+#else
+	Benchmark_ColdStart(argv[0]);
+#endif
+	std::cout << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,220 @@
+#include "ChannelLayout.h"
+#include <cmath>
+
+namespace
+{
+	constexpr float Pi = 3.14159265f;
+	constexpr float DegreesToRadians = Pi / 180.0f;
+
+	/**
+	 * A speaker on a horizontal ring; rings are sorted by azimuth in [0, 360) degrees
+	 */
+	struct FRingSpeaker
+	{
+		int32 Channel;
+		float Azimuth;
+	};
+
+	const FRingSpeaker Ring51[] = { { 2, 0.0f }, { 0, 30.0f }, { 4, 110.0f }, { 5, 250.0f }, { 1, 330.0f } };
+	const FRingSpeaker Ring714[] = { { 2, 0.0f }, { 0, 30.0f }, { 6, 90.0f }, { 4, 135.0f }, { 5, 225.0f }, { 7, 270.0f }, { 1, 330.0f } };
+	const FRingSpeaker Ring714Top[] = { { 8, 45.0f }, { 10, 135.0f }, { 11, 225.0f }, { 9, 315.0f } };
+
+	// Elevation at which 7.1.4 sources are entirely in the top layer
+	constexpr float TopLayerElevation = 45.0f * DegreesToRadians;
+
+	/** Constant-power panning between the two ring speakers either side of Azimuth */
+	void PanRing(const FRingSpeaker* Ring, int32 Count, float Azimuth, float Weight, float* Gains)
+	{
+		float Degrees = std::fmod(Azimuth / DegreesToRadians, 360.0f);
+		if (Degrees < 0.0f)
+		{
+			Degrees += 360.0f;
+		}
+
+		// Speaker at or before the source; the last one wraps around to the first
+		int32 First = Count - 1;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (Ring[i].Azimuth <= Degrees)
+			{
+				First = i;
+			}
+		}
+		const int32 Second = (First + 1) % Count;
+
+		float Start = Ring[First].Azimuth;
+		float End = Ring[Second].Azimuth;
+		if (End <= Start)
+		{
+			End += 360.0f;
+		}
+		if (Degrees < Start)
+		{
+			Degrees += 360.0f;
+		}
+
+		const float Fraction = FMath::Clamp((Degrees - Start) / (End - Start), 0.0f, 1.0f);
+		Gains[Ring[First].Channel] += Weight * std::cos(Fraction * Pi * 0.5f);
+		Gains[Ring[Second].Channel] += Weight * std::sin(Fraction * Pi * 0.5f);
+	}
+
+	/** Real spherical harmonics, ACN order, SN3D normalization, up to Order */
+	void EncodeAmbisonics(float Azimuth, float Elevation, int32 Order, float* Gains)
+	{
+		const float X = std::cos(Elevation) * std::cos(Azimuth);
+		const float Y = std::cos(Elevation) * std::sin(Azimuth);
+		const float Z = std::sin(Elevation);
+
+		Gains[0] = 1.0f;
+		Gains[1] = Y;
+		Gains[2] = Z;
+		Gains[3] = X;
+		if (Order < 2)
+		{
+			return;
+		}
+
+		const float Sqrt3 = 1.7320508f;
+		Gains[4] = Sqrt3 * X * Y;
+		Gains[5] = Sqrt3 * Y * Z;
+		Gains[6] = 0.5f * (3.0f * Z * Z - 1.0f);
+		Gains[7] = Sqrt3 * X * Z;
+		Gains[8] = 0.5f * Sqrt3 * (X * X - Y * Y);
+		if (Order < 3)
+		{
+			return;
+		}
+
+		const float Sqrt5Over8 = 0.7905694f;
+		const float Sqrt15 = 3.8729833f;
+		const float Sqrt3Over8 = 0.6123724f;
+		Gains[9] = Sqrt5Over8 * Y * (3.0f * X * X - Y * Y);
+		Gains[10] = Sqrt15 * X * Y * Z;
+		Gains[11] = Sqrt3Over8 * Y * (5.0f * Z * Z - 1.0f);
+		Gains[12] = 0.5f * Z * (5.0f * Z * Z - 3.0f);
+		Gains[13] = Sqrt3Over8 * X * (5.0f * Z * Z - 1.0f);
+		Gains[14] = 0.5f * Sqrt15 * Z * (X * X - Y * Y);
+		Gains[15] = Sqrt5Over8 * X * (X * X - 3.0f * Y * Y);
+	}
+
+	/**
+	 * Accumulate In * Gains[c] into every channel of interleaved Out
+	 * The channel count is a template parameter so the inner loop is fully unrolled
+	 */
+	template<int32 NumChannels>
+	void PanKernel(const float* In, int32 InStride, int32 NumFrames, const float* Gains, float* Out)
+	{
+		float FrameGains[NumChannels];
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			FrameGains[Channel] = Gains[Channel];
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float Sample = In[Frame * InStride];
+			float* OutFrame = Out + Frame * NumChannels;
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				OutFrame[Channel] += Sample * FrameGains[Channel];
+			}
+		}
+	}
+}
+
+// ============================================================================
+// FChannelPanner Implementation
+// ============================================================================
+
+FChannelPanner::FChannelPanner(EChannelLayout InLayout)
+{
+	SetLayout(InLayout);
+}
+
+void FChannelPanner::SetLayout(EChannelLayout InLayout)
+{
+	Layout = InLayout;
+	NumChannels = GetChannelCount(InLayout);
+
+	switch (InLayout)
+	{
+	case EChannelLayout::Mono:        Kernel = &PanKernel<1>; break;
+	case EChannelLayout::Stereo:      Kernel = &PanKernel<2>; break;
+	case EChannelLayout::Surround51:  Kernel = &PanKernel<6>; break;
+	case EChannelLayout::Surround714: Kernel = &PanKernel<12>; break;
+	case EChannelLayout::Ambisonics1: Kernel = &PanKernel<4>; break;
+	case EChannelLayout::Ambisonics2: Kernel = &PanKernel<9>; break;
+	default:                          Kernel = &PanKernel<16>; break;
+	}
+
+	if (InLayout == EChannelLayout::Mono)
+	{
+		StereoGains[0][0] = 0.5f;
+		StereoGains[1][0] = 0.5f;
+	}
+	else
+	{
+		ComputeGains(30.0f * DegreesToRadians, 0.0f, StereoGains[0]);
+		ComputeGains(-30.0f * DegreesToRadians, 0.0f, StereoGains[1]);
+	}
+}
+
+void FChannelPanner::ComputeGains(float Azimuth, float Elevation, float* OutGains) const
+{
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		OutGains[Channel] = 0.0f;
+	}
+
+	switch (Layout)
+	{
+	case EChannelLayout::Mono:
+		OutGains[0] = 1.0f;
+		break;
+
+	case EChannelLayout::Stereo:
+	{
+		// Sources behind the listener fold onto their frontal mirror image
+		const float Angle = (1.0f - std::sin(Azimuth)) * Pi * 0.25f;
+		OutGains[0] = std::cos(Angle);
+		OutGains[1] = std::sin(Angle);
+		break;
+	}
+
+	case EChannelLayout::Surround51:
+		PanRing(Ring51, 5, Azimuth, 1.0f, OutGains);
+		break;
+
+	case EChannelLayout::Surround714:
+	{
+		// Split between the ear-level and top rings by elevation, keeping total power
+		const float Blend = FMath::Clamp(Elevation / TopLayerElevation, 0.0f, 1.0f) * Pi * 0.5f;
+		PanRing(Ring714, 7, Azimuth, std::cos(Blend), OutGains);
+		PanRing(Ring714Top, 4, Azimuth, std::sin(Blend), OutGains);
+		break;
+	}
+
+	case EChannelLayout::Ambisonics1: EncodeAmbisonics(Azimuth, Elevation, 1, OutGains); break;
+	case EChannelLayout::Ambisonics2: EncodeAmbisonics(Azimuth, Elevation, 2, OutGains); break;
+	case EChannelLayout::Ambisonics3: EncodeAmbisonics(Azimuth, Elevation, 3, OutGains); break;
+	}
+}
+
+void FChannelPanner::DirectionToAngles(float X, float Y, float Z, float& OutAzimuth, float& OutElevation)
+{
+	OutAzimuth = std::atan2(X, Z);
+	OutElevation = std::atan2(Y, std::sqrt(X * X + Z * Z));
+}
+
+void FChannelPanner::UpmixStereo(const float* InStereo, int32 NumFrames, float* Out) const
+{
+	if (Layout == EChannelLayout::Stereo)
+	{
+		FMemory::Memcpy(Out, InStereo, sizeof(float) * NumFrames * 2);
+		return;
+	}
+
+	FMemory::Memzero(Out, sizeof(float) * NumFrames * NumChannels);
+	Kernel(InStereo, 2, NumFrames, StereoGains[0], Out);
+	Kernel(InStereo + 1, 2, NumFrames, StereoGains[1], Out);
+}
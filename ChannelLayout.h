@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Output channel layouts
+ * Speaker layouts use WAVE channel order; ambisonics use ACN order with SN3D normalization (AmbiX)
+ */
+enum class EChannelLayout : uint8
+{
+	Mono,
+	Stereo,
+	Surround51,     // FL FR FC LFE SL SR
+	Surround714,    // FL FR FC LFE BL BR SL SR TFL TFR TBL TBR
+	Ambisonics1,    // First order, 4 channels
+	Ambisonics2,    // Second order, 9 channels
+	Ambisonics3     // Third order, 16 channels
+};
+
+/** Channels in a layout */
+inline int32 GetChannelCount(EChannelLayout Layout)
+{
+	switch (Layout)
+	{
+	case EChannelLayout::Mono:        return 1;
+	case EChannelLayout::Stereo:      return 2;
+	case EChannelLayout::Surround51:  return 6;
+	case EChannelLayout::Surround714: return 12;
+	case EChannelLayout::Ambisonics1: return 4;
+	case EChannelLayout::Ambisonics2: return 9;
+	default:                          return 16;
+	}
+}
+
+/**
+ * Pans sources into a channel layout
+ *
+ * Directions are listener-relative: azimuth in radians, 0 straight ahead and
+ * positive to the left; elevation positive upwards. Speaker layouts use
+ * constant-power pairwise panning between adjacent speakers (the LFE channel
+ * is never fed); ambisonic layouts encode the direction's spherical harmonics.
+ *
+ * Mixing runs through a kernel chosen once per layout and specialised on its
+ * channel count, so the inner loop has no per-channel branching.
+ */
+class FChannelPanner
+{
+public:
+	static constexpr int32 MaxChannels = 16;
+
+	explicit FChannelPanner(EChannelLayout InLayout = EChannelLayout::Stereo);
+
+	void SetLayout(EChannelLayout InLayout);
+	EChannelLayout GetLayout() const { return Layout; }
+	int32 GetNumChannels() const { return NumChannels; }
+
+	/**
+	 * Gains for a source in a direction
+	 * @param OutGains GetNumChannels() gains
+	 */
+	void ComputeGains(float Azimuth, float Elevation, float* OutGains) const;
+
+	/** Listener-relative angles of a direction (X left, Y up, Z forward) */
+	static void DirectionToAngles(float X, float Y, float Z, float& OutAzimuth, float& OutElevation);
+
+	/**
+	 * Add a mono signal into interleaved output
+	 * @param In Source samples, InStride apart
+	 * @param Gains From ComputeGains
+	 * @param Out NumFrames interleaved frames of GetNumChannels() channels
+	 */
+	void PanMono(const float* In, int32 InStride, int32 NumFrames, const float* Gains, float* Out) const
+	{
+		Kernel(In, InStride, NumFrames, Gains, Out);
+	}
+
+	/**
+	 * Write an interleaved stereo mix into the layout, overwriting Out
+	 * Left and right are placed at +-30 degrees; mono folds them down
+	 */
+	void UpmixStereo(const float* InStereo, int32 NumFrames, float* Out) const;
+
+	typedef void (*FPanKernel)(const float* In, int32 InStride, int32 NumFrames, const float* Gains, float* Out);
+
+private:
+	EChannelLayout Layout;
+	int32 NumChannels;
+	FPanKernel Kernel;
+	float StereoGains[2][MaxChannels];   // Left and right placements for UpmixStereo
+};
@@ -0,0 +1,195 @@
+#include "DeterminismCheck.h"
+#include "Audio/SampleFormat.h"
+#include <thread>
+
+namespace
+{
+	void BuildThreadCounts(int32 MaxThreads, TArray<int32>& OutCounts)
+	{
+		for (int32 Count = 1; Count < MaxThreads; Count *= 2)
+		{
+			OutCounts.Add(Count);
+		}
+		OutCounts.Add(MaxThreads);
+	}
+
+	/** Does nothing but wake up, so every wake-up only splits the block */
+	FSceneScript SplitBlocks(FSandboxManager& Sandbox, int32 Period)
+	{
+		(void)Sandbox;
+		for (;;)
+		{
+			co_await Frames(Period);
+		}
+	}
+}
+
+// ============================================================================
+// FDeterminismChecker Implementation
+// ============================================================================
+
+FDeterminismChecker::FDeterminismChecker()
+	: MaxThreads(0)
+{
+}
+
+int32 FDeterminismChecker::Run()
+{
+	Results.Reset();
+
+	const int32 NumThreadsLimit = MaxThreads > 0 ? MaxThreads : FMath::Max((int32)std::thread::hardware_concurrency(), 1);
+	TArray<int32> ThreadCounts;
+	BuildThreadCounts(NumThreadsLimit, ThreadCounts);
+
+	const ESimdLevel PreviousLevel = GetSimdLevel();
+	int32 NumDiverged = 0;
+
+	for (const FGoldenScene& Scene : Scenes)
+	{
+		FDeterminismTrace Reference;
+		SetSimdLevel(ESimdLevel::Scalar);
+		RenderTrace(Scene, Reference);
+
+		for (int32 Level = 0; Level <= (int32)GetSupportedSimdLevel(); ++Level)
+		{
+			SetSimdLevel((ESimdLevel)Level);
+
+			for (int32 NumThreads : ThreadCounts)
+			{
+				TArray<FDeterminismTrace> Traces;
+				Traces.SetNum(NumThreads);
+
+				// Instance 0 renders on this thread
+				TArray<std::thread> Workers;
+				Workers.Reserve(NumThreads - 1);
+				for (int32 Instance = 1; Instance < NumThreads; ++Instance)
+				{
+					FDeterminismTrace* Trace = &Traces[Instance];
+					Workers.Add(std::thread([&Scene, Trace]() { RenderTrace(Scene, *Trace); }));
+				}
+				RenderTrace(Scene, Traces[0]);
+				for (std::thread& Worker : Workers)
+				{
+					Worker.join();
+				}
+
+				for (int32 Instance = 0; Instance < NumThreads; ++Instance)
+				{
+					FDeterminismResult Result;
+					Result.Scene = Scene.Name;
+					Result.NumThreads = NumThreads;
+					Result.SimdLevel = (ESimdLevel)Level;
+					Result.Instance = Instance;
+					Result.SplitPeriod = 0;
+					Result.DivergentBlock = FindDivergence(Reference, Traces[Instance], Result.Stage);
+					Result.bMatches = Result.DivergentBlock == INDEX_NONE;
+					Result.DivergentFrame = Reference.Blocks.IsValidIndex(Result.DivergentBlock)
+						? Reference.Blocks[Result.DivergentBlock].Frame : -1;
+					if (!Result.bMatches)
+					{
+						++NumDiverged;
+					}
+					Results.Add(Result);
+				}
+			}
+		}
+
+		// Extra segments must leave the procedural voice untouched
+		FDeterminismTrace Split;
+		SetSimdLevel(ESimdLevel::Scalar);
+		RenderTrace(Scene, Split, SplitPeriod);
+
+		FDeterminismResult Result;
+		Result.Scene = Scene.Name;
+		Result.NumThreads = 1;
+		Result.SimdLevel = ESimdLevel::Scalar;
+		Result.Instance = 0;
+		Result.SplitPeriod = SplitPeriod;
+		Result.DivergentBlock = FindDivergence(Reference, Split, Result.Stage, EDeterminismStage::ProceduralAudio);
+		Result.bMatches = Result.DivergentBlock == INDEX_NONE;
+		Result.DivergentFrame = Reference.Blocks.IsValidIndex(Result.DivergentBlock)
+			? Reference.Blocks[Result.DivergentBlock].Frame : -1;
+		if (!Result.bMatches)
+		{
+			++NumDiverged;
+		}
+		Results.Add(Result);
+	}
+
+	SetSimdLevel(PreviousLevel);
+	return NumDiverged;
+}
+
+void FDeterminismChecker::RenderTrace(const FGoldenScene& Scene, FDeterminismTrace& OutTrace, int32 InSplitPeriod)
+{
+	TUniquePtr<FSandboxManager> Sandbox = MakeUnique<FSandboxManager>(Scene.SampleRate, Scene.BufferSize);
+	if (Scene.Build)
+	{
+		Scene.Build(*Sandbox);
+	}
+	if (InSplitPeriod > 0)
+	{
+		// Wake-ups split blocks only at sample granularity
+		Sandbox->GetScriptRunner()->SetGranularity(FSceneScriptRunner::EResumeGranularity::Sample);
+		Sandbox->StartScript(SplitBlocks(*Sandbox, InSplitPeriod));
+	}
+	Sandbox->EnableDeterminismTrace(true);
+
+	const float BlockTime = Scene.BufferSize / Scene.SampleRate;
+	const int32 NumBlocks = FMath::CeilToInt(Scene.Seconds / BlockTime);
+
+	// Same seed every run, so the dither sequence is part of what must match
+	FSampleFormatConverter Converter(ESampleFormat::Int16, EDitherMode::TPDF, 1);
+	TArray<float> Block;
+	TArray<uint8> Pcm;
+	Pcm.SetNum(Converter.GetOutputBytes(2, Scene.BufferSize));
+
+	OutTrace.PcmHashes.Reset();
+	OutTrace.PcmHashes.Reserve(NumBlocks);
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		Sandbox->Update(BlockTime, Block);
+		Converter.ConvertInterleaved(Block.GetData(), 2, Scene.BufferSize, Pcm.GetData());
+		OutTrace.PcmHashes.Add(HashDeterminismBytes(DeterminismHashSeed, Pcm.GetData(), Pcm.Num()));
+	}
+
+	OutTrace.Blocks = Sandbox->GetDeterminismTrace();
+}
+
+int32 FDeterminismChecker::FindDivergence(const FDeterminismTrace& Reference, const FDeterminismTrace& Test, FString& OutStage,
+	EDeterminismStage OnlyStage)
+{
+	const int32 NumBlocks = FMath::Min(Reference.Blocks.Num(), Test.Blocks.Num());
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		const FDeterminismBlockHash& Expected = Reference.Blocks[BlockIndex];
+		const FDeterminismBlockHash& Actual = Test.Blocks[BlockIndex];
+		for (int32 Stage = 0; Stage < (int32)EDeterminismStage::Count; ++Stage)
+		{
+			if (OnlyStage != EDeterminismStage::Count && Stage != (int32)OnlyStage)
+			{
+				continue;
+			}
+			if (Expected.Stages[Stage] != Actual.Stages[Stage])
+			{
+				OutStage = GetDeterminismStageName((EDeterminismStage)Stage);
+				return BlockIndex;
+			}
+		}
+		if (OnlyStage == EDeterminismStage::Count
+			&& Reference.PcmHashes.IsValidIndex(BlockIndex) && Test.PcmHashes.IsValidIndex(BlockIndex)
+			&& Reference.PcmHashes[BlockIndex] != Test.PcmHashes[BlockIndex])
+		{
+			OutStage = TEXT("pcm");
+			return BlockIndex;
+		}
+	}
+
+	if (Reference.Blocks.Num() != Test.Blocks.Num())
+	{
+		OutStage = TEXT("length");
+		return NumBlocks;
+	}
+	OutStage = FString();
+	return INDEX_NONE;
+}
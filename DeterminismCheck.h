@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimdLevel.h"
+#include "Offline/GoldenRender.h"
+
+/**
+ * Outcome of one sandbox instance rendered under one configuration
+ */
+struct FDeterminismResult
+{
+	FString Scene;
+	int32 NumThreads;        // Instances rendering concurrently
+	ESimdLevel SimdLevel;
+	int32 Instance;
+	int32 SplitPeriod;       // Frames between no-op split points added to every block, 0 = none
+	bool bMatches;
+	int32 DivergentBlock;    // First block that differs from the reference, or INDEX_NONE
+	int64 DivergentFrame;
+	FString Stage;           // First stage of that block that differs
+};
+
+/**
+ * Per-block trace of one render: the sandbox's stage hashes plus a hash of the
+ * block converted to dithered 16-bit PCM, which runs the vectorized
+ * sample-format kernel
+ */
+struct FDeterminismTrace
+{
+	TArray<FDeterminismBlockHash> Blocks;
+	TArray<uint64> PcmHashes;
+};
+
+/**
+ * Determinism checker
+ *
+ * Renders each scene once single-threaded on the scalar path as the
+ * reference, then again at every SIMD level with 1..N instances rendering
+ * concurrently, and compares every block's stage hashes bit for bit. A
+ * mismatch is reported as the first divergent block and the first stage of
+ * it that differs, which points at the subsystem that lost determinism.
+ *
+ * Each scene is also rendered with a no-op script waking every SplitPeriod
+ * frames, which splits blocks into extra segments. Physics steps then get
+ * shorter, but the procedural stage must not change: generators advance
+ * once per block however many events fall inside it.
+ *
+ * Scenes are described the same way as for the golden harness.
+ */
+class FDeterminismChecker
+{
+public:
+	FDeterminismChecker();
+
+	void AddScene(const FGoldenScene& Scene) { Scenes.Add(Scene); }
+
+	/** Largest number of concurrent instances; 0 uses the hardware thread count */
+	void SetMaxThreads(int32 InMaxThreads) { MaxThreads = InMaxThreads; }
+
+	/**
+	 * Check every scene at every SIMD level and thread count
+	 * Thread counts are powers of two up to the maximum, plus the maximum itself
+	 * @return Number of instances that diverged from the reference
+	 */
+	int32 Run();
+
+	const TArray<FDeterminismResult>& GetResults() const { return Results; }
+
+	/** Frames between the no-op split points of the split check */
+	static constexpr int32 SplitPeriod = 97;
+
+	/**
+	 * Render a scene with the determinism trace enabled at the current SIMD level
+	 * @param InSplitPeriod Start a script that only waits, waking every this many frames; 0 = none
+	 */
+	static void RenderTrace(const FGoldenScene& Scene, FDeterminismTrace& OutTrace, int32 InSplitPeriod = 0);
+
+	/**
+	 * Find where two traces first differ
+	 * @param OutStage Name of the first differing stage ("pcm" for the converted output, "length" if one trace is shorter)
+	 * @param OnlyStage Compare this stage alone; Count compares every stage and the converted output
+	 * @return Index of the first differing block, or INDEX_NONE if the traces are identical
+	 */
+	static int32 FindDivergence(const FDeterminismTrace& Reference, const FDeterminismTrace& Test, FString& OutStage,
+		EDeterminismStage OnlyStage = EDeterminismStage::Count);
+
+private:
+	TArray<FGoldenScene> Scenes;
+	int32 MaxThreads;
+	TArray<FDeterminismResult> Results;
+};
@@ -6,7 +6,11 @@
 #include "SandboxManager.h"
 #include "Audio/AudioSynthesizer.h"
 #include "Physics/PhysicsCore.h"
+#include "Offline/ParameterSweep.h"
+#include "RealTimeThreads.h"
+#include <chrono>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 /**
@@ -187,6 +191,294 @@ void Example_DirectSynthesis()
 	std::cout << "Generated enveloped sine wave: " << AudioBuffer.Num() << " samples" << std::endl;
 }
 
+/**
+ * Example 6: Snapshot and Fork
+ * Simulate a lead-in once, then fork variations from the warm state
+ */
+void Example_SnapshotFork()
+{
+	std::cout << "=== Example 6: Snapshot and Fork ===" << std::endl;
+
+	FPercussionSandbox Sandbox(48000.0f);
+	Sandbox.DropObject(5.0f, 0.5f, 0.8f);
+
+	// Shared lead-in: 1 second
+	TArray<float> AudioBuffer;
+	for (int i = 0; i < 48000; i += 2048)
+	{
+		Sandbox.Update(0.0426667f, AudioBuffer);
+	}
+
+	FSandboxSnapshot Snapshot;
+	Sandbox.CaptureSnapshot(Snapshot);
+	std::cout << "Snapshot image: " << Snapshot.GetImageSize() << " bytes at frame "
+		<< Snapshot.GetHeader().FrameIndex << std::endl;
+
+	// Each fork continues from the snapshot with a different frequency range
+	for (int Variation = 0; Variation < 4; ++Variation)
+	{
+		TUniquePtr<FSandboxManager> Fork = FSandboxManager::Fork(Snapshot);
+		if (!Fork.IsValid())
+		{
+			continue;
+		}
+
+		Fork->GetProceduralController()->SetFrequencyRange(100.0f + Variation * 200.0f, 1000.0f + Variation * 400.0f);
+		for (int i = 0; i < 48000; i += 2048)
+		{
+			Fork->Update(0.0426667f, AudioBuffer);
+		}
+
+		std::cout << "Variation " << Variation << ": " << Fork->GetRenderedFrames() << " frames" << std::endl;
+	}
+}
+
+/**
+ * Example 7: Parameter Sweep
+ * Grid over drop height and hardness; each height's lead-in is simulated once
+ */
+void Example_ParameterSweep()
+{
+	std::cout << "=== Example 7: Parameter Sweep ===" << std::endl;
+
+	FSweepConfig Config;
+	Config.LeadInSeconds = 0.5f;
+	Config.RenderSeconds = 1.0f;
+	Config.bWriteAudio = false;
+
+	FParameterSweep Sweep(Config);
+	Sweep.AddParameter(ESweepTarget::DropHeight, 2.0f, 8.0f, 3);
+	Sweep.AddParameter(ESweepTarget::MaterialHardness, 0.1f, 0.9f, 4);
+	Sweep.AddParameter(ESweepTarget::Seed, 1.0f, 2.0f, 2);
+
+	const int32 NumPoints = Sweep.Run();
+	std::cout << "Rendered " << NumPoints << " points from " << Sweep.GetNumPrefixes() << " lead-ins" << std::endl;
+}
+
+/**
+ * Example 8: Scripted Timeline
+ * Events are placed on the sample clock; the render loop needs no host logic
+ */
+void Example_ScriptedTimeline()
+{
+	std::cout << "=== Example 8: Scripted Timeline ===" << std::endl;
+
+	const float SampleRate = 48000.0f;
+	FSandboxManager Sandbox(SampleRate, 2048);
+	FSceneTimeline* Timeline = Sandbox.GetTimeline();
+
+	Timeline->AddSpawnSphere(0, FVector3(0, 4.0f, 0), 0.5f, 2.0f);
+	Timeline->AddSpawnSphere(FSceneTimeline::SecondsToFrames(0.5f, SampleRate), FVector3(1.0f, 6.0f, 0), 0.3f, 1.0f);
+	Timeline->AddImpulse(FSceneTimeline::SecondsToFrames(1.0f, SampleRate), 0, FVector3(0, 8.0f, 0));
+	Timeline->AddGeneratorSwap(FSceneTimeline::SecondsToFrames(1.5f, SampleRate),
+		EProceduralParameter::Frequency, EProceduralGeneratorType::Chaotic, 7);
+	Timeline->AddParameterChange(FSceneTimeline::SecondsToFrames(2.0f, SampleRate),
+		ETimelineParameter::MasterVolume, 0.5f);
+
+	TArray<float> AudioBuffer;
+	for (int i = 0; i < 3 * 48000; i += 2048)
+	{
+		Sandbox.Update(2048 / SampleRate, AudioBuffer);
+	}
+
+	FSandboxManager::FSandboxStats Stats;
+	Sandbox.GetStats(Stats);
+	std::cout << "Fired " << Timeline->GetCursor() << " of " << Timeline->Num() << " events, "
+		<< Stats.ActivePhysicsObjects << " bodies" << std::endl;
+}
+
+/**
+ * Example 9: Coroutine Scene Script
+ * A timed scene written as straight-line code instead of a state machine
+ */
+FSceneScript BounceScene(FSandboxManager& Sandbox, TSharedPtr<FPhysicsSphere> Ball)
+{
+	co_await Seconds(0.5f);
+	Sandbox.AddPhysicsObject(Ball);
+
+	for (int32 Bounce = 0; Bounce < 3; ++Bounce)
+	{
+		co_await ImpactOn(Ball);
+		Sandbox.SetMasterVolume(0.8f - Bounce * 0.2f);
+	}
+
+	co_await Seconds(1.0f);
+	Ball->ApplyImpulse(FVector3(0, 10.0f, 0));
+}
+
+void Example_SceneScript()
+{
+	std::cout << "=== Example 9: Coroutine Scene Script ===" << std::endl;
+
+	FSandboxManager Sandbox(48000.0f, 2048);
+
+	auto Ball = MakeShared<FPhysicsSphere>(0.4f, 1.5f);
+	Ball->SetPosition(FVector3(0, 3.0f, 0));
+	Sandbox.StartScript(BounceScene(Sandbox, Ball));
+
+	TArray<float> AudioBuffer;
+	for (int i = 0; i < 4 * 48000; i += 2048)
+	{
+		Sandbox.Update(2048 / 48000.0f, AudioBuffer);
+	}
+
+	std::cout << "Script resumes: " << Sandbox.GetScriptRunner()->GetResumeCount()
+		<< ", still running: " << Sandbox.GetScriptRunner()->Num() << std::endl;
+}
+
+/**
+ * Example 10: Rhythmic Triggers
+ * Euclidean and probabilistic patterns drive impulses and generator swaps
+ */
+void Example_RhythmicTriggers()
+{
+	std::cout << "=== Example 10: Rhythmic Triggers ===" << std::endl;
+
+	FSandboxManager Sandbox(48000.0f, 2048);
+	auto Drum = MakeShared<FPhysicsSphere>(0.5f, 1.0f);
+	Drum->SetPosition(FVector3(0, 1.0f, 0));
+	Sandbox.AddPhysicsObject(Drum);
+
+	FRhythmGenerator* Rhythm = Sandbox.GetRhythmGenerator();
+	Rhythm->SetTempo(110.0f, 0);
+
+	// 5-in-16 Euclidean kick with swing
+	const int32 Kick = Rhythm->AddEuclideanPattern(5, 16);
+	Rhythm->SetSwing(Kick, 0.2f);
+
+	FTimelineEvent KickAction;
+	KickAction.Type = ETimelineEventType::ApplyImpulse;
+	KickAction.BodyIndex = 0;
+	KickAction.Vector = FVector3(0, 6.0f, 0);
+	Sandbox.SetRhythmAction(Kick, KickAction);
+
+	// Once per bar, maybe swap the frequency generator
+	const int32 Swap = Rhythm->AddPattern(0x1, 1, 1);
+	Rhythm->SetStepProbability(Swap, 0, 0.5f);
+
+	FTimelineEvent SwapAction;
+	SwapAction.Type = ETimelineEventType::SwapGenerator;
+	SwapAction.Slot = EProceduralParameter::Frequency;
+	SwapAction.GeneratorType = EProceduralGeneratorType::Chaotic;
+	Sandbox.SetRhythmAction(Swap, SwapAction);
+
+	TArray<float> AudioBuffer;
+	for (int i = 0; i < 4 * 48000; i += 2048)
+	{
+		Sandbox.Update(2048 / 48000.0f, AudioBuffer);
+	}
+
+	std::cout << "Rendered " << Sandbox.GetRenderedFrames() << " frames with "
+		<< Rhythm->Num() << " patterns" << std::endl;
+}
+
+/**
+ * Example 11: Force Fields
+ * Gusty wind, a vortex and a timed explosion animate a cloud of spheres
+ */
+void Example_ForceFields()
+{
+	std::cout << "=== Example 11: Force Fields ===" << std::endl;
+
+	FSandboxManager Sandbox(48000.0f, 2048);
+	Sandbox.GetPhysicsWorld()->SetGravity(FVector3(0, -2.0f, 0));
+
+	for (int32 i = 0; i < 500; ++i)
+	{
+		auto Sphere = MakeShared<FPhysicsSphere>(0.1f, 0.2f + (i % 5) * 0.1f);
+		Sphere->SetPosition(FVector3((i % 25) * 0.4f - 5.0f, 2.0f + (i / 25) * 0.2f, ((i * 7) % 11) * 0.3f - 1.5f));
+		Sandbox.AddPhysicsObject(Sphere);
+	}
+
+	FForceFieldSystem* Fields = Sandbox.GetForceFields();
+	Fields->AddWind(FVector3(1, 0, 0), 0.5f, 3.0f, 0.3f, 0.8f);
+	Fields->AddVortex(FVector3(0, 3.0f, 0), FVector3(0, 1, 0), 4.0f, 3.0f);
+
+	TArray<float> AudioBuffer;
+	for (int i = 0; i < 3 * 48000; i += 2048)
+	{
+		if (i == 48000 - 48000 % 2048)
+		{
+			Fields->AddExplosion(FVector3(0, 1.0f, 0), 60.0f, 4.0f, 0.2f);
+		}
+		Sandbox.Update(2048 / 48000.0f, AudioBuffer);
+	}
+
+	std::cout << Fields->Num() << " fields affected " << Fields->GetAffectedBodyCount()
+		<< " of " << Sandbox.GetPhysicsWorld()->GetObjects().Num() << " bodies in the last step" << std::endl;
+}
+
+void Example_HotReload()
+{
+	std::cout << "=== Example 12: Hot Reload ===" << std::endl;
+
+	FSandboxManager Sandbox(48000.0f, 256);
+	FAssetHotReloader* Reloader = Sandbox.GetHotReloader();
+
+	// No directory: assets arrive as submitted text, as from an editor
+	Reloader->Start(TEXT(""));
+
+	TArray<float> AudioBuffer;
+	const TCHAR* Graphs[] = {
+		TEXT("slot = amplitude\nexpression = 0.5 + 0.5 * sin(t * tau * 2)\n"),
+		TEXT("slot = amplitude\nexpression = env(frac(t * 4), 0.01, 0.2)\n"),
+		TEXT("slot = amplitude\nexpression = clamp(noise(t * 3) + 0.5, 0, 1)\n") };
+
+	for (int32 Version = 0; Version < 3; ++Version)
+	{
+		Reloader->Submit(EHotAssetType::GeneratorGraph, Graphs[Version]);
+		Reloader->Submit(EHotAssetType::SynthPreset, FString::Printf(TEXT("volume = 0.%d\nfrequency_min = %d\n"), 5 + Version, 100 * (Version + 1)));
+
+		// Keep rendering while the loader thread compiles; the swap lands between blocks
+		for (int32 Block = 0; Block < 200; ++Block)
+		{
+			Sandbox.Update(256 / 48000.0f, AudioBuffer);
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	}
+
+	Reloader->Submit(EHotAssetType::Material, TEXT("hardness = 2x\n"));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	Reloader->Stop();
+
+	std::cout << Reloader->GetReloadCount() << " assets reloaded, " << Reloader->GetFailedCount()
+		<< " rejected (" << *Reloader->GetLastError() << ")" << std::endl;
+}
+
+/**
+ * Example 13: Real-Time Thread Setup
+ * Ask for real-time scheduling, pinning and locked memory, and log what was granted
+ * Run last: the main thread keeps its real-time priority afterwards
+ */
+void Example_RealTimeSetup()
+{
+	std::cout << "=== Example 13: Real-Time Thread Setup ===" << std::endl;
+
+	FRealTimeConfig Config;
+	Config.RenderThread.Policy = EThreadPolicy::Fifo;
+	Config.RenderThread.Priority = 80;
+	Config.RenderThread.Cores.Add(0);
+	Config.WorkerThreads.Policy = EThreadPolicy::RoundRobin;
+	Config.WorkerThreads.Priority = 70;
+	Config.PrefaultStackBytes = 256 * 1024;
+	Config.PrefaultHeapBytes = 8 * 1024 * 1024;
+	Config.bKeepHeapResident = true;
+
+	// Production hosts also set bLockMemory, with RLIMIT_MEMLOCK sized for the whole process
+
+	FRealTimeReport Report;
+	ApplyRealTimeConfig(Config, FJobSystem::Get(), Report);
+	std::cout << *Report.ToString();
+
+	FSandboxManager Sandbox(48000.0f, 256);
+	TArray<float> AudioBuffer;
+	for (int32 Block = 0; Block < 100; ++Block)
+	{
+		Sandbox.Update(256 / 48000.0f, AudioBuffer);
+	}
+	std::cout << "Rendered " << Sandbox.GetRenderedFrames() << " frames on the configured thread" << std::endl;
+}
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
@@ -245,6 +537,30 @@ int main()
 		Example_DirectSynthesis();
 		std::cout << std::endl;
 
+		Example_SnapshotFork();
+		std::cout << std::endl;
+
+		Example_ParameterSweep();
+		std::cout << std::endl;
+
+		Example_ScriptedTimeline();
+		std::cout << std::endl;
+
+		Example_SceneScript();
+		std::cout << std::endl;
+
+		Example_RhythmicTriggers();
+		std::cout << std::endl;
+
+		Example_ForceFields();
+		std::cout << std::endl;
+
+		Example_HotReload();
+		std::cout << std::endl;
+
+		Example_RealTimeSetup();
+		std::cout << std::endl;
+
 		std::cout << "All examples completed successfully!" << std::endl;
 	}
 	catch (const std::exception& e)
@@ -0,0 +1,1144 @@
+#include "ExpressionGenerator.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	constexpr float Pi = 3.14159265f;
+
+	// ------------------------------------------------------------------------
+	// Scalar semantics shared by the VM loops and constant folding
+	// ------------------------------------------------------------------------
+
+	inline float OpDiv(float A, float B) { return B != 0.0f ? A / B : 0.0f; }
+	inline float OpMod(float A, float B) { return B != 0.0f ? A - B * std::floor(A / B) : 0.0f; }
+	inline float OpBool(bool bValue) { return bValue ? 1.0f : 0.0f; }
+	inline float OpFrac(float A) { return A - std::floor(A); }
+	inline float OpSqrt(float A) { return std::sqrt(FMath::Max(A, 0.0f)); }
+	inline float OpPow(float A, float B) { return std::pow(FMath::Abs(A), B); }
+	inline float OpClamp(float A, float B, float C) { return FMath::Min(FMath::Max(A, B), C); }
+	inline float OpLerp(float A, float B, float C) { return A + (B - A) * C; }
+	inline float OpStep(float Edge, float X) { return X >= Edge ? 1.0f : 0.0f; }
+
+	/** Linear attack to 1 over Attack seconds, then exponential decay with time constant Decay */
+	inline float OpEnvelope(float X, float Attack, float Decay)
+	{
+		if (X < 0.0f)
+		{
+			return 0.0f;
+		}
+		if (X < Attack)
+		{
+			return X / Attack;
+		}
+		return std::exp(-(X - Attack) / FMath::Max(Decay, 1e-6f));
+	}
+
+	/** Hash of the value's bits to [0, 1) */
+	inline float OpRand(float X, uint32 Seed)
+	{
+		uint32 Bits;
+		std::memcpy(&Bits, &X, sizeof(Bits));
+		uint32 Hash = Bits ^ Seed;
+		Hash *= 0x9E3779B1u;
+		Hash ^= Hash >> 16;
+		Hash *= 0x85EBCA6Bu;
+		Hash ^= Hash >> 13;
+		return (Hash >> 8) * (1.0f / 16777216.0f);
+	}
+
+	/** Pure operations whose result can be computed at compile time */
+	bool FoldOp(EExpressionOp Op, float A, float B, float C, float& OutValue)
+	{
+		switch (Op)
+		{
+		case EExpressionOp::Add:          OutValue = A + B; return true;
+		case EExpressionOp::Sub:          OutValue = A - B; return true;
+		case EExpressionOp::Mul:          OutValue = A * B; return true;
+		case EExpressionOp::Div:          OutValue = OpDiv(A, B); return true;
+		case EExpressionOp::Mod:          OutValue = OpMod(A, B); return true;
+		case EExpressionOp::Neg:          OutValue = -A; return true;
+		case EExpressionOp::Less:         OutValue = OpBool(A < B); return true;
+		case EExpressionOp::LessEqual:    OutValue = OpBool(A <= B); return true;
+		case EExpressionOp::Greater:      OutValue = OpBool(A > B); return true;
+		case EExpressionOp::GreaterEqual: OutValue = OpBool(A >= B); return true;
+		case EExpressionOp::Equal:        OutValue = OpBool(A == B); return true;
+		case EExpressionOp::NotEqual:     OutValue = OpBool(A != B); return true;
+		case EExpressionOp::And:          OutValue = OpBool(A != 0.0f && B != 0.0f); return true;
+		case EExpressionOp::Or:           OutValue = OpBool(A != 0.0f || B != 0.0f); return true;
+		case EExpressionOp::Not:          OutValue = OpBool(A == 0.0f); return true;
+		case EExpressionOp::Select:       OutValue = A != 0.0f ? B : C; return true;
+		case EExpressionOp::Sin:          OutValue = std::sin(A); return true;
+		case EExpressionOp::Cos:          OutValue = std::cos(A); return true;
+		case EExpressionOp::Abs:          OutValue = FMath::Abs(A); return true;
+		case EExpressionOp::Floor:        OutValue = std::floor(A); return true;
+		case EExpressionOp::Frac:         OutValue = OpFrac(A); return true;
+		case EExpressionOp::Sqrt:         OutValue = OpSqrt(A); return true;
+		case EExpressionOp::Exp:          OutValue = std::exp(A); return true;
+		case EExpressionOp::Pow:          OutValue = OpPow(A, B); return true;
+		case EExpressionOp::Min:          OutValue = FMath::Min(A, B); return true;
+		case EExpressionOp::Max:          OutValue = FMath::Max(A, B); return true;
+		case EExpressionOp::Clamp:        OutValue = OpClamp(A, B, C); return true;
+		case EExpressionOp::Lerp:         OutValue = OpLerp(A, B, C); return true;
+		case EExpressionOp::Step:         OutValue = OpStep(A, B); return true;
+		case EExpressionOp::Envelope:     OutValue = OpEnvelope(A, B, C); return true;
+		default:                          return false;
+		}
+	}
+
+	bool IsStateful(EExpressionOp Op)
+	{
+		return Op == EExpressionOp::Smooth || Op == EExpressionOp::Logistic;
+	}
+
+	float GetInitialState(EExpressionOp Op)
+	{
+		return Op == EExpressionOp::Logistic ? 0.5f : 0.0f;
+	}
+
+	struct FFunctionInfo
+	{
+		const TCHAR* Name;
+		EExpressionOp Op;
+		int32 MinArgs;
+		int32 MaxArgs;
+	};
+
+	const FFunctionInfo Functions[] = {
+		{ TEXT("sin"),      EExpressionOp::Sin,      1, 1 },
+		{ TEXT("cos"),      EExpressionOp::Cos,      1, 1 },
+		{ TEXT("abs"),      EExpressionOp::Abs,      1, 1 },
+		{ TEXT("floor"),    EExpressionOp::Floor,    1, 1 },
+		{ TEXT("frac"),     EExpressionOp::Frac,     1, 1 },
+		{ TEXT("sqrt"),     EExpressionOp::Sqrt,     1, 1 },
+		{ TEXT("exp"),      EExpressionOp::Exp,      1, 1 },
+		{ TEXT("pow"),      EExpressionOp::Pow,      2, 2 },
+		{ TEXT("min"),      EExpressionOp::Min,      2, 2 },
+		{ TEXT("max"),      EExpressionOp::Max,      2, 2 },
+		{ TEXT("clamp"),    EExpressionOp::Clamp,    3, 3 },
+		{ TEXT("lerp"),     EExpressionOp::Lerp,     3, 3 },
+		{ TEXT("step"),     EExpressionOp::Step,     2, 2 },
+		{ TEXT("env"),      EExpressionOp::Envelope, 3, 3 },
+		{ TEXT("noise"),    EExpressionOp::Noise2,   1, 3 },
+		{ TEXT("rand"),     EExpressionOp::Rand,     1, 1 },
+		{ TEXT("smooth"),   EExpressionOp::Smooth,   2, 2 },
+		{ TEXT("logistic"), EExpressionOp::Logistic, 1, 1 },
+	};
+
+	// ------------------------------------------------------------------------
+	// Compiler: recursive descent to a small AST, then register allocation
+	// ------------------------------------------------------------------------
+
+	struct FExpressionNode
+	{
+		enum class EKind : uint8 { Constant, Register, Operation };
+
+		EKind Kind;
+		EExpressionOp Op;
+		float Value;
+		int32 Register;
+		int32 Children[3];
+		int32 NumChildren;
+	};
+
+	class FExpressionCompiler
+	{
+	public:
+		FExpressionCompiler(const TCHAR* InSource, FExpressionProgram& InProgram)
+			: Source(InSource), Position(0), Program(InProgram), bFailed(false)
+		{
+			for (int32 i = 0; i < FExpressionProgram::MaxRegisters; ++i)
+			{
+				bTemporary[i] = false;
+				bInUse[i] = i < 2;
+			}
+		}
+
+		bool Compile(FString& OutError)
+		{
+			int32 ResultRegister = INDEX_NONE;
+
+			SkipWhitespace();
+			while (!bFailed && Peek() != 0)
+			{
+				Nodes.Reset();
+				ResultRegister = ParseStatement();
+				SkipWhitespace();
+				if (!bFailed && Peek() != 0 && !Match(TEXT(";")))
+				{
+					Fail(TEXT("Expected ';'"));
+				}
+				SkipWhitespace();
+			}
+
+			if (!bFailed && ResultRegister == INDEX_NONE)
+			{
+				Fail(TEXT("Empty expression"));
+			}
+			if (bFailed)
+			{
+				OutError = Error;
+				return false;
+			}
+
+			Program.ResultRegister = ResultRegister;
+			return true;
+		}
+
+	private:
+		const TCHAR* Source;
+		int32 Position;
+		FExpressionProgram& Program;
+		TArray<FExpressionNode> Nodes;
+		TArray<FString> VariableNames;
+		TArray<int32> VariableRegisters;
+		bool bTemporary[FExpressionProgram::MaxRegisters];
+		bool bInUse[FExpressionProgram::MaxRegisters];
+		bool bFailed;
+		FString Error;
+
+		// Lexing ------------------------------------------------------------
+
+		TCHAR Peek(int32 Offset = 0) const { return Source[Position + Offset]; }
+
+		static bool IsDigit(TCHAR Char) { return Char >= '0' && Char <= '9'; }
+		static bool IsIdentifierStart(TCHAR Char) { return (Char >= 'a' && Char <= 'z') || (Char >= 'A' && Char <= 'Z') || Char == '_'; }
+		static bool IsIdentifierChar(TCHAR Char) { return IsIdentifierStart(Char) || IsDigit(Char); }
+
+		void SkipWhitespace()
+		{
+			while (Peek() == ' ' || Peek() == '\t' || Peek() == '\r' || Peek() == '\n')
+			{
+				++Position;
+			}
+		}
+
+		/** Consume Token if it comes next; single-character tokens never match the start of a longer one */
+		bool Match(const TCHAR* Token)
+		{
+			SkipWhitespace();
+			int32 Length = 0;
+			while (Token[Length] != 0)
+			{
+				if (Peek(Length) != Token[Length])
+				{
+					return false;
+				}
+				++Length;
+			}
+			if (Length == 1 && (Token[0] == '<' || Token[0] == '>' || Token[0] == '=' || Token[0] == '!') && Peek(1) == '=')
+			{
+				return false;
+			}
+			Position += Length;
+			return true;
+		}
+
+		FString ReadIdentifier()
+		{
+			const int32 Start = Position;
+			while (IsIdentifierChar(Peek()))
+			{
+				++Position;
+			}
+			return FString(Position - Start, Source + Start);
+		}
+
+		void Fail(const TCHAR* Message)
+		{
+			if (!bFailed)
+			{
+				bFailed = true;
+				Error = FString::Printf(TEXT("%s at column %d"), Message, Position + 1);
+			}
+		}
+
+		// Parsing -----------------------------------------------------------
+
+		int32 AddNode(const FExpressionNode& Node)
+		{
+			return Nodes.Add(Node);
+		}
+
+		int32 MakeConstant(float Value)
+		{
+			FExpressionNode Node;
+			Node.Kind = FExpressionNode::EKind::Constant;
+			Node.Op = EExpressionOp::Copy;
+			Node.Value = Value;
+			Node.Register = INDEX_NONE;
+			Node.NumChildren = 0;
+			return AddNode(Node);
+		}
+
+		int32 MakeRegister(int32 Register)
+		{
+			FExpressionNode Node;
+			Node.Kind = FExpressionNode::EKind::Register;
+			Node.Op = EExpressionOp::Copy;
+			Node.Value = 0.0f;
+			Node.Register = Register;
+			Node.NumChildren = 0;
+			return AddNode(Node);
+		}
+
+		int32 MakeOperation(EExpressionOp Op, int32 A, int32 B = INDEX_NONE, int32 C = INDEX_NONE)
+		{
+			if (bFailed)
+			{
+				return INDEX_NONE;
+			}
+
+			FExpressionNode Node;
+			Node.Kind = FExpressionNode::EKind::Operation;
+			Node.Op = Op;
+			Node.Value = 0.0f;
+			Node.Register = INDEX_NONE;
+			Node.Children[0] = A;
+			Node.Children[1] = B;
+			Node.Children[2] = C;
+			Node.NumChildren = C != INDEX_NONE ? 3 : (B != INDEX_NONE ? 2 : 1);
+
+			// Fold when every operand is known
+			bool bAllConstant = true;
+			float Values[3] = { 0.0f, 0.0f, 0.0f };
+			for (int32 i = 0; i < Node.NumChildren; ++i)
+			{
+				const FExpressionNode& Child = Nodes[Node.Children[i]];
+				bAllConstant &= Child.Kind == FExpressionNode::EKind::Constant;
+				Values[i] = Child.Value;
+			}
+
+			float Folded;
+			if (bAllConstant && FoldOp(Op, Values[0], Values[1], Values[2], Folded))
+			{
+				return MakeConstant(Folded);
+			}
+			return AddNode(Node);
+		}
+
+		int32 ParseStatement()
+		{
+			// Assignment: identifier '=' (but not '==')
+			const int32 Start = Position;
+			SkipWhitespace();
+			if (IsIdentifierStart(Peek()))
+			{
+				const FString Name = ReadIdentifier();
+				if (Match(TEXT("=")))
+				{
+					if (Name == TEXT("t") || Name == TEXT("i") || FindFunction(Name))
+					{
+						Fail(TEXT("Cannot assign to a built-in name"));
+						return INDEX_NONE;
+					}
+					return AssignVariable(Name, ParseExpression());
+				}
+			}
+			Position = Start;
+
+			const int32 Root = ParseExpression();
+			return bFailed ? INDEX_NONE : Generate(Root);
+		}
+
+		int32 ParseExpression()
+		{
+			const int32 Condition = ParseOr();
+			if (Match(TEXT("?")))
+			{
+				const int32 IfTrue = ParseExpression();
+				if (!Match(TEXT(":")))
+				{
+					Fail(TEXT("Expected ':'"));
+					return INDEX_NONE;
+				}
+				const int32 IfFalse = ParseExpression();
+				return MakeOperation(EExpressionOp::Select, Condition, IfTrue, IfFalse);
+			}
+			return Condition;
+		}
+
+		int32 ParseOr()
+		{
+			int32 Left = ParseAnd();
+			while (!bFailed && Match(TEXT("||")))
+			{
+				Left = MakeOperation(EExpressionOp::Or, Left, ParseAnd());
+			}
+			return Left;
+		}
+
+		int32 ParseAnd()
+		{
+			int32 Left = ParseEquality();
+			while (!bFailed && Match(TEXT("&&")))
+			{
+				Left = MakeOperation(EExpressionOp::And, Left, ParseEquality());
+			}
+			return Left;
+		}
+
+		int32 ParseEquality()
+		{
+			int32 Left = ParseComparison();
+			while (!bFailed)
+			{
+				if (Match(TEXT("==")))
+				{
+					Left = MakeOperation(EExpressionOp::Equal, Left, ParseComparison());
+				}
+				else if (Match(TEXT("!=")))
+				{
+					Left = MakeOperation(EExpressionOp::NotEqual, Left, ParseComparison());
+				}
+				else
+				{
+					break;
+				}
+			}
+			return Left;
+		}
+
+		int32 ParseComparison()
+		{
+			int32 Left = ParseAdditive();
+			while (!bFailed)
+			{
+				if (Match(TEXT("<=")))
+				{
+					Left = MakeOperation(EExpressionOp::LessEqual, Left, ParseAdditive());
+				}
+				else if (Match(TEXT(">=")))
+				{
+					Left = MakeOperation(EExpressionOp::GreaterEqual, Left, ParseAdditive());
+				}
+				else if (Match(TEXT("<")))
+				{
+					Left = MakeOperation(EExpressionOp::Less, Left, ParseAdditive());
+				}
+				else if (Match(TEXT(">")))
+				{
+					Left = MakeOperation(EExpressionOp::Greater, Left, ParseAdditive());
+				}
+				else
+				{
+					break;
+				}
+			}
+			return Left;
+		}
+
+		int32 ParseAdditive()
+		{
+			int32 Left = ParseMultiplicative();
+			while (!bFailed)
+			{
+				if (Match(TEXT("+")))
+				{
+					Left = MakeOperation(EExpressionOp::Add, Left, ParseMultiplicative());
+				}
+				else if (Match(TEXT("-")))
+				{
+					Left = MakeOperation(EExpressionOp::Sub, Left, ParseMultiplicative());
+				}
+				else
+				{
+					break;
+				}
+			}
+			return Left;
+		}
+
+		int32 ParseMultiplicative()
+		{
+			int32 Left = ParseUnary();
+			while (!bFailed)
+			{
+				if (Match(TEXT("*")))
+				{
+					Left = MakeOperation(EExpressionOp::Mul, Left, ParseUnary());
+				}
+				else if (Match(TEXT("/")))
+				{
+					Left = MakeOperation(EExpressionOp::Div, Left, ParseUnary());
+				}
+				else if (Match(TEXT("%")))
+				{
+					Left = MakeOperation(EExpressionOp::Mod, Left, ParseUnary());
+				}
+				else
+				{
+					break;
+				}
+			}
+			return Left;
+		}
+
+		int32 ParseUnary()
+		{
+			if (Match(TEXT("-")))
+			{
+				return MakeOperation(EExpressionOp::Neg, ParseUnary());
+			}
+			if (Match(TEXT("+")))
+			{
+				return ParseUnary();
+			}
+			if (Match(TEXT("!")))
+			{
+				return MakeOperation(EExpressionOp::Not, ParseUnary());
+			}
+			return ParsePrimary();
+		}
+
+		int32 ParsePrimary()
+		{
+			SkipWhitespace();
+
+			if (Match(TEXT("(")))
+			{
+				const int32 Inner = ParseExpression();
+				if (!Match(TEXT(")")))
+				{
+					Fail(TEXT("Expected ')'"));
+					return INDEX_NONE;
+				}
+				return Inner;
+			}
+
+			if (IsDigit(Peek()) || (Peek() == '.' && IsDigit(Peek(1))))
+			{
+				return ParseNumber();
+			}
+
+			if (IsIdentifierStart(Peek()))
+			{
+				const FString Name = ReadIdentifier();
+				if (Match(TEXT("(")))
+				{
+					return ParseCall(Name);
+				}
+				return ResolveName(Name);
+			}
+
+			Fail(Peek() == 0 ? TEXT("Unexpected end of expression") : TEXT("Unexpected character"));
+			return INDEX_NONE;
+		}
+
+		int32 ParseNumber()
+		{
+			double Value = 0.0;
+			while (IsDigit(Peek()))
+			{
+				Value = Value * 10.0 + (Peek() - '0');
+				++Position;
+			}
+			if (Peek() == '.')
+			{
+				++Position;
+				for (double Scale = 0.1; IsDigit(Peek()); Scale *= 0.1)
+				{
+					Value += (Peek() - '0') * Scale;
+					++Position;
+				}
+			}
+			if ((Peek() == 'e' || Peek() == 'E') && (IsDigit(Peek(1)) || ((Peek(1) == '-' || Peek(1) == '+') && IsDigit(Peek(2)))))
+			{
+				++Position;
+				const bool bNegative = Peek() == '-';
+				if (Peek() == '-' || Peek() == '+')
+				{
+					++Position;
+				}
+				int32 Exponent = 0;
+				while (IsDigit(Peek()))
+				{
+					Exponent = FMath::Min(Exponent * 10 + (Peek() - '0'), 400);
+					++Position;
+				}
+				Value *= std::pow(10.0, bNegative ? -Exponent : Exponent);
+			}
+			return MakeConstant((float)Value);
+		}
+
+		int32 ParseCall(const FString& Name)
+		{
+			const FFunctionInfo* Function = FindFunction(Name);
+			if (!Function)
+			{
+				Fail(TEXT("Unknown function"));
+				return INDEX_NONE;
+			}
+
+			int32 Args[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+			int32 NumArgs = 0;
+			if (!Match(TEXT(")")))
+			{
+				do
+				{
+					if (NumArgs == Function->MaxArgs)
+					{
+						Fail(TEXT("Too many arguments"));
+						return INDEX_NONE;
+					}
+					Args[NumArgs++] = ParseExpression();
+				}
+				while (!bFailed && Match(TEXT(",")));
+
+				if (!Match(TEXT(")")))
+				{
+					Fail(TEXT("Expected ')'"));
+					return INDEX_NONE;
+				}
+			}
+			if (NumArgs < Function->MinArgs)
+			{
+				Fail(TEXT("Too few arguments"));
+				return INDEX_NONE;
+			}
+
+			// 1D noise is a slice of the 2D field
+			EExpressionOp Op = Function->Op;
+			if (Op == EExpressionOp::Noise2)
+			{
+				if (NumArgs == 1)
+				{
+					Args[1] = MakeConstant(0.0f);
+				}
+				else if (NumArgs == 3)
+				{
+					Op = EExpressionOp::Noise3;
+				}
+			}
+			return MakeOperation(Op, Args[0], Args[1], Args[2]);
+		}
+
+		int32 ResolveName(const FString& Name)
+		{
+			if (Name == TEXT("t"))
+			{
+				return MakeRegister(FExpressionProgram::TimeRegister);
+			}
+			if (Name == TEXT("i"))
+			{
+				return MakeRegister(FExpressionProgram::IndexRegister);
+			}
+			if (Name == TEXT("pi"))
+			{
+				return MakeConstant(Pi);
+			}
+			if (Name == TEXT("tau"))
+			{
+				return MakeConstant(2.0f * Pi);
+			}
+
+			for (int32 i = 0; i < VariableNames.Num(); ++i)
+			{
+				if (VariableNames[i] == Name)
+				{
+					return MakeRegister(VariableRegisters[i]);
+				}
+			}
+
+			for (const FExpressionProgram::FInput& Input : Program.Inputs)
+			{
+				if (Input.Name == Name)
+				{
+					return MakeRegister(Input.Register);
+				}
+			}
+
+			const int32 Register = AllocateRegister(false);
+			if (Register == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			FExpressionProgram::FInput Input;
+			Input.Name = Name;
+			Input.Register = Register;
+			Program.Inputs.Add(Input);
+			return MakeRegister(Register);
+		}
+
+		static const FFunctionInfo* FindFunction(const FString& Name)
+		{
+			for (const FFunctionInfo& Function : Functions)
+			{
+				if (Name == Function.Name)
+				{
+					return &Function;
+				}
+			}
+			return nullptr;
+		}
+
+		// Code generation ---------------------------------------------------
+
+		int32 AllocateRegister(bool bIsTemporary)
+		{
+			for (int32 i = 0; i < FExpressionProgram::MaxRegisters; ++i)
+			{
+				if (!bInUse[i])
+				{
+					bInUse[i] = true;
+					bTemporary[i] = bIsTemporary;
+					Program.NumRegisters = FMath::Max(Program.NumRegisters, i + 1);
+					return i;
+				}
+			}
+			Fail(TEXT("Expression needs too many registers"));
+			return INDEX_NONE;
+		}
+
+		void ReleaseIfTemporary(int32 Register)
+		{
+			if (Register != INDEX_NONE && bTemporary[Register])
+			{
+				bInUse[Register] = false;
+				bTemporary[Register] = false;
+			}
+		}
+
+		int32 GetConstantRegister(float Value)
+		{
+			for (const FExpressionProgram::FConstant& Constant : Program.Constants)
+			{
+				if (std::memcmp(&Constant.Value, &Value, sizeof(float)) == 0)
+				{
+					return Constant.Register;
+				}
+			}
+
+			const int32 Register = AllocateRegister(false);
+			if (Register != INDEX_NONE)
+			{
+				FExpressionProgram::FConstant Constant;
+				Constant.Register = Register;
+				Constant.Value = Value;
+				Program.Constants.Add(Constant);
+			}
+			return Register;
+		}
+
+		int32 Generate(int32 NodeIndex)
+		{
+			if (bFailed || NodeIndex == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+
+			const FExpressionNode Node = Nodes[NodeIndex];
+			switch (Node.Kind)
+			{
+			case FExpressionNode::EKind::Constant:
+				return GetConstantRegister(Node.Value);
+			case FExpressionNode::EKind::Register:
+				return Node.Register;
+			default:
+				break;
+			}
+
+			int32 Operands[3] = { 0, 0, 0 };
+			for (int32 i = 0; i < Node.NumChildren; ++i)
+			{
+				Operands[i] = Generate(Node.Children[i]);
+				if (Operands[i] == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+			}
+
+			// Operations are element-wise, so the result may reuse an operand's register
+			for (int32 i = 0; i < Node.NumChildren; ++i)
+			{
+				ReleaseIfTemporary(Operands[i]);
+			}
+			const int32 Dst = AllocateRegister(true);
+			if (Dst == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+
+			FExpressionInstruction Instruction;
+			Instruction.Op = Node.Op;
+			Instruction.Dst = (uint8)Dst;
+			Instruction.A = (uint8)Operands[0];
+			Instruction.B = (uint8)Operands[1];
+			Instruction.C = (uint8)Operands[2];
+			Instruction.StateSlot = IsStateful(Node.Op) ? Program.NumStates++ : INDEX_NONE;
+			Program.Code.Add(Instruction);
+			return Dst;
+		}
+
+		int32 AssignVariable(const FString& Name, int32 Root)
+		{
+			const int32 Value = Generate(Root);
+			if (Value == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+
+			int32 Variable = INDEX_NONE;
+			for (int32 i = 0; i < VariableNames.Num(); ++i)
+			{
+				if (VariableNames[i] == Name)
+				{
+					Variable = VariableRegisters[i];
+				}
+			}
+
+			// A fresh temporary can simply become the variable
+			if (Variable == INDEX_NONE && bTemporary[Value])
+			{
+				bTemporary[Value] = false;
+				VariableNames.Add(Name);
+				VariableRegisters.Add(Value);
+				return Value;
+			}
+
+			if (Variable == INDEX_NONE)
+			{
+				Variable = AllocateRegister(false);
+				if (Variable == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+				VariableNames.Add(Name);
+				VariableRegisters.Add(Variable);
+			}
+
+			FExpressionInstruction Instruction;
+			Instruction.Op = EExpressionOp::Copy;
+			Instruction.Dst = (uint8)Variable;
+			Instruction.A = (uint8)Value;
+			Instruction.B = 0;
+			Instruction.C = 0;
+			Instruction.StateSlot = INDEX_NONE;
+			Program.Code.Add(Instruction);
+			ReleaseIfTemporary(Value);
+			return Variable;
+		}
+	};
+}
+
+// ============================================================================
+// FExpressionProgram Implementation
+// ============================================================================
+
+bool FExpressionProgram::Compile(const FString& Source, FExpressionProgram& OutProgram, FString* OutError)
+{
+	OutProgram = FExpressionProgram();
+
+	FString Error;
+	FExpressionCompiler Compiler(*Source, OutProgram);
+	if (!Compiler.Compile(Error))
+	{
+		OutProgram = FExpressionProgram();
+		if (OutError)
+		{
+			*OutError = Error;
+		}
+		return false;
+	}
+	return true;
+}
+
+// ============================================================================
+// FExpressionGenerator Implementation
+// ============================================================================
+
+FExpressionGenerator::FExpressionGenerator(uint32 InSeed)
+	: Noise(InSeed)
+	, Seed(InSeed)
+	, TimeStep(0.01f)
+	, Time(0.0)
+	, Index(0)
+	, ReadIndex(0)
+	, BufferCount(0)
+	, PrefetchCount(BlockSize)
+{
+	Registers.SetNum(FExpressionProgram::MaxRegisters * BlockSize);
+	Buffer.SetNum(BlockSize);
+
+	// An empty generator produces a constant zero
+	Compile(TEXT("0"));
+}
+
+bool FExpressionGenerator::Compile(const FString& InSource, FString* OutError)
+{
+	FExpressionProgram Compiled;
+	if (!FExpressionProgram::Compile(InSource, Compiled, OutError))
+	{
+		return false;
+	}
+
+	Source = InSource;
+	LoadProgram(MoveTemp(Compiled));
+	return true;
+}
+
+void FExpressionGenerator::LoadProgram(FExpressionProgram&& InProgram)
+{
+	DiscardBuffer();
+	Program = MoveTemp(InProgram);
+
+	// Constants are written once; no instruction ever targets their registers
+	for (const FExpressionProgram::FConstant& Constant : Program.Constants)
+	{
+		float* Register = GetRegister(Constant.Register);
+		for (int32 i = 0; i < BlockSize; ++i)
+		{
+			Register[i] = Constant.Value;
+		}
+	}
+
+	InputValues.SetNum(Program.Inputs.Num());
+	for (int32 Input = 0; Input < InputValues.Num(); ++Input)
+	{
+		InputValues[Input] = 0.0f;
+		FMemory::Memzero(GetRegister(Program.Inputs[Input].Register), sizeof(float) * BlockSize);
+	}
+
+	State.SetNum(Program.NumStates);
+	FillState.SetNum(Program.NumStates);
+	ResetState();
+}
+
+bool FExpressionGenerator::SetInput(const TCHAR* Name, float Value)
+{
+	for (int32 Input = 0; Input < Program.Inputs.Num(); ++Input)
+	{
+		if (Program.Inputs[Input].Name == Name)
+		{
+			if (InputValues[Input] == Value)
+			{
+				return true;
+			}
+			DiscardBuffer();
+			InputValues[Input] = Value;
+			float* Register = GetRegister(Program.Inputs[Input].Register);
+			for (int32 i = 0; i < BlockSize; ++i)
+			{
+				Register[i] = Value;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void FExpressionGenerator::Evaluate(float* OutValues, int32 Count)
+{
+	DiscardBuffer();
+	Fill(OutValues, Count);
+}
+
+void FExpressionGenerator::Fill(float* OutValues, int32 Count)
+{
+	for (int32 Start = 0; Start < Count; Start += BlockSize)
+	{
+		const int32 Num = FMath::Min(BlockSize, Count - Start);
+		Execute(Num);
+		FMemory::Memcpy(OutValues + Start, GetRegister(Program.ResultRegister), sizeof(float) * Num);
+	}
+}
+
+float FExpressionGenerator::GetNextValue()
+{
+	if (ReadIndex >= BufferCount)
+	{
+		if (BufferCount == PrefetchCount)
+		{
+			PrefetchCount = FMath::Min(PrefetchCount * 2, BlockSize);
+		}
+		if (Program.NumStates > 0)
+		{
+			FMemory::Memcpy(FillState.GetData(), State.GetData(), sizeof(float) * Program.NumStates);
+		}
+		Fill(Buffer.GetData(), PrefetchCount);
+		BufferCount = PrefetchCount;
+		ReadIndex = 0;
+	}
+	return FMath::Clamp(Buffer[ReadIndex++], 0.0f, 1.0f);
+}
+
+void FExpressionGenerator::Reset()
+{
+	Time = 0.0;
+	Index = 0;
+	ResetState();
+	ReadIndex = 0;
+	BufferCount = 0;
+}
+
+void FExpressionGenerator::SetSeed(uint32 InSeed)
+{
+	DiscardBuffer();
+	Seed = InSeed;
+	Noise.SetSeed(InSeed);
+}
+
+void FExpressionGenerator::Serialize(FSandboxArchive& Ar)
+{
+	TArray<TCHAR> SourceChars;
+	if (Ar.IsSaving())
+	{
+		SourceChars.Append(*Source, Source.Len() + 1);
+	}
+	Ar << SourceChars;
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || SourceChars.Num() == 0 || !Compile(FString(SourceChars.GetData())))
+		{
+			return;
+		}
+	}
+
+	Ar << Seed << TimeStep << Time << Index << InputValues << State << FillState << Buffer << ReadIndex << BufferCount << PrefetchCount;
+
+	if (Ar.IsLoading())
+	{
+		Noise.SetSeed(Seed);
+		for (int32 Input = 0; Input < Program.Inputs.Num() && Input < InputValues.Num(); ++Input)
+		{
+			float* Register = GetRegister(Program.Inputs[Input].Register);
+			for (int32 i = 0; i < BlockSize; ++i)
+			{
+				Register[i] = InputValues[Input];
+			}
+		}
+	}
+}
+
+void FExpressionGenerator::ResetState()
+{
+	for (const FExpressionInstruction& Instruction : Program.Code)
+	{
+		if (Instruction.StateSlot != INDEX_NONE)
+		{
+			State[Instruction.StateSlot] = GetInitialState(Instruction.Op);
+		}
+	}
+}
+
+void FExpressionGenerator::DiscardBuffer()
+{
+	// Rewind the clock to the first unread value so the sequence has no gap
+	if (ReadIndex < BufferCount)
+	{
+		if (Program.NumStates > 0)
+		{
+			// Stateful ops have advanced past the unread values too: restore the state at the fill
+			// and replay the values already read, with the inputs they were computed from
+			Time -= (double)BufferCount * TimeStep;
+			Index -= BufferCount;
+			FMemory::Memcpy(State.GetData(), FillState.GetData(), sizeof(float) * Program.NumStates);
+			if (ReadIndex > 0)
+			{
+				Execute(ReadIndex);
+			}
+		}
+		else
+		{
+			const int32 Unread = BufferCount - ReadIndex;
+			Time -= (double)Unread * TimeStep;
+			Index -= Unread;
+		}
+		PrefetchCount = FMath::Max(ReadIndex, 1);
+	}
+	ReadIndex = 0;
+	BufferCount = 0;
+}
+
+void FExpressionGenerator::Execute(int32 Count)
+{
+	float* TimeValues = GetRegister(FExpressionProgram::TimeRegister);
+	float* IndexValues = GetRegister(FExpressionProgram::IndexRegister);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		TimeValues[i] = (float)(Time + (double)i * TimeStep);
+		IndexValues[i] = (float)(Index + i);
+	}
+
+	// One dispatch per instruction; the inner loops are plain element-wise kernels
+	for (const FExpressionInstruction& Instruction : Program.Code)
+	{
+		float* D = GetRegister(Instruction.Dst);
+		const float* A = GetRegister(Instruction.A);
+		const float* B = GetRegister(Instruction.B);
+		const float* C = GetRegister(Instruction.C);
+
+		switch (Instruction.Op)
+		{
+		case EExpressionOp::Copy:         for (int32 i = 0; i < Count; ++i) D[i] = A[i]; break;
+		case EExpressionOp::Add:          for (int32 i = 0; i < Count; ++i) D[i] = A[i] + B[i]; break;
+		case EExpressionOp::Sub:          for (int32 i = 0; i < Count; ++i) D[i] = A[i] - B[i]; break;
+		case EExpressionOp::Mul:          for (int32 i = 0; i < Count; ++i) D[i] = A[i] * B[i]; break;
+		case EExpressionOp::Div:          for (int32 i = 0; i < Count; ++i) D[i] = OpDiv(A[i], B[i]); break;
+		case EExpressionOp::Mod:          for (int32 i = 0; i < Count; ++i) D[i] = OpMod(A[i], B[i]); break;
+		case EExpressionOp::Neg:          for (int32 i = 0; i < Count; ++i) D[i] = -A[i]; break;
+		case EExpressionOp::Less:         for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] < B[i]); break;
+		case EExpressionOp::LessEqual:    for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] <= B[i]); break;
+		case EExpressionOp::Greater:      for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] > B[i]); break;
+		case EExpressionOp::GreaterEqual: for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] >= B[i]); break;
+		case EExpressionOp::Equal:        for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] == B[i]); break;
+		case EExpressionOp::NotEqual:     for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] != B[i]); break;
+		case EExpressionOp::And:          for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] != 0.0f && B[i] != 0.0f); break;
+		case EExpressionOp::Or:           for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] != 0.0f || B[i] != 0.0f); break;
+		case EExpressionOp::Not:          for (int32 i = 0; i < Count; ++i) D[i] = OpBool(A[i] == 0.0f); break;
+		case EExpressionOp::Select:       for (int32 i = 0; i < Count; ++i) D[i] = A[i] != 0.0f ? B[i] : C[i]; break;
+		case EExpressionOp::Sin:          for (int32 i = 0; i < Count; ++i) D[i] = std::sin(A[i]); break;
+		case EExpressionOp::Cos:          for (int32 i = 0; i < Count; ++i) D[i] = std::cos(A[i]); break;
+		case EExpressionOp::Abs:          for (int32 i = 0; i < Count; ++i) D[i] = FMath::Abs(A[i]); break;
+		case EExpressionOp::Floor:        for (int32 i = 0; i < Count; ++i) D[i] = std::floor(A[i]); break;
+		case EExpressionOp::Frac:         for (int32 i = 0; i < Count; ++i) D[i] = OpFrac(A[i]); break;
+		case EExpressionOp::Sqrt:         for (int32 i = 0; i < Count; ++i) D[i] = OpSqrt(A[i]); break;
+		case EExpressionOp::Exp:          for (int32 i = 0; i < Count; ++i) D[i] = std::exp(A[i]); break;
+		case EExpressionOp::Pow:          for (int32 i = 0; i < Count; ++i) D[i] = OpPow(A[i], B[i]); break;
+		case EExpressionOp::Min:          for (int32 i = 0; i < Count; ++i) D[i] = FMath::Min(A[i], B[i]); break;
+		case EExpressionOp::Max:          for (int32 i = 0; i < Count; ++i) D[i] = FMath::Max(A[i], B[i]); break;
+		case EExpressionOp::Clamp:        for (int32 i = 0; i < Count; ++i) D[i] = OpClamp(A[i], B[i], C[i]); break;
+		case EExpressionOp::Lerp:         for (int32 i = 0; i < Count; ++i) D[i] = OpLerp(A[i], B[i], C[i]); break;
+		case EExpressionOp::Step:         for (int32 i = 0; i < Count; ++i) D[i] = OpStep(A[i], B[i]); break;
+		case EExpressionOp::Envelope:     for (int32 i = 0; i < Count; ++i) D[i] = OpEnvelope(A[i], B[i], C[i]); break;
+		case EExpressionOp::Noise2:       Noise.Evaluate2D(A, B, D, Count); break;
+		case EExpressionOp::Noise3:       Noise.Evaluate3D(A, B, C, D, Count); break;
+		case EExpressionOp::Rand:         for (int32 i = 0; i < Count; ++i) D[i] = OpRand(A[i], Seed); break;
+
+		case EExpressionOp::Smooth:
+		{
+			// One-pole lowpass: y += coeff * (x - y)
+			float Y = State[Instruction.StateSlot];
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Y += FMath::Clamp(B[i], 0.0f, 1.0f) * (A[i] - Y);
+				D[i] = Y;
+			}
+			State[Instruction.StateSlot] = Y;
+			break;
+		}
+
+		case EExpressionOp::Logistic:
+		{
+			// x' = r x (1 - x); chaotic for r above ~3.57
+			float X = State[Instruction.StateSlot];
+			for (int32 i = 0; i < Count; ++i)
+			{
+				X = FMath::Clamp(A[i], 0.0f, 4.0f) * X * (1.0f - X);
+				D[i] = X;
+			}
+			State[Instruction.StateSlot] = X;
+			break;
+		}
+		}
+	}
+
+	Time += (double)Count * TimeStep;
+	Index += Count;
+}
+
+TUniquePtr<FProceduralGenerator> CreateExpressionGenerator()
+{
+	return MakeUnique<FExpressionGenerator>();
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralGeneration.h"
+#include "SimplexNoise.h"
+#include "SandboxArchive.h"
+
+/**
+ * Bytecode operations; each one processes a whole block of values
+ */
+enum class EExpressionOp : uint8
+{
+	Copy,
+	Add, Sub, Mul, Div, Mod, Neg,
+	Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+	And, Or, Not, Select,
+	Sin, Cos, Abs, Floor, Frac, Sqrt, Exp, Pow,
+	Min, Max, Clamp, Lerp, Step, Envelope,
+	Noise2, Noise3, Rand,
+	Smooth, Logistic   // Stateful: carry a value from one element to the next
+};
+
+/**
+ * Register-based instruction: Dst = Op(A, B, C)
+ */
+struct FExpressionInstruction
+{
+	EExpressionOp Op;
+	uint8 Dst;
+	uint8 A;
+	uint8 B;
+	uint8 C;
+	int32 StateSlot;   // Index into the state array for stateful ops, else INDEX_NONE
+};
+
+/**
+ * Compiled form of an expression
+ * Registers 0 and 1 hold t (seconds) and i (value index); inputs, constants,
+ * variables and temporaries follow.
+ */
+struct FExpressionProgram
+{
+	static constexpr int32 MaxRegisters = 64;
+	static constexpr int32 TimeRegister = 0;
+	static constexpr int32 IndexRegister = 1;
+
+	struct FConstant
+	{
+		int32 Register;
+		float Value;
+	};
+
+	struct FInput
+	{
+		FString Name;
+		int32 Register;
+	};
+
+	TArray<FExpressionInstruction> Code;
+	TArray<FConstant> Constants;
+	TArray<FInput> Inputs;
+	int32 NumRegisters;
+	int32 NumStates;
+	int32 ResultRegister;
+
+	FExpressionProgram() : NumRegisters(2), NumStates(0), ResultRegister(TimeRegister) {}
+
+	/**
+	 * Compile source text
+	 *
+	 * A program is a list of statements separated by ';'. Statements of the
+	 * form "name = expr" define variables; the last statement is the result.
+	 * Expressions support + - * / %, comparisons, && || !, "c ? a : b", pi,
+	 * tau and the functions sin cos abs floor frac sqrt exp pow min max clamp
+	 * lerp step env(x, attack, decay) noise(x[, y[, z]]) rand(x)
+	 * smooth(x, coeff) and logistic(r). Names that are neither t, i nor a
+	 * variable become inputs, settable with FExpressionGenerator::SetInput.
+	 *
+	 * Constant subexpressions are folded, and both sides of "?:" are evaluated.
+	 *
+	 * @param OutError Receives a message with the column of the first error
+	 * @return false if the source does not compile; OutProgram is then empty
+	 */
+	static bool Compile(const FString& Source, FExpressionProgram& OutProgram, FString* OutError = nullptr);
+};
+
+/**
+ * Procedural generator defined by an expression
+ * e.g. "lfo = sin(t * tau * rate); clamp(0.5 + 0.3 * lfo + 0.2 * noise(t), 0, 1)"
+ *
+ * Evaluation is vector-at-a-time: every instruction runs over a block of
+ * values before the next is dispatched, so interpretation cost is paid once
+ * per block rather than once per value.
+ */
+class FExpressionGenerator : public FProceduralGenerator
+{
+public:
+	static constexpr int32 BlockSize = 256;
+
+	FExpressionGenerator(uint32 InSeed = 12345);
+
+	/**
+	 * Replace the program; on failure the previous program stays active
+	 * @return false on a compile error
+	 */
+	bool Compile(const FString& InSource, FString* OutError = nullptr);
+	const FString& GetSource() const { return Source; }
+
+	/**
+	 * Set a named input; takes effect from the next value produced
+	 * @return false if the program has no input of that name
+	 */
+	virtual bool SetInput(const TCHAR* Name, float Value) override;
+
+	/** Seconds that t advances per value */
+	void SetTimeStep(float InTimeStep) { TimeStep = InTimeStep; }
+
+	/**
+	 * Evaluate the next Count values without clamping
+	 * Continues from the last value GetNextValue returned; values it prefetched but did not hand out
+	 * are discarded first, so the two can be interleaved without a gap or a repeat
+	 */
+	void Evaluate(float* OutValues, int32 Count);
+
+	// FProceduralGenerator interface (clamped to [0, 1])
+	virtual float GetNextValue() override;
+	virtual void Reset() override;
+	virtual void SetSeed(uint32 InSeed) override;
+
+	virtual EProceduralGeneratorType GetGeneratorType() const override { return EProceduralGeneratorType::Expression; }
+	virtual void Serialize(FSandboxArchive& Ar) override;
+
+	const FExpressionProgram& GetProgram() const { return Program; }
+
+private:
+	FExpressionProgram Program;
+	FString Source;
+	FSimplexNoise Noise;
+	uint32 Seed;
+	float TimeStep;
+	double Time;
+	int64 Index;
+
+	TArray<float> Registers;    // MaxRegisters blocks of BlockSize values
+	TArray<float> InputValues;
+	TArray<float> State;
+	TArray<float> FillState;    // State when Buffer was filled, for replaying up to the first unread value
+
+	// Values handed out by GetNextValue: Buffer[ReadIndex, BufferCount)
+	// Refills shrink to what was actually read when input changes discard values, and grow back otherwise
+	// Discarding must happen before the change, while the read values can still be replayed
+	TArray<float> Buffer;
+	int32 ReadIndex;
+	int32 BufferCount;
+	int32 PrefetchCount;
+
+	float* GetRegister(int32 Register) { return Registers.GetData() + Register * BlockSize; }
+	void LoadProgram(FExpressionProgram&& InProgram);
+	void ResetState();
+	void DiscardBuffer();
+	void Fill(float* OutValues, int32 Count);
+	void Execute(int32 Count);
+};
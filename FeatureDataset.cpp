@@ -0,0 +1,107 @@
+#include "FeatureDataset.h"
+#include <fstream>
+
+namespace
+{
+	constexpr char DatasetMagic[8] = { 'S', 'B', 'F', 'E', 'A', 'T', 'S', '\0' };
+	constexpr uint64 HeaderBytes = 64;
+	constexpr uint64 ColumnEntryBytes = 64;
+	constexpr uint64 ColumnAlignment = 64;
+
+	inline uint64 AlignUp(uint64 Value, uint64 Alignment)
+	{
+		return (Value + Alignment - 1) / Alignment * Alignment;
+	}
+
+	template<typename T>
+	void Store(uint8* Out, T Value)
+	{
+		FMemory::Memcpy(Out, &Value, sizeof(T));
+	}
+}
+
+// ============================================================================
+// FFeatureDataset Implementation
+// ============================================================================
+
+int32 FFeatureDataset::AddColumn(const FString& Name, EDatasetColumnType Type)
+{
+	FColumn Column;
+	Column.Name = Name;
+	Column.Type = Type;
+	return Columns.Add(MoveTemp(Column));
+}
+
+void FFeatureDataset::Reserve(int32 NumRows)
+{
+	for (FColumn& Column : Columns)
+	{
+		Column.Values.Reserve(NumRows);
+	}
+}
+
+void FFeatureDataset::AppendFloats(int32 FirstColumn, const float* Values, int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		AppendWord(FirstColumn + i, Values + i);
+	}
+}
+
+void FFeatureDataset::ResetRows()
+{
+	for (FColumn& Column : Columns)
+	{
+		Column.Values.Reset();
+	}
+}
+
+bool FFeatureDataset::Write(const FString& Filename) const
+{
+	const int32 NumRows = GetNumRows();
+	for (const FColumn& Column : Columns)
+	{
+		if (Column.Values.Num() != NumRows)
+		{
+			return false;
+		}
+	}
+
+	// Header and column table, followed by aligned column data
+	const uint64 ColumnBytes = (uint64)NumRows * sizeof(uint32);
+	TArray<uint8> Header;
+	Header.SetNum((int32)AlignUp(HeaderBytes + ColumnEntryBytes * Columns.Num(), ColumnAlignment));
+	FMemory::Memzero(Header.GetData(), Header.Num());
+
+	FMemory::Memcpy(Header.GetData(), DatasetMagic, sizeof(DatasetMagic));
+	Store<uint32>(Header.GetData() + 8, Version);
+	Store<uint32>(Header.GetData() + 12, (uint32)Columns.Num());
+	Store<uint64>(Header.GetData() + 16, (uint64)NumRows);
+
+	uint64 Offset = Header.Num();
+	for (int32 Index = 0; Index < Columns.Num(); ++Index)
+	{
+		const FColumn& Column = Columns[Index];
+		uint8* Entry = Header.GetData() + HeaderBytes + ColumnEntryBytes * Index;
+		FMemory::Memcpy(Entry, *Column.Name, FMath::Min(Column.Name.Len(), MaxNameLength));
+		Store<uint32>(Entry + 48, (uint32)Column.Type);
+		Store<uint64>(Entry + 56, Offset);
+		Offset = AlignUp(Offset + ColumnBytes, ColumnAlignment);
+	}
+
+	std::ofstream Stream(*Filename, std::ios::binary | std::ios::trunc);
+	if (!Stream)
+	{
+		return false;
+	}
+	Stream.write(reinterpret_cast<const char*>(Header.GetData()), Header.Num());
+
+	const char Padding[ColumnAlignment] = {};
+	for (const FColumn& Column : Columns)
+	{
+		Stream.write(reinterpret_cast<const char*>(Column.Values.GetData()), ColumnBytes);
+		Stream.write(Padding, AlignUp(ColumnBytes, ColumnAlignment) - ColumnBytes);
+	}
+
+	return (bool)Stream;
+}
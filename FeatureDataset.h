@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Element type of a dataset column; every type is 4 bytes
+ */
+enum class EDatasetColumnType : uint32
+{
+	Float32 = 0,
+	Int32 = 1
+};
+
+/**
+ * Columnar table of equal-length columns, written as one memory-mappable file
+ *
+ * File layout (little-endian):
+ *   Header, 64 bytes:
+ *     char   Magic[8]     "SBFEATS\0"
+ *     uint32 Version      1
+ *     uint32 NumColumns
+ *     uint64 NumRows
+ *     40 bytes reserved (zero)
+ *   Column table, 64 bytes per column:
+ *     char   Name[48]     Null-terminated
+ *     uint32 Type         EDatasetColumnType
+ *     uint32 Reserved
+ *     uint64 Offset       Byte offset of the column's data from the start of the file
+ *   Column data: NumRows 4-byte elements per column, each column 64-byte aligned
+ *
+ * A reader maps the file and views each column in place, e.g.
+ * numpy.frombuffer(mapped, dtype, NumRows, Offset).
+ */
+class FFeatureDataset
+{
+public:
+	static constexpr int32 MaxNameLength = 47;
+	static constexpr uint32 Version = 1;
+
+	/**
+	 * Add a column; all columns must be added before rows are appended
+	 * @return Column index
+	 */
+	int32 AddColumn(const FString& Name, EDatasetColumnType Type = EDatasetColumnType::Float32);
+
+	/** Reserve space for a number of rows in every column */
+	void Reserve(int32 NumRows);
+
+	/** Append to one column; each row must append one value to every column */
+	void AppendFloat(int32 Column, float Value) { AppendWord(Column, &Value); }
+	void AppendInt(int32 Column, int32 Value) { AppendWord(Column, &Value); }
+
+	/** Append consecutive values to consecutive float columns, e.g. a row of extracted features */
+	void AppendFloats(int32 FirstColumn, const float* Values, int32 Count);
+
+	int32 GetNumColumns() const { return Columns.Num(); }
+	int32 GetNumRows() const { return Columns.Num() > 0 ? Columns[0].Values.Num() : 0; }
+
+	/** Remove all rows, keeping the columns */
+	void ResetRows();
+
+	/**
+	 * Write the table
+	 * @return false if columns differ in length or the file could not be written
+	 */
+	bool Write(const FString& Filename) const;
+
+private:
+	struct FColumn
+	{
+		FString Name;
+		EDatasetColumnType Type;
+		TArray<uint32> Values;   // Raw 4-byte elements
+	};
+
+	TArray<FColumn> Columns;
+
+	void AppendWord(int32 Column, const void* Value)
+	{
+		uint32 Word;
+		FMemory::Memcpy(&Word, Value, sizeof(Word));
+		Columns[Column].Values.Add(Word);
+	}
+};
@@ -0,0 +1,360 @@
+#include "ForceField.h"
+#include <cmath>
+
+namespace
+{
+	// Distances below this are treated as "at the centre" to keep directions finite
+	constexpr float MinDistance = 1e-4f;
+
+	// Decorrelates the three turbulence components sampled from one noise field
+	constexpr float NoiseOffsetY = 31.416f;
+	constexpr float NoiseOffsetZ = 57.291f;
+
+	FForceField MakeField(EForceFieldType Type, const FVector3& Center, const FVector3& Direction, float Strength, float Radius)
+	{
+		FForceField Field;
+		Field.Type = Type;
+		Field.Center = Center;
+		Field.Direction = Direction.Normalize();
+		Field.Strength = Strength;
+		Field.Radius = FMath::Max(Radius, 0.0f);
+		Field.Turbulence = 0.0f;
+		Field.NoiseFrequency = 0.25f;
+		Field.NoiseSpeed = 0.5f;
+		Field.Duration = 0.0f;
+		Field.Age = 0.0f;
+		Field.bEnabled = true;
+		return Field;
+	}
+
+	bool IsExpired(const FForceField& Field)
+	{
+		return Field.Type == EForceFieldType::Explosion && Field.Age >= Field.Duration;
+	}
+}
+
+// ============================================================================
+// FForceFieldSystem Implementation
+// ============================================================================
+
+FForceFieldSystem::FForceFieldSystem(int32 InMaxFields, uint32 InNoiseSeed)
+	: MaxFields(FMath::Max(InMaxFields, 1))
+	, Noise(InNoiseSeed)
+	, Time(0.0f)
+	, AffectedBodies(0)
+{
+	Fields.Reserve(MaxFields);
+}
+
+int32 FForceFieldSystem::AddWind(const FVector3& Direction, float Strength, float Turbulence, float NoiseFrequency, float NoiseSpeed)
+{
+	FForceField Field = MakeField(EForceFieldType::Wind, FVector3(), Direction, Strength, 0.0f);
+	Field.Turbulence = FMath::Max(Turbulence, 0.0f);
+	Field.NoiseFrequency = NoiseFrequency;
+	Field.NoiseSpeed = NoiseSpeed;
+	return AddField(Field);
+}
+
+int32 FForceFieldSystem::AddVortex(const FVector3& Center, const FVector3& Axis, float Strength, float Radius)
+{
+	return AddField(MakeField(EForceFieldType::Vortex, Center, Axis, Strength, Radius));
+}
+
+int32 FForceFieldSystem::AddAttractor(const FVector3& Center, float Strength, float Radius)
+{
+	return AddField(MakeField(EForceFieldType::Attractor, Center, FVector3(), Strength, Radius));
+}
+
+int32 FForceFieldSystem::AddExplosion(const FVector3& Center, float Strength, float Radius, float Duration)
+{
+	FForceField Field = MakeField(EForceFieldType::Explosion, Center, FVector3(), Strength, Radius);
+	Field.Duration = FMath::Max(Duration, 1e-3f);
+	return AddField(Field);
+}
+
+int32 FForceFieldSystem::AddField(const FForceField& Field)
+{
+	// Spent explosions are recycled so repeated blasts do not fill the bank
+	for (int32 i = 0; i < Fields.Num(); ++i)
+	{
+		if (IsExpired(Fields[i]))
+		{
+			Fields[i] = Field;
+			return i;
+		}
+	}
+
+	if (Fields.Num() >= MaxFields)
+	{
+		return INDEX_NONE;
+	}
+	return Fields.Add(Field);
+}
+
+void FForceFieldSystem::SetBounds(int32 Index, const FVector3& Center, float Radius)
+{
+	if (Fields.IsValidIndex(Index))
+	{
+		Fields[Index].Center = Center;
+		Fields[Index].Radius = FMath::Max(Radius, 0.0f);
+	}
+}
+
+void FForceFieldSystem::SetStrength(int32 Index, float Strength)
+{
+	if (Fields.IsValidIndex(Index))
+	{
+		Fields[Index].Strength = Strength;
+	}
+}
+
+void FForceFieldSystem::SetEnabled(int32 Index, bool bEnabled)
+{
+	if (Fields.IsValidIndex(Index))
+	{
+		Fields[Index].bEnabled = bEnabled;
+	}
+}
+
+void FForceFieldSystem::RemoveField(int32 Index)
+{
+	if (Fields.IsValidIndex(Index))
+	{
+		Fields.RemoveAt(Index);
+	}
+}
+
+void FForceFieldSystem::Apply(const FPhysicsObjectArray& Bodies, float DeltaTime)
+{
+	AffectedBodies = 0;
+
+	bool bAnyActive = false;
+	for (const FForceField& Field : Fields)
+	{
+		bAnyActive |= Field.bEnabled && !IsExpired(Field);
+	}
+
+	if (bAnyActive && Bodies.Num() > 0)
+	{
+		Gather(Bodies);
+
+		for (const FForceField& Field : Fields)
+		{
+			if (!Field.bEnabled || IsExpired(Field))
+			{
+				continue;
+			}
+
+			const int32 Count = Cull(Field);
+			if (Count == 0)
+			{
+				continue;
+			}
+
+			switch (Field.Type)
+			{
+			case EForceFieldType::Wind:
+				ApplyWind(Field, Count);
+				break;
+			case EForceFieldType::Vortex:
+				ApplyVortex(Field, Count);
+				break;
+			case EForceFieldType::Attractor:
+				ApplyRadial(Count, -Field.Strength);
+				break;
+			case EForceFieldType::Explosion:
+				ApplyRadial(Count, Field.Strength * (1.0f - Field.Age / Field.Duration));
+				break;
+			}
+		}
+
+		for (int32 i = 0; i < Bodies.Num(); ++i)
+		{
+			if (AccX[i] != 0.0f || AccY[i] != 0.0f || AccZ[i] != 0.0f)
+			{
+				Bodies[i]->ApplyForce(FVector3(AccX[i], AccY[i], AccZ[i]) * Bodies[i]->GetMass());
+				++AffectedBodies;
+			}
+		}
+	}
+
+	Time += DeltaTime;
+	for (FForceField& Field : Fields)
+	{
+		Field.Age += DeltaTime;
+	}
+}
+
+void FForceFieldSystem::ReserveBodies(int32 NumBodies)
+{
+	for (TSandboxArray<float, ScratchCapacity>* Scratch : { &PosX, &PosY, &PosZ, &AccX, &AccY, &AccZ,
+		&LocalX, &LocalY, &LocalZ, &Weight, &NoiseX, &NoiseY, &NoiseZ, &NoiseW })
+	{
+		Scratch->Reserve(NumBodies + 1);
+	}
+	Culled.Reserve(NumBodies + 1);
+}
+
+void FForceFieldSystem::Gather(const FPhysicsObjectArray& Bodies)
+{
+	const int32 Count = Bodies.Num();
+
+	PosX.SetNum(Count);
+	PosY.SetNum(Count);
+	PosZ.SetNum(Count);
+	AccX.SetNum(Count);
+	AccY.SetNum(Count);
+	AccZ.SetNum(Count);
+
+	// One extra slot: culling writes each candidate before deciding whether to keep it
+	Culled.SetNum(Count + 1);
+	LocalX.SetNum(Count + 1);
+	LocalY.SetNum(Count + 1);
+	LocalZ.SetNum(Count + 1);
+	Weight.SetNum(Count + 1);
+	NoiseX.SetNum(Count + 1);
+	NoiseY.SetNum(Count + 1);
+	NoiseZ.SetNum(Count + 1);
+	NoiseW.SetNum(Count + 1);
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const FVector3& Position = Bodies[i]->GetPosition();
+		PosX[i] = Position.X;
+		PosY[i] = Position.Y;
+		PosZ[i] = Position.Z;
+	}
+
+	FMemory::Memzero(AccX.GetData(), sizeof(float) * Count);
+	FMemory::Memzero(AccY.GetData(), sizeof(float) * Count);
+	FMemory::Memzero(AccZ.GetData(), sizeof(float) * Count);
+}
+
+int32 FForceFieldSystem::Cull(const FForceField& Field)
+{
+	const int32 NumBodies = PosX.Num();
+	const float CX = Field.Center.X, CY = Field.Center.Y, CZ = Field.Center.Z;
+
+	if (Field.Radius <= 0.0f)
+	{
+		for (int32 i = 0; i < NumBodies; ++i)
+		{
+			Culled[i] = i;
+			LocalX[i] = PosX[i] - CX;
+			LocalY[i] = PosY[i] - CY;
+			LocalZ[i] = PosZ[i] - CZ;
+			Weight[i] = 1.0f;
+		}
+		return NumBodies;
+	}
+
+	// Branch-free compaction of bodies inside the bounding sphere
+	const float RadiusSq = Field.Radius * Field.Radius;
+	int32 Count = 0;
+	for (int32 i = 0; i < NumBodies; ++i)
+	{
+		const float DX = PosX[i] - CX;
+		const float DY = PosY[i] - CY;
+		const float DZ = PosZ[i] - CZ;
+		Culled[Count] = i;
+		LocalX[Count] = DX;
+		LocalY[Count] = DY;
+		LocalZ[Count] = DZ;
+		Count += (DX * DX + DY * DY + DZ * DZ) < RadiusSq;
+	}
+
+	// Linear falloff from the centre to the bounds
+	const float InvRadius = 1.0f / Field.Radius;
+	for (int32 k = 0; k < Count; ++k)
+	{
+		const float Distance = std::sqrt(LocalX[k] * LocalX[k] + LocalY[k] * LocalY[k] + LocalZ[k] * LocalZ[k]);
+		Weight[k] = FMath::Max(1.0f - Distance * InvRadius, 0.0f);
+	}
+	return Count;
+}
+
+void FForceFieldSystem::ApplyWind(const FForceField& Field, int32 Count)
+{
+	const float SteadyX = Field.Direction.X * Field.Strength;
+	const float SteadyY = Field.Direction.Y * Field.Strength;
+	const float SteadyZ = Field.Direction.Z * Field.Strength;
+
+	if (Field.Turbulence <= 0.0f)
+	{
+		for (int32 k = 0; k < Count; ++k)
+		{
+			const int32 i = Culled[k];
+			AccX[i] += SteadyX * Weight[k];
+			AccY[i] += SteadyY * Weight[k];
+			AccZ[i] += SteadyZ * Weight[k];
+		}
+		return;
+	}
+
+	// One 4D noise field (W = time) sampled at three offsets gives a turbulence vector
+	const float Frequency = Field.NoiseFrequency;
+	const float NoiseTime = Time * Field.NoiseSpeed;
+	for (int32 k = 0; k < Count; ++k)
+	{
+		LocalX[k] *= Frequency;
+		LocalY[k] *= Frequency;
+		LocalZ[k] *= Frequency;
+		NoiseW[k] = NoiseTime;
+	}
+	Noise.Evaluate4D(LocalX.GetData(), LocalY.GetData(), LocalZ.GetData(), NoiseW.GetData(), NoiseX.GetData(), Count);
+
+	for (int32 k = 0; k < Count; ++k)
+	{
+		NoiseW[k] = NoiseTime + NoiseOffsetY;
+	}
+	Noise.Evaluate4D(LocalX.GetData(), LocalY.GetData(), LocalZ.GetData(), NoiseW.GetData(), NoiseY.GetData(), Count);
+
+	for (int32 k = 0; k < Count; ++k)
+	{
+		NoiseW[k] = NoiseTime + NoiseOffsetZ;
+	}
+	Noise.Evaluate4D(LocalX.GetData(), LocalY.GetData(), LocalZ.GetData(), NoiseW.GetData(), NoiseZ.GetData(), Count);
+
+	const float Turbulence = Field.Turbulence;
+	for (int32 k = 0; k < Count; ++k)
+	{
+		const int32 i = Culled[k];
+		AccX[i] += (SteadyX + NoiseX[k] * Turbulence) * Weight[k];
+		AccY[i] += (SteadyY + NoiseY[k] * Turbulence) * Weight[k];
+		AccZ[i] += (SteadyZ + NoiseZ[k] * Turbulence) * Weight[k];
+	}
+}
+
+void FForceFieldSystem::ApplyVortex(const FForceField& Field, int32 Count)
+{
+	const float AX = Field.Direction.X, AY = Field.Direction.Y, AZ = Field.Direction.Z;
+
+	for (int32 k = 0; k < Count; ++k)
+	{
+		// Tangent = Axis x Offset, normalised by the distance from the axis
+		const float TX = AY * LocalZ[k] - AZ * LocalY[k];
+		const float TY = AZ * LocalX[k] - AX * LocalZ[k];
+		const float TZ = AX * LocalY[k] - AY * LocalX[k];
+		const float Length = std::sqrt(TX * TX + TY * TY + TZ * TZ);
+		const float Scale = Field.Strength * Weight[k] / FMath::Max(Length, MinDistance);
+
+		const int32 i = Culled[k];
+		AccX[i] += TX * Scale;
+		AccY[i] += TY * Scale;
+		AccZ[i] += TZ * Scale;
+	}
+}
+
+void FForceFieldSystem::ApplyRadial(int32 Count, float Strength)
+{
+	for (int32 k = 0; k < Count; ++k)
+	{
+		const float Distance = std::sqrt(LocalX[k] * LocalX[k] + LocalY[k] * LocalY[k] + LocalZ[k] * LocalZ[k]);
+		const float Scale = Strength * Weight[k] / FMath::Max(Distance, MinDistance);
+
+		const int32 i = Culled[k];
+		AccX[i] += LocalX[k] * Scale;
+		AccY[i] += LocalY[k] * Scale;
+		AccZ[i] += LocalZ[k] * Scale;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Physics/PhysicsCore.h"
+#include "Procedural/SimplexNoise.h"
+#include "SandboxArchive.h"
+
+/**
+ * Force field kinds
+ */
+enum class EForceFieldType : uint8
+{
+	Wind,        // Constant direction plus simplex turbulence
+	Vortex,      // Swirl around an axis through the centre
+	Attractor,   // Pull towards the centre (negative strength repels)
+	Explosion    // Radial push that decays over its duration
+};
+
+/**
+ * One procedural force field
+ * Strengths are accelerations (like gravity), so light and heavy bodies react alike.
+ * Plain data: the field bank is one contiguous array and snapshots copy it as is.
+ */
+struct FForceField
+{
+	EForceFieldType Type;
+	FVector3 Center;
+	FVector3 Direction;    // Wind direction or vortex axis (unit length)
+	float Strength;        // m/s^2 at the centre, falling off linearly to zero at Radius
+	float Radius;          // Bounds; bodies further away are culled (0 = unbounded, no falloff)
+	float Turbulence;      // Wind: noise acceleration added to Strength (m/s^2)
+	float NoiseFrequency;  // Wind: spatial frequency of the turbulence
+	float NoiseSpeed;      // Wind: rate at which the turbulence evolves
+	float Duration;        // Explosion: seconds until the blast has decayed
+	float Age;             // Seconds since the field was added
+	bool bEnabled;
+};
+
+/**
+ * Bank of force fields applied to all bodies in one pass per physics step
+ *
+ * Body positions are gathered once into structure-of-arrays form; each field
+ * culls against its bounds, then runs a branch-free kernel over the compact
+ * set of bodies inside it. Wind turbulence uses batched simplex noise. The
+ * accumulated accelerations are applied as forces before the world steps.
+ */
+class FForceFieldSystem
+{
+public:
+	FForceFieldSystem(int32 InMaxFields = 64, uint32 InNoiseSeed = 7919);
+
+	/**
+	 * @return Field index, or INDEX_NONE if the bank is full
+	 */
+	int32 AddWind(const FVector3& Direction, float Strength, float Turbulence = 0.0f, float NoiseFrequency = 0.25f, float NoiseSpeed = 0.5f);
+	int32 AddVortex(const FVector3& Center, const FVector3& Axis, float Strength, float Radius);
+	int32 AddAttractor(const FVector3& Center, float Strength, float Radius = 0.0f);
+	int32 AddExplosion(const FVector3& Center, float Strength, float Radius, float Duration = 0.1f);
+	int32 AddField(const FForceField& Field);
+
+	/** Limit a field to a sphere (Radius 0 = unbounded) */
+	void SetBounds(int32 Index, const FVector3& Center, float Radius);
+	void SetStrength(int32 Index, float Strength);
+	void SetEnabled(int32 Index, bool bEnabled);
+
+	/** Removing a field shifts the indices of later fields */
+	void RemoveField(int32 Index);
+	void Clear() { Fields.Reset(); }
+
+	int32 Num() const { return Fields.Num(); }
+	const FForceField& GetField(int32 Index) const { return Fields[Index]; }
+
+	/**
+	 * Evaluate every enabled field and apply the resulting forces
+	 * Call before FPhysicsWorld::SimulateStep with the same time step
+	 */
+	void Apply(const FPhysicsObjectArray& Bodies, float DeltaTime);
+
+	/** Size the per-step scratch for NumBodies so Apply does not allocate */
+	void ReserveBodies(int32 NumBodies);
+
+	/** Bodies that fell inside at least one field's bounds in the last Apply */
+	int32 GetAffectedBodyCount() const { return AffectedBodies; }
+
+	void Serialize(FSandboxArchive& Ar)
+	{
+		uint32 Seed = Noise.GetSeed();
+		Ar << Seed << Time << Fields;
+		if (Ar.IsLoading())
+		{
+			Noise.SetSeed(Seed);
+		}
+	}
+
+private:
+	TArray<FForceField> Fields;
+	int32 MaxFields;
+	FSimplexNoise Noise;
+	float Time;
+	int32 AffectedBodies;
+
+	// Per-step scratch (structure of arrays), reused across steps; culling needs one slot more than there are bodies
+	static constexpr int32 ScratchCapacity = FSandboxCapacity::MaxBodies + 1;
+	TSandboxArray<float, ScratchCapacity> PosX, PosY, PosZ;
+	TSandboxArray<float, ScratchCapacity> AccX, AccY, AccZ;
+	TSandboxArray<int32, ScratchCapacity> Culled;
+	TSandboxArray<float, ScratchCapacity> LocalX, LocalY, LocalZ, Weight;
+	TSandboxArray<float, ScratchCapacity> NoiseX, NoiseY, NoiseZ, NoiseW;
+
+	void Gather(const FPhysicsObjectArray& Bodies);
+	int32 Cull(const FForceField& Field);
+	void ApplyWind(const FForceField& Field, int32 Count);
+	void ApplyVortex(const FForceField& Field, int32 Count);
+	void ApplyRadial(int32 Count, float Strength);
+};
@@ -0,0 +1,391 @@
+#include "GoldenRender.h"
+#include "Offline/AudioFeatures.h"
+#include "Offline/WavWriter.h"
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	// Floor for level ratios, so silent renders compare as equal rather than -inf
+	constexpr float SilenceRms = 1e-9f;
+
+	inline float ToDecibels(float Ratio)
+	{
+		return 20.0f * std::log10(FMath::Max(Ratio, 1e-12f));
+	}
+
+	float ComputeRms(const float* Samples, int32 Count)
+	{
+		double SumSquares = 0.0;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			SumSquares += Samples[i] * Samples[i];
+		}
+		return Count > 0 ? (float)std::sqrt(SumSquares / Count) : 0.0f;
+	}
+
+	/**
+	 * Read a 32-bit float WAV file as written by FWavWriter::WriteFloat32
+	 * Chunks other than fmt and data are skipped
+	 */
+	bool ReadFloat32Wav(const FString& Filename, TArray<float>& OutSamples, int32& OutNumChannels, int32& OutSampleRate)
+	{
+		std::ifstream Stream(*Filename, std::ios::binary);
+		char Riff[12];
+		if (!Stream.read(Riff, sizeof(Riff)) || FMemory::Memcmp(Riff, "RIFF", 4) != 0 || FMemory::Memcmp(Riff + 8, "WAVE", 4) != 0)
+		{
+			return false;
+		}
+
+		bool bFormatValid = false;
+		char ChunkHeader[8];
+		while (Stream.read(ChunkHeader, sizeof(ChunkHeader)))
+		{
+			uint32 ChunkBytes;
+			FMemory::Memcpy(&ChunkBytes, ChunkHeader + 4, sizeof(ChunkBytes));
+
+			if (FMemory::Memcmp(ChunkHeader, "fmt ", 4) == 0 && ChunkBytes >= 16)
+			{
+				uint8 Format[16];
+				Stream.read(reinterpret_cast<char*>(Format), sizeof(Format));
+				Stream.seekg(ChunkBytes - sizeof(Format), std::ios::cur);
+
+				uint16 FormatTag, NumChannels, BitsPerSample;
+				uint32 SampleRate;
+				FMemory::Memcpy(&FormatTag, Format, 2);
+				FMemory::Memcpy(&NumChannels, Format + 2, 2);
+				FMemory::Memcpy(&SampleRate, Format + 4, 4);
+				FMemory::Memcpy(&BitsPerSample, Format + 14, 2);
+				bFormatValid = FormatTag == 3 && BitsPerSample == 32 && NumChannels > 0;
+				OutNumChannels = NumChannels;
+				OutSampleRate = (int32)SampleRate;
+			}
+			else if (FMemory::Memcmp(ChunkHeader, "data", 4) == 0)
+			{
+				if (!bFormatValid)
+				{
+					return false;
+				}
+				OutSamples.SetNum((int32)(ChunkBytes / sizeof(float)));
+				return (bool)Stream.read(reinterpret_cast<char*>(OutSamples.GetData()), OutSamples.Num() * sizeof(float));
+			}
+			else
+			{
+				Stream.seekg(ChunkBytes + (ChunkBytes & 1), std::ios::cur);
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Mean mel-cepstral distortion between two renders, in dB
+	 * Coefficients 1-12 of each analysis frame; c0 (overall level) is judged separately
+	 */
+	float ComputeCepstralDistance(const TArray<float>& Golden, const TArray<float>& Test, float SampleRate)
+	{
+		FAudioFeatureExtractor GoldenExtractor(SampleRate);
+		FAudioFeatureExtractor TestExtractor(SampleRate);
+		TArray<float> GoldenFeatures;
+		TArray<float> TestFeatures;
+		GoldenExtractor.Process(Golden.GetData(), 2, Golden.Num() / 2, GoldenFeatures);
+		TestExtractor.Process(Test.GetData(), 2, Test.Num() / 2, TestFeatures);
+
+		const int32 Stride = FAudioFeatureExtractor::NumFeatures;
+		const int32 NumFrames = FMath::Min(GoldenFeatures.Num(), TestFeatures.Num()) / Stride;
+		const float Scale = 10.0f / std::log(10.0f);
+
+		double Total = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float* GoldenRow = GoldenFeatures.GetData() + Frame * Stride + (int32)EAudioFeature::Mfcc0;
+			const float* TestRow = TestFeatures.GetData() + Frame * Stride + (int32)EAudioFeature::Mfcc0;
+			float SumSquares = 0.0f;
+			for (int32 k = 1; k < FAudioFeatureExtractor::NumMfcc; ++k)
+			{
+				const float Difference = GoldenRow[k] - TestRow[k];
+				SumSquares += Difference * Difference;
+			}
+			Total += Scale * std::sqrt(2.0f * SumSquares);
+		}
+		return NumFrames > 0 ? (float)(Total / NumFrames) : 0.0f;
+	}
+
+	/**
+	 * Each wake-up schedules an impulse for the frame the script woke on and a parameter change
+	 * for a frame already rendered; both must fire on the wake frame without splitting backwards.
+	 * Finishes within the first second, before the forked mode snapshots (scripts are not captured).
+	 */
+	FSceneScript ScheduleFromScript(FSandboxManager& Sandbox)
+	{
+		FSceneTimeline* Events = Sandbox.GetTimeline();
+		for (int32 i = 0; i < 8; ++i)
+		{
+			co_await Frames(2400 + 37 * i);
+			const int64 Now = Sandbox.GetScriptRunner()->GetCurrentFrame();
+			Events->AddImpulse(Now, 0, FVector3(0.0f, 2.0f, 0.0f));
+			Events->AddParameterChange(Now - 100, ETimelineParameter::FrequencyMax, 1500.0f + 100.0f * i);
+		}
+	}
+}
+
+const TCHAR* GetGoldenRenderModeName(EGoldenRenderMode Mode)
+{
+	switch (Mode)
+	{
+	case EGoldenRenderMode::Reference:         return TEXT("reference");
+	case EGoldenRenderMode::VariableCallbacks: return TEXT("variable-callbacks");
+	case EGoldenRenderMode::Forked:            return TEXT("forked");
+	case EGoldenRenderMode::LowLatency:        return TEXT("low-latency");
+	default:                                   return TEXT("unknown");
+	}
+}
+
+// ============================================================================
+// FGoldenHarness Implementation
+// ============================================================================
+
+FGoldenHarness::FGoldenHarness()
+{
+	// Control-rate parameters move procedural events by up to one control period,
+	// so the waveform differs; level and spectrum must still match
+	Tolerances[(int32)EGoldenRenderMode::LowLatency] = FGoldenTolerance(2.0f, 6.0f, 1.0f, 3.0f);
+}
+
+void FGoldenHarness::AddDefaultScenes()
+{
+	FGoldenScene Drop;
+	Drop.Name = TEXT("drop");
+	Drop.Build = [](FSandboxManager& Sandbox)
+	{
+		Sandbox.EnableProceduralGeneration(false);
+		auto Sphere = MakeShared<FPhysicsSphere>(0.5f, 2.0f);
+		Sphere->SetPosition(FVector3(0, 3.0f, 0));
+		Sandbox.AddPhysicsObject(Sphere);
+	};
+	AddScene(Drop);
+
+	FGoldenScene Stack;
+	Stack.Name = TEXT("stack");
+	Stack.Build = [](FSandboxManager& Sandbox)
+	{
+		Sandbox.EnableProceduralGeneration(false);
+		for (int32 i = 0; i < 6; ++i)
+		{
+			auto Sphere = MakeShared<FPhysicsSphere>(0.2f + 0.05f * i, 1.0f + i);
+			Sphere->SetPosition(FVector3(i * 0.3f, 1.0f + i * 0.7f, 0));
+			Sandbox.AddPhysicsObject(Sphere);
+		}
+	};
+	AddScene(Stack);
+
+	FGoldenScene Procedural;
+	Procedural.Name = TEXT("procedural");
+	Procedural.Build = [](FSandboxManager& Sandbox)
+	{
+		Sandbox.EnablePhysicsAudio(false);
+		Sandbox.GetProceduralController()->SetSeed(7);
+	};
+	AddScene(Procedural);
+
+	FGoldenScene Timeline;
+	Timeline.Name = TEXT("timeline");
+	Timeline.Seconds = 3.0f;
+	Timeline.Build = [](FSandboxManager& Sandbox)
+	{
+		FSceneTimeline* Events = Sandbox.GetTimeline();
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Events->AddSpawnSphere(FSceneTimeline::SecondsToFrames(0.5f * i + 0.1f, 48000.0f), FVector3(i * 0.4f, 2.0f, 0), 0.3f, 1.5f);
+		}
+		Events->AddParameterChange(FSceneTimeline::SecondsToFrames(1.5f, 48000.0f), ETimelineParameter::MasterVolume, 0.5f);
+		Events->AddParameterChange(FSceneTimeline::SecondsToFrames(2.0f, 48000.0f), ETimelineParameter::SimulationSpeed, 0.5f);
+	};
+	AddScene(Timeline);
+
+	FGoldenScene Scripted;
+	Scripted.Name = TEXT("scripted");
+	Scripted.Build = [](FSandboxManager& Sandbox)
+	{
+		Sandbox.GetProceduralController()->SetSeed(11);
+		auto Sphere = MakeShared<FPhysicsSphere>(0.4f, 1.5f);
+		Sphere->SetPosition(FVector3(0, 1.0f, 0));
+		Sandbox.AddPhysicsObject(Sphere);
+		Sandbox.GetScriptRunner()->SetGranularity(FSceneScriptRunner::EResumeGranularity::Sample);
+		Sandbox.StartScript(ScheduleFromScript(Sandbox));
+	};
+	AddScene(Scripted);
+}
+
+int32 FGoldenHarness::Run(const FString& GoldenDirectory, bool bUpdateGoldens)
+{
+	Results.Reset();
+	const ESimdLevel PreviousLevel = GetSimdLevel();
+	int32 NumFailed = 0;
+
+	for (const FGoldenScene& Scene : Scenes)
+	{
+		const FString GoldenPath = FString::Printf(TEXT("%s/%s.wav"), *GoldenDirectory, *Scene.Name);
+
+		TArray<float> Golden;
+		FString UpdateMessage;
+		if (bUpdateGoldens)
+		{
+			// Goldens come from the scalar path, which every vector level must reproduce
+			SetSimdLevel(ESimdLevel::Scalar);
+			Render(Scene, EGoldenRenderMode::Reference, Golden);
+			UpdateMessage = FWavWriter::WriteFloat32(GoldenPath, Golden, 2, (int32)Scene.SampleRate)
+				? FString(TEXT("golden written"))
+				: FString::Printf(TEXT("cannot write %s"), *GoldenPath);
+		}
+
+		int32 NumChannels = 0;
+		int32 SampleRate = 0;
+		const bool bGoldenRead = ReadFloat32Wav(GoldenPath, Golden, NumChannels, SampleRate)
+			&& NumChannels == 2 && SampleRate == (int32)Scene.SampleRate;
+
+		for (int32 Level = 0; Level <= (int32)GetSupportedSimdLevel(); ++Level)
+		{
+			SetSimdLevel((ESimdLevel)Level);
+
+			for (int32 Mode = 0; Mode < (int32)EGoldenRenderMode::Count; ++Mode)
+			{
+				FGoldenResult Result;
+				Result.Scene = Scene.Name;
+				Result.Mode = (EGoldenRenderMode)Mode;
+				Result.SimdLevel = (ESimdLevel)Level;
+				Result.bPassed = false;
+				Result.MaxAbsError = 0.0f;
+				Result.RmsErrorDb = 0.0f;
+				Result.LevelDifferenceDb = 0.0f;
+				Result.CepstralDistance = 0.0f;
+
+				if (!bGoldenRead)
+				{
+					Result.Message = UpdateMessage.IsEmpty()
+						? FString::Printf(TEXT("no usable golden at %s"), *GoldenPath)
+						: UpdateMessage;
+				}
+				else
+				{
+					TArray<float> Test;
+					Render(Scene, Result.Mode, Test);
+					Result.bPassed = Compare(Golden, Test, Scene.SampleRate, Tolerances[Mode], Result);
+					if (Result.bPassed && Mode == (int32)EGoldenRenderMode::Reference && Level == 0)
+					{
+						Result.Message = UpdateMessage;
+					}
+				}
+
+				NumFailed += Result.bPassed ? 0 : 1;
+				Results.Add(MoveTemp(Result));
+			}
+		}
+	}
+
+	SetSimdLevel(PreviousLevel);
+	return NumFailed;
+}
+
+void FGoldenHarness::Render(const FGoldenScene& Scene, EGoldenRenderMode Mode, TArray<float>& OutAudio)
+{
+	TUniquePtr<FSandboxManager> Sandbox = MakeUnique<FSandboxManager>(Scene.SampleRate, Scene.BufferSize);
+	if (Scene.Build)
+	{
+		Scene.Build(*Sandbox);
+	}
+	if (Mode == EGoldenRenderMode::LowLatency)
+	{
+		Sandbox->EnableLowLatencyMode(true);
+	}
+
+	const float BlockTime = Scene.BufferSize / Scene.SampleRate;
+	const int32 NumBlocks = FMath::CeilToInt(Scene.Seconds / BlockTime);
+	const int32 TotalFrames = NumBlocks * Scene.BufferSize;
+	OutAudio.SetNum(TotalFrames * 2);
+
+	if (Mode == EGoldenRenderMode::VariableCallbacks)
+	{
+		// Callback sizes from 1 frame to two blocks, the same every run
+		uint32 State = 0x9E3779B9u;
+		int32 Written = 0;
+		while (Written < TotalFrames)
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			const int32 NumFrames = FMath::Min(1 + (int32)(State % (uint32)(Scene.BufferSize * 2)), TotalFrames - Written);
+			Written += Sandbox->Update(OutAudio.GetData() + Written * 2, NumFrames);
+		}
+		return;
+	}
+
+	TArray<float> Block;
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		if (Mode == EGoldenRenderMode::Forked && BlockIndex == NumBlocks / 2)
+		{
+			FSandboxSnapshot Snapshot;
+			Sandbox->CaptureSnapshot(Snapshot);
+			Sandbox = FSandboxManager::Fork(Snapshot);
+			if (!Sandbox.IsValid())
+			{
+				// Leave the rest silent so the comparison fails
+				FMemory::Memzero(OutAudio.GetData() + BlockIndex * Scene.BufferSize * 2, sizeof(float) * (NumBlocks - BlockIndex) * Scene.BufferSize * 2);
+				return;
+			}
+		}
+
+		Sandbox->Update(BlockTime, Block);
+		FMemory::Memcpy(OutAudio.GetData() + BlockIndex * Scene.BufferSize * 2, Block.GetData(), sizeof(float) * Scene.BufferSize * 2);
+	}
+}
+
+bool FGoldenHarness::Compare(const TArray<float>& Golden, const TArray<float>& Test, float SampleRate,
+	const FGoldenTolerance& Tolerance, FGoldenResult& OutResult)
+{
+	if (Golden.Num() != Test.Num())
+	{
+		OutResult.Message = FString::Printf(TEXT("length %d, golden has %d"), Test.Num() / 2, Golden.Num() / 2);
+		return false;
+	}
+
+	float MaxAbsError = 0.0f;
+	double ErrorSquares = 0.0;
+	for (int32 i = 0; i < Golden.Num(); ++i)
+	{
+		const float Difference = Test[i] - Golden[i];
+		MaxAbsError = FMath::Max(MaxAbsError, FMath::Abs(Difference));
+		ErrorSquares += Difference * Difference;
+	}
+
+	const float GoldenRms = FMath::Max(ComputeRms(Golden.GetData(), Golden.Num()), SilenceRms);
+	const float TestRms = FMath::Max(ComputeRms(Test.GetData(), Test.Num()), SilenceRms);
+	const float ErrorRms = Golden.Num() > 0 ? (float)std::sqrt(ErrorSquares / Golden.Num()) : 0.0f;
+
+	OutResult.MaxAbsError = MaxAbsError;
+	OutResult.RmsErrorDb = ErrorRms > 0.0f ? ToDecibels(ErrorRms / GoldenRms) : -240.0f;
+	OutResult.LevelDifferenceDb = FMath::Abs(ToDecibels(TestRms / GoldenRms));
+	OutResult.CepstralDistance = ComputeCepstralDistance(Golden, Test, SampleRate);
+
+	if (OutResult.MaxAbsError > Tolerance.MaxAbsError)
+	{
+		OutResult.Message = FString::Printf(TEXT("max error %g > %g"), OutResult.MaxAbsError, Tolerance.MaxAbsError);
+	}
+	else if (OutResult.RmsErrorDb > Tolerance.MaxRmsErrorDb)
+	{
+		OutResult.Message = FString::Printf(TEXT("error %.1f dB > %.1f dB"), OutResult.RmsErrorDb, Tolerance.MaxRmsErrorDb);
+	}
+	else if (OutResult.LevelDifferenceDb > Tolerance.MaxLevelDifferenceDb)
+	{
+		OutResult.Message = FString::Printf(TEXT("level differs by %.3f dB > %.3f dB"), OutResult.LevelDifferenceDb, Tolerance.MaxLevelDifferenceDb);
+	}
+	else if (OutResult.CepstralDistance > Tolerance.MaxCepstralDistance)
+	{
+		OutResult.Message = FString::Printf(TEXT("cepstral distance %.3f dB > %.3f dB"), OutResult.CepstralDistance, Tolerance.MaxCepstralDistance);
+	}
+	else
+	{
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SandboxManager.h"
+#include "SimdLevel.h"
+
+/**
+ * Ways of rendering the same scene; every mode must stay within tolerance of the reference
+ */
+enum class EGoldenRenderMode : uint8
+{
+	Reference,           // Update(DeltaTime, Buffer) once per block, default settings
+	VariableCallbacks,   // Update(OutAudio, NumFrames) with seeded random callback sizes
+	Forked,              // Half rendered, snapshotted, and finished on a fork
+	LowLatency,          // Control-rate procedural parameters
+	Count
+};
+
+/** Lowercase mode name for reports */
+const TCHAR* GetGoldenRenderModeName(EGoldenRenderMode Mode);
+
+/**
+ * A scene in the catalog
+ */
+struct FGoldenScene
+{
+	FString Name;                 // Also the golden file name: <Name>.wav
+	float SampleRate;
+	int32 BufferSize;
+	float Seconds;
+	TFunction<void(FSandboxManager&)> Build;
+
+	FGoldenScene()
+		: SampleRate(48000.0f)
+		, BufferSize(512)
+		, Seconds(2.0f)
+	{
+	}
+};
+
+/**
+ * Accepted difference from the golden render
+ */
+struct FGoldenTolerance
+{
+	float MaxAbsError;           // Largest sample difference
+	float MaxRmsErrorDb;         // RMS of the difference, in dB relative to the golden's RMS
+	float MaxLevelDifferenceDb;  // Difference of the two renders' RMS levels
+	float MaxCepstralDistance;   // Mean mel-cepstral distortion over analysis frames (dB)
+
+	FGoldenTolerance(float InMaxAbsError = 1e-6f, float InMaxRmsErrorDb = -120.0f,
+		float InMaxLevelDifferenceDb = 0.001f, float InMaxCepstralDistance = 0.01f)
+		: MaxAbsError(InMaxAbsError)
+		, MaxRmsErrorDb(InMaxRmsErrorDb)
+		, MaxLevelDifferenceDb(InMaxLevelDifferenceDb)
+		, MaxCepstralDistance(InMaxCepstralDistance)
+	{
+	}
+};
+
+/**
+ * Measured difference of one scene in one mode at one SIMD level
+ */
+struct FGoldenResult
+{
+	FString Scene;
+	EGoldenRenderMode Mode;
+	ESimdLevel SimdLevel;
+	bool bPassed;
+	float MaxAbsError;
+	float RmsErrorDb;
+	float LevelDifferenceDb;
+	float CepstralDistance;
+	FString Message;   // Why the comparison failed, or that the golden was written
+};
+
+/**
+ * Golden-render regression harness
+ *
+ * Renders a catalog of scenes in every render mode, at every SIMD level the
+ * build supports, and compares each render against the stored golden (the
+ * scalar reference render of a trusted build) with per-mode tolerances.
+ * Modes that should be bit-exact default to tolerances at the float noise
+ * floor; modes that change the signal on purpose, like low-latency control
+ * rate, are judged on level and spectrum instead.
+ *
+ * Goldens are 32-bit float WAV files, one per scene, and can be listened to.
+ */
+class FGoldenHarness
+{
+public:
+	FGoldenHarness();
+
+	void AddScene(const FGoldenScene& Scene) { Scenes.Add(Scene); }
+	const TArray<FGoldenScene>& GetScenes() const { return Scenes; }
+
+	/**
+	 * Impacts, stacked bodies, procedural voice only, a timeline of spawns and parameter changes,
+	 * and a script scheduling events for its wake frame and for frames already rendered
+	 */
+	void AddDefaultScenes();
+
+	void SetTolerance(EGoldenRenderMode Mode, const FGoldenTolerance& Tolerance) { Tolerances[(int32)Mode] = Tolerance; }
+	const FGoldenTolerance& GetTolerance(EGoldenRenderMode Mode) const { return Tolerances[(int32)Mode]; }
+
+	/**
+	 * Render and compare every scene in every mode at every supported SIMD level
+	 * The process-wide SIMD level is restored afterwards
+	 * @param GoldenDirectory Holds <Scene>.wav
+	 * @param bUpdateGoldens Write the reference renders as the new goldens before comparing
+	 * @return Number of failed comparisons
+	 */
+	int32 Run(const FString& GoldenDirectory, bool bUpdateGoldens = false);
+
+	const TArray<FGoldenResult>& GetResults() const { return Results; }
+
+	/** Render a scene in one mode as interleaved stereo */
+	static void Render(const FGoldenScene& Scene, EGoldenRenderMode Mode, TArray<float>& OutAudio);
+
+	/**
+	 * Measure the difference between two stereo renders
+	 * @return true if within tolerance
+	 */
+	static bool Compare(const TArray<float>& Golden, const TArray<float>& Test, float SampleRate,
+		const FGoldenTolerance& Tolerance, FGoldenResult& OutResult);
+
+private:
+	TArray<FGoldenScene> Scenes;
+	FGoldenTolerance Tolerances[(int32)EGoldenRenderMode::Count];
+	TArray<FGoldenResult> Results;
+};
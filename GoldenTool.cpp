@@ -0,0 +1,113 @@
+/**
+ * Audio Sandbox - Golden Render Check
+ * Renders the reference scene catalog in every render mode and SIMD level and compares against stored goldens
+ *
+ * Usage:
+ *   AudioSandboxGolden <golden-directory>            Compare; exit code 1 on any failure
+ *   AudioSandboxGolden <golden-directory> --update   Re-record goldens from the reference path, then compare
+ *   AudioSandboxGolden --determinism [max-threads]   Check the catalog renders bit-identically across thread counts and SIMD levels,
+ *                                                    and that extra block splits leave the procedural voice unchanged
+ */
+
+#include "Offline/DeterminismCheck.h"
+#include "Offline/GoldenRender.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+	int RunDeterminismCheck(int32 MaxThreads)
+	{
+		FGoldenHarness Catalog;
+		Catalog.AddDefaultScenes();
+
+		FDeterminismChecker Checker;
+		Checker.SetMaxThreads(MaxThreads);
+		for (const FGoldenScene& Scene : Catalog.GetScenes())
+		{
+			Checker.AddScene(Scene);
+		}
+		const int32 NumDiverged = Checker.Run();
+
+		std::cout << std::left << std::setw(12) << "Scene" << std::setw(10) << "Threads"
+			<< std::setw(10) << "SIMD" << std::setw(10) << "Instance" << std::setw(8) << "Splits" << "Result" << std::endl;
+
+		for (const FDeterminismResult& Result : Checker.GetResults())
+		{
+			// Matching instances are summarized per configuration; divergent ones are listed individually
+			if (Result.bMatches && Result.Instance > 0)
+			{
+				continue;
+			}
+			std::cout << std::left << std::setw(12) << *Result.Scene << std::setw(10) << Result.NumThreads
+				<< std::setw(10) << GetSimdLevelName(Result.SimdLevel) << std::setw(10) << Result.Instance << std::setw(8);
+			if (Result.SplitPeriod > 0)
+			{
+				std::cout << Result.SplitPeriod;
+			}
+			else
+			{
+				std::cout << "-";
+			}
+			if (Result.bMatches)
+			{
+				std::cout << "match";
+			}
+			else
+			{
+				std::cout << "DIVERGED at block " << Result.DivergentBlock << " (frame " << Result.DivergentFrame
+					<< "), stage " << *Result.Stage;
+			}
+			std::cout << std::endl;
+		}
+
+		std::cout << std::endl << Checker.GetResults().Num() - NumDiverged << "/" << Checker.GetResults().Num()
+			<< " instances matched the reference" << std::endl;
+		return NumDiverged > 0 ? 1 : 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: AudioSandboxGolden <golden-directory> [--update]" << std::endl;
+		std::cout << "       AudioSandboxGolden --determinism [max-threads]" << std::endl;
+		return 2;
+	}
+
+	if (std::strcmp(argv[1], "--determinism") == 0)
+	{
+		return RunDeterminismCheck(argc > 2 ? std::atoi(argv[2]) : 0);
+	}
+
+	const FString Directory(argv[1]);
+	const bool bUpdate = argc > 2 && std::strcmp(argv[2], "--update") == 0;
+
+	FGoldenHarness Harness;
+	Harness.AddDefaultScenes();
+	const int32 NumFailed = Harness.Run(Directory, bUpdate);
+
+	std::cout << std::left << std::setw(12) << "Scene" << std::setw(20) << "Mode" << std::setw(10) << "SIMD"
+		<< std::setw(12) << "Max error" << std::setw(12) << "Error dB"
+		<< std::setw(12) << "Level dB" << std::setw(12) << "MCD dB" << "Result" << std::endl;
+
+	for (const FGoldenResult& Result : Harness.GetResults())
+	{
+		std::cout << std::left << std::setw(12) << *Result.Scene << std::setw(20) << GetGoldenRenderModeName(Result.Mode)
+			<< std::setw(10) << GetSimdLevelName(Result.SimdLevel)
+			<< std::setw(12) << Result.MaxAbsError << std::setw(12) << Result.RmsErrorDb
+			<< std::setw(12) << Result.LevelDifferenceDb << std::setw(12) << Result.CepstralDistance
+			<< (Result.bPassed ? "pass" : "FAIL");
+		if (!Result.Message.IsEmpty())
+		{
+			std::cout << "  " << *Result.Message;
+		}
+		std::cout << std::endl;
+	}
+
+	std::cout << std::endl << Harness.GetResults().Num() - NumFailed << "/" << Harness.GetResults().Num() << " passed" << std::endl;
+	return NumFailed > 0 ? 1 : 0;
+}
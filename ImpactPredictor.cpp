@@ -0,0 +1,358 @@
+#include "ImpactPredictor.h"
+#include "SimdLevel.h"
+#include <cmath>
+#include <fstream>
+
+#if SANDBOX_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr char WeightsMagic[8] = { 'S', 'B', 'M', 'L', 'P', '\0', '\0', '\0' };
+
+	// Events evaluated together, one per SIMD lane across two vectors
+	constexpr int32 Lanes = 8;
+
+	// Impacts converted per Predict call in PredictImpacts
+	constexpr int32 ImpactChunk = 64;
+
+	template<typename T>
+	bool ReadValue(const uint8* Data, int32 NumBytes, int32& Position, T& OutValue)
+	{
+		if (Position + (int32)sizeof(T) > NumBytes)
+		{
+			return false;
+		}
+		FMemory::Memcpy(&OutValue, Data + Position, sizeof(T));
+		Position += sizeof(T);
+		return true;
+	}
+}
+
+// ============================================================================
+// FImpactPredictor Implementation
+// ============================================================================
+
+FImpactPredictor::FImpactPredictor()
+	: WeightMemory(EMemoryTag::Integration)
+{
+}
+
+bool FImpactPredictor::LoadFromFile(const FString& Filename, FString& OutError)
+{
+	std::ifstream Stream(*Filename, std::ios::binary);
+	if (!Stream)
+	{
+		OutError = FString::Printf(TEXT("cannot open '%s'"), *Filename);
+		return false;
+	}
+
+	Stream.seekg(0, std::ios::end);
+	const std::streamoff Size = Stream.tellg();
+	Stream.seekg(0, std::ios::beg);
+
+	TArray<uint8> Bytes;
+	Bytes.SetNum((int32)FMath::Max<std::streamoff>(Size, 0));
+	Stream.read(reinterpret_cast<char*>(Bytes.GetData()), Bytes.Num());
+	if (!Stream)
+	{
+		OutError = FString::Printf(TEXT("cannot read '%s'"), *Filename);
+		return false;
+	}
+
+	return LoadFromMemory(Bytes.GetData(), Bytes.Num(), OutError);
+}
+
+bool FImpactPredictor::LoadFromMemory(const uint8* Data, int32 NumBytes, FString& OutError)
+{
+	int32 Position = 0;
+	char Magic[8];
+	uint32 FileVersion = 0;
+	uint32 NumLayers = 0;
+	if (NumBytes < (int32)sizeof(Magic) || FMemory::Memcmp(Data, WeightsMagic, sizeof(Magic)) != 0)
+	{
+		OutError = TEXT("not a weights file");
+		return false;
+	}
+	Position += sizeof(Magic);
+
+	if (!ReadValue(Data, NumBytes, Position, FileVersion) || FileVersion != Version)
+	{
+		OutError = TEXT("unsupported weights version");
+		return false;
+	}
+	if (!ReadValue(Data, NumBytes, Position, NumLayers) || NumLayers == 0 || NumLayers > (uint32)MaxLayers)
+	{
+		OutError = FString::Printf(TEXT("layer count must be 1-%d"), MaxLayers);
+		return false;
+	}
+
+	uint32 Sizes[MaxLayers + 1];
+	for (uint32 i = 0; i <= NumLayers; ++i)
+	{
+		if (!ReadValue(Data, NumBytes, Position, Sizes[i]) || Sizes[i] == 0 || Sizes[i] > (uint32)MaxLayerWidth)
+		{
+			OutError = FString::Printf(TEXT("layer sizes must be 1-%d"), MaxLayerWidth);
+			return false;
+		}
+	}
+	if (Sizes[0] != (uint32)NumInputs || Sizes[NumLayers] != (uint32)NumOutputs)
+	{
+		OutError = FString::Printf(TEXT("model must take %d inputs and give %d outputs"), NumInputs, NumOutputs);
+		return false;
+	}
+
+	TArray<FLayer> NewLayers;
+	int32 NumParameters = 0;
+	for (uint32 i = 0; i < NumLayers; ++i)
+	{
+		FLayer Layer;
+		Layer.NumIn = (int32)Sizes[i];
+		Layer.NumOut = (int32)Sizes[i + 1];
+		Layer.WeightOffset = NumParameters;
+		NumParameters += Layer.NumOut * (Layer.NumIn + 1);
+		NewLayers.Add(Layer);
+	}
+
+	if (NumBytes - Position != NumParameters * (int32)sizeof(float))
+	{
+		OutError = FString::Printf(TEXT("expected %d parameters"), NumParameters);
+		return false;
+	}
+
+	Parameters.SetNum(NumParameters);
+	FMemory::Memcpy(Parameters.GetData(), Data + Position, sizeof(float) * NumParameters);
+	Layers = MoveTemp(NewLayers);
+	WeightMemory.Set(Parameters.GetAllocatedSize() + Layers.GetAllocatedSize());
+	return true;
+}
+
+bool FImpactPredictor::InitializeRandom(const int32* LayerSizes, int32 NumSizes, uint32 Seed)
+{
+	// Same shape rules as a weights file
+	if (NumSizes < 2 || NumSizes > MaxLayers + 1)
+	{
+		return false;
+	}
+	for (int32 i = 0; i < NumSizes; ++i)
+	{
+		if (LayerSizes[i] < 1 || LayerSizes[i] > MaxLayerWidth)
+		{
+			return false;
+		}
+	}
+	if (LayerSizes[0] != NumInputs || LayerSizes[NumSizes - 1] != NumOutputs)
+	{
+		return false;
+	}
+
+	Layers.Reset();
+	Parameters.Reset();
+
+	uint32 State = Seed ? Seed : 1;
+	for (int32 i = 0; i + 1 < NumSizes; ++i)
+	{
+		FLayer Layer;
+		Layer.NumIn = LayerSizes[i];
+		Layer.NumOut = LayerSizes[i + 1];
+		Layer.WeightOffset = Parameters.Num();
+		Layers.Add(Layer);
+
+		const float Limit = std::sqrt(6.0f / Layer.NumIn);
+		for (int32 Weight = 0; Weight < Layer.NumIn * Layer.NumOut; ++Weight)
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			Parameters.Add(Limit * ((State & 0xFFFFFF) / float(0x800000) - 1.0f));
+		}
+		for (int32 Bias = 0; Bias < Layer.NumOut; ++Bias)
+		{
+			Parameters.Add(0.0f);
+		}
+	}
+	WeightMemory.Set(Parameters.GetAllocatedSize() + Layers.GetAllocatedSize());
+	return true;
+}
+
+int32 FImpactPredictor::GetNumMultiplyAdds() const
+{
+	int32 Total = 0;
+	for (const FLayer& Layer : Layers)
+	{
+		Total += Layer.NumIn * Layer.NumOut;
+	}
+	return Total;
+}
+
+void FImpactPredictor::BuildFeatures(const FImpactEvent& Impact, float* OutFeatures)
+{
+	const float Force = FMath::Clamp(Impact.ImpactForce, 0.0f, 1.0f);
+	OutFeatures[0] = Force;
+	OutFeatures[1] = std::sqrt(Force);
+	OutFeatures[2] = std::log2(FMath::Max(Impact.ImpactFrequency, 1.0f) / 1000.0f);
+	OutFeatures[3] = Impact.Duration;
+	OutFeatures[4] = Impact.ImpactNormal.X;
+	OutFeatures[5] = Impact.ImpactNormal.Y;
+	OutFeatures[6] = Impact.ImpactNormal.Z;
+	OutFeatures[7] = Impact.Position.Y;
+}
+
+void FImpactPredictor::Predict(const float* Features, int32 Count, float* OutValues) const
+{
+	if (!IsLoaded())
+	{
+		FMemory::Memzero(OutValues, sizeof(float) * Count * NumOutputs);
+		return;
+	}
+
+	alignas(16) float In[MaxLayerWidth * Lanes];
+	alignas(16) float Scratch[MaxLayerWidth * Lanes];
+	alignas(16) float Out[NumOutputs * Lanes];
+
+	for (int32 Start = 0; Start < Count; Start += Lanes)
+	{
+		// Transpose the group so each input is one vector across events; missing events are zero
+		const int32 GroupSize = FMath::Min(Lanes, Count - Start);
+		for (int32 Input = 0; Input < NumInputs; ++Input)
+		{
+			for (int32 Lane = 0; Lane < Lanes; ++Lane)
+			{
+				In[Input * Lanes + Lane] = Lane < GroupSize ? Features[(Start + Lane) * NumInputs + Input] : 0.0f;
+			}
+		}
+
+		EvaluateGroup(In, Scratch, Out);
+
+		for (int32 Lane = 0; Lane < GroupSize; ++Lane)
+		{
+			for (int32 Output = 0; Output < NumOutputs; ++Output)
+			{
+				OutValues[(Start + Lane) * NumOutputs + Output] = Out[Output * Lanes + Lane];
+			}
+		}
+	}
+}
+
+void FImpactPredictor::PredictImpacts(const FImpactEvent* Impacts, int32 Count, float MinFrequency, float MaxFrequency,
+	float* OutFrequency, float* OutAmplitude, float* OutDuration) const
+{
+	float Features[ImpactChunk * NumInputs];
+	float Values[ImpactChunk * NumOutputs];
+
+	for (int32 Start = 0; Start < Count; Start += ImpactChunk)
+	{
+		const int32 ChunkSize = FMath::Min(ImpactChunk, Count - Start);
+		for (int32 i = 0; i < ChunkSize; ++i)
+		{
+			BuildFeatures(Impacts[Start + i], Features + i * NumInputs);
+		}
+
+		Predict(Features, ChunkSize, Values);
+
+		for (int32 i = 0; i < ChunkSize; ++i)
+		{
+			const float* Value = Values + i * NumOutputs;
+			OutFrequency[Start + i] = FMath::Clamp(std::exp2(Value[0]), MinFrequency, MaxFrequency);
+			OutAmplitude[Start + i] = FMath::Clamp(Value[1], 0.0f, 1.0f);
+			OutDuration[Start + i] = FMath::Clamp(Value[2], 0.01f, 10.0f);
+		}
+	}
+}
+
+void FImpactPredictor::EvaluateGroup(float* In, float* Scratch, float* OutValues) const
+{
+	float* Current = In;
+	float* Next = Scratch;
+
+	for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		const FLayer& Layer = Layers[LayerIndex];
+		const float* Weights = Parameters.GetData() + Layer.WeightOffset;
+		const float* Biases = Weights + Layer.NumIn * Layer.NumOut;
+		const bool bHidden = LayerIndex + 1 < Layers.Num();
+		float* Target = bHidden ? Next : OutValues;
+
+		// Each neuron sums its inputs in order, then applies ReLU on hidden layers
+#if SANDBOX_HAS_SSE2
+		if (GetSimdLevel() >= ESimdLevel::SSE2)
+		{
+			// Lanes are two vectors, so every broadcast weight is used twice
+			const __m128 Zero = _mm_setzero_ps();
+			int32 Neuron = 0;
+
+			// Two neurons at once keep four independent accumulators in flight
+			for (; Neuron + 2 <= Layer.NumOut; Neuron += 2)
+			{
+				const float* Row0 = Weights + Neuron * Layer.NumIn;
+				const float* Row1 = Row0 + Layer.NumIn;
+				__m128 Sum0Low = _mm_set1_ps(Biases[Neuron]);
+				__m128 Sum0High = Sum0Low;
+				__m128 Sum1Low = _mm_set1_ps(Biases[Neuron + 1]);
+				__m128 Sum1High = Sum1Low;
+				for (int32 Input = 0; Input < Layer.NumIn; ++Input)
+				{
+					const __m128 Low = _mm_load_ps(Current + Input * Lanes);
+					const __m128 High = _mm_load_ps(Current + Input * Lanes + 4);
+					const __m128 Weight0 = _mm_set1_ps(Row0[Input]);
+					const __m128 Weight1 = _mm_set1_ps(Row1[Input]);
+					Sum0Low = _mm_add_ps(Sum0Low, _mm_mul_ps(Weight0, Low));
+					Sum0High = _mm_add_ps(Sum0High, _mm_mul_ps(Weight0, High));
+					Sum1Low = _mm_add_ps(Sum1Low, _mm_mul_ps(Weight1, Low));
+					Sum1High = _mm_add_ps(Sum1High, _mm_mul_ps(Weight1, High));
+				}
+				if (bHidden)
+				{
+					Sum0Low = _mm_max_ps(Sum0Low, Zero);
+					Sum0High = _mm_max_ps(Sum0High, Zero);
+					Sum1Low = _mm_max_ps(Sum1Low, Zero);
+					Sum1High = _mm_max_ps(Sum1High, Zero);
+				}
+				_mm_store_ps(Target + Neuron * Lanes, Sum0Low);
+				_mm_store_ps(Target + Neuron * Lanes + 4, Sum0High);
+				_mm_store_ps(Target + (Neuron + 1) * Lanes, Sum1Low);
+				_mm_store_ps(Target + (Neuron + 1) * Lanes + 4, Sum1High);
+			}
+
+			for (; Neuron < Layer.NumOut; ++Neuron)
+			{
+				const float* Row = Weights + Neuron * Layer.NumIn;
+				__m128 SumLow = _mm_set1_ps(Biases[Neuron]);
+				__m128 SumHigh = SumLow;
+				for (int32 Input = 0; Input < Layer.NumIn; ++Input)
+				{
+					const __m128 Weight = _mm_set1_ps(Row[Input]);
+					SumLow = _mm_add_ps(SumLow, _mm_mul_ps(Weight, _mm_load_ps(Current + Input * Lanes)));
+					SumHigh = _mm_add_ps(SumHigh, _mm_mul_ps(Weight, _mm_load_ps(Current + Input * Lanes + 4)));
+				}
+				if (bHidden)
+				{
+					SumLow = _mm_max_ps(SumLow, Zero);
+					SumHigh = _mm_max_ps(SumHigh, Zero);
+				}
+				_mm_store_ps(Target + Neuron * Lanes, SumLow);
+				_mm_store_ps(Target + Neuron * Lanes + 4, SumHigh);
+			}
+		}
+		else
+#endif
+		{
+			for (int32 Neuron = 0; Neuron < Layer.NumOut; ++Neuron)
+			{
+				const float* Row = Weights + Neuron * Layer.NumIn;
+				for (int32 Lane = 0; Lane < Lanes; ++Lane)
+				{
+					float Sum = Biases[Neuron];
+					for (int32 Input = 0; Input < Layer.NumIn; ++Input)
+					{
+						Sum = Sum + Row[Input] * Current[Input * Lanes + Lane];
+					}
+					Target[Neuron * Lanes + Lane] = bHidden && !(Sum > 0.0f) ? 0.0f : Sum;
+				}
+			}
+		}
+
+		Swap(Current, Next);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Physics/PhysicsCore.h"
+#include "MemoryAccounting.h"
+
+/**
+ * Small multilayer perceptron mapping impact features to synthesis parameters
+ *
+ * An optional replacement for the linear mappings of FAudioPhysicsMapper,
+ * trained offline and loaded from a local weights file. Hidden layers use
+ * ReLU; the output layer is linear and gives log2 frequency (Hz), amplitude
+ * and duration (s).
+ *
+ * Inference is batched: events are evaluated eight at a time, one per SIMD
+ * lane (two SSE2 vectors where available), with weights broadcast across lanes. The
+ * scalar path performs the same operations in the same order, so both give
+ * identical results. All scratch lives on the stack; Predict is const and
+ * can run on several threads at once.
+ *
+ * Weights file (little-endian):
+ *   char    Magic[8]   "SBMLP\0\0\0"
+ *   uint32  Version    1
+ *   uint32  NumLayers  Weight layers, at most MaxLayers
+ *   uint32  Sizes[NumLayers + 1]   Sizes[0] = NumInputs, last = NumOutputs, each at most MaxLayerWidth
+ *   Per layer: float32 Weights[Out][In] (row-major), then float32 Bias[Out]
+ */
+class FImpactPredictor
+{
+public:
+	/**
+	 * Inputs, from BuildFeatures:
+	 *   force, sqrt(force), log2(suggested frequency / 1 kHz), suggested duration,
+	 *   impact normal x, y, z, height of the impact
+	 */
+	static constexpr int32 NumInputs = 8;
+	static constexpr int32 NumOutputs = 3;
+	static constexpr int32 MaxLayers = 8;
+	static constexpr int32 MaxLayerWidth = 256;
+	static constexpr uint32 Version = 1;
+
+	FImpactPredictor();
+
+	/**
+	 * Load a weights file
+	 * @return false with a description in OutError if the file is missing or malformed; the current model is kept
+	 */
+	bool LoadFromFile(const FString& Filename, FString& OutError);
+	bool LoadFromMemory(const uint8* Data, int32 NumBytes, FString& OutError);
+
+	/**
+	 * Random He-initialised weights of the given shape, for benchmarks and plumbing tests
+	 * @param LayerSizes NumSizes sizes from NumInputs to NumOutputs
+	 * @return false if the shape is not one LoadFromMemory accepts; the current model is kept
+	 */
+	bool InitializeRandom(const int32* LayerSizes, int32 NumSizes, uint32 Seed);
+
+	bool IsLoaded() const { return Layers.Num() > 0; }
+	int32 GetNumLayers() const { return Layers.Num(); }
+
+	/** Multiply-adds per event */
+	int32 GetNumMultiplyAdds() const;
+
+	/** @param OutFeatures NumInputs values */
+	static void BuildFeatures(const FImpactEvent& Impact, float* OutFeatures);
+
+	/**
+	 * Raw network outputs for a batch
+	 * @param Features Count * NumInputs values, one event after another
+	 * @param OutValues Count * NumOutputs values
+	 */
+	void Predict(const float* Features, int32 Count, float* OutValues) const;
+
+	/**
+	 * Synthesis parameters for a batch of impacts
+	 * Frequency is clamped to [MinFrequency, MaxFrequency], amplitude to 0-1 and duration to 0.01-10 s
+	 */
+	void PredictImpacts(const FImpactEvent* Impacts, int32 Count, float MinFrequency, float MaxFrequency,
+		float* OutFrequency, float* OutAmplitude, float* OutDuration) const;
+
+private:
+	struct FLayer
+	{
+		int32 NumIn;
+		int32 NumOut;
+		int32 WeightOffset;   // Into Parameters; biases follow the weights
+	};
+
+	TArray<FLayer> Layers;
+	TArray<float> Parameters;
+	FMemoryCharge WeightMemory;
+
+	/** Evaluate a group of events held lane-interleaved: In[Input * Lanes + Lane] */
+	void EvaluateGroup(float* In, float* Scratch, float* OutValues) const;
+};
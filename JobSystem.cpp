@@ -0,0 +1,455 @@
+#include "JobSystem.h"
+#include <chrono>
+
+namespace
+{
+	// Set on worker threads so Submit and Wait can use the worker's own deques
+	thread_local FJobSystem* CurrentSystem = nullptr;
+	thread_local int32 CurrentWorker = INDEX_NONE;
+
+	// Jobs this thread is inside; only the outermost one counts as busy time, as nested jobs run within it
+	thread_local int32 ExecuteDepth = 0;
+
+	// Empty polls before an idle worker or a waiter goes to sleep
+	constexpr int32 SpinsBeforeSleep = 64;
+
+	int64 NowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+const TCHAR* GetJobLaneName(EJobLane Lane)
+{
+	switch (Lane)
+	{
+	case EJobLane::RealTimeAudio: return TEXT("realtime-audio");
+	case EJobLane::Physics:       return TEXT("physics");
+	case EJobLane::Background:    return TEXT("background");
+	default:                      return TEXT("unknown");
+	}
+}
+
+// ============================================================================
+// FJobSystem::FWorkDeque Implementation
+// ============================================================================
+
+FJobSystem::FWorkDeque::FWorkDeque()
+	: Top(0)
+	, Bottom(0)
+{
+	for (std::atomic<FJob*>& Slot : Slots)
+	{
+		Slot.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+bool FJobSystem::FWorkDeque::Push(FJob* Job)
+{
+	const int64 B = Bottom.load(std::memory_order_relaxed);
+	const int64 T = Top.load(std::memory_order_acquire);
+	if (B - T >= DequeCapacity)
+	{
+		return false;
+	}
+	Slots[B & (DequeCapacity - 1)].store(Job, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	Bottom.store(B + 1, std::memory_order_relaxed);
+	return true;
+}
+
+FJob* FJobSystem::FWorkDeque::Pop()
+{
+	const int64 B = Bottom.load(std::memory_order_relaxed) - 1;
+	Bottom.store(B, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 T = Top.load(std::memory_order_relaxed);
+
+	if (T > B)
+	{
+		Bottom.store(B + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	FJob* Job = Slots[B & (DequeCapacity - 1)].load(std::memory_order_relaxed);
+	if (T == B)
+	{
+		// Last job: race the thieves for it
+		if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			Job = nullptr;
+		}
+		Bottom.store(B + 1, std::memory_order_relaxed);
+	}
+	return Job;
+}
+
+FJob* FJobSystem::FWorkDeque::Steal()
+{
+	int64 T = Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64 B = Bottom.load(std::memory_order_acquire);
+	if (T >= B)
+	{
+		return nullptr;
+	}
+
+	FJob* Job = Slots[T & (DequeCapacity - 1)].load(std::memory_order_relaxed);
+	if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+	return Job;
+}
+
+// ============================================================================
+// FJobSystem::FInjectionQueue Implementation
+// ============================================================================
+
+FJobSystem::FInjectionQueue::FInjectionQueue()
+	: EnqueuePos(0)
+	, DequeuePos(0)
+{
+	for (int32 i = 0; i < DequeCapacity; ++i)
+	{
+		Cells[i].Sequence.store((uint64)i, std::memory_order_relaxed);
+		Cells[i].Job = nullptr;
+	}
+}
+
+bool FJobSystem::FInjectionQueue::Push(FJob* Job)
+{
+	uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		FCell& Cell = Cells[Pos & (DequeCapacity - 1)];
+		const uint64 Sequence = Cell.Sequence.load(std::memory_order_acquire);
+		const int64 Difference = (int64)Sequence - (int64)Pos;
+		if (Difference == 0)
+		{
+			if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+			{
+				Cell.Job = Job;
+				Cell.Sequence.store(Pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (Difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			Pos = EnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+FJob* FJobSystem::FInjectionQueue::Pop()
+{
+	uint64 Pos = DequeuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		FCell& Cell = Cells[Pos & (DequeCapacity - 1)];
+		const uint64 Sequence = Cell.Sequence.load(std::memory_order_acquire);
+		const int64 Difference = (int64)Sequence - (int64)(Pos + 1);
+		if (Difference == 0)
+		{
+			if (DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+			{
+				FJob* Job = Cell.Job;
+				Cell.Sequence.store(Pos + DequeCapacity, std::memory_order_release);
+				return Job;
+			}
+		}
+		else if (Difference < 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			Pos = DequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// ============================================================================
+// FJobSystem Implementation
+// ============================================================================
+
+FJobSystem::FJobSystem(int32 NumWorkers, int32 InNumRealTimeWorkers)
+	: NumRealTimeWorkers(0)
+	, StatsStartNanoseconds(NowNanoseconds())
+	, BackgroundRunning(0)
+	, Sleeping(0)
+	, SleepingRealTime(0)
+	, SleepingWaiters(0)
+	, bStopping(false)
+{
+	if (NumWorkers <= 0)
+	{
+		NumWorkers = FMath::Max((int32)std::thread::hardware_concurrency() - 1, 1);
+	}
+	NumRealTimeWorkers = FMath::Clamp(InNumRealTimeWorkers, 0, NumWorkers - 1);
+
+	for (int32 Lane = 0; Lane < (int32)EJobLane::Count; ++Lane)
+	{
+		Injectors[Lane] = MakeUnique<FInjectionQueue>();
+		Queued[Lane].store(0, std::memory_order_relaxed);
+		Counters[Lane].JobsExecuted.store(0, std::memory_order_relaxed);
+		Counters[Lane].JobsStolen.store(0, std::memory_order_relaxed);
+		Counters[Lane].BusyNanoseconds.store(0, std::memory_order_relaxed);
+	}
+
+	Workers.Reserve(NumWorkers);
+	for (int32 i = 0; i < NumWorkers; ++i)
+	{
+		Workers.Add(MakeUnique<FWorker>());
+	}
+
+	// Start threads only once every deque exists, since they steal from each other
+	Threads.Reserve(NumWorkers);
+	for (int32 i = 0; i < NumWorkers; ++i)
+	{
+		Threads.Add(std::thread([this, i]() { WorkerMain(i); }));
+	}
+}
+
+FJobSystem::~FJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> Lock(SleepLock);
+		bStopping.store(true);
+	}
+	WakeSignal.notify_all();
+	RealTimeWakeSignal.notify_all();
+
+	for (std::thread& Thread : Threads)
+	{
+		Thread.join();
+	}
+}
+
+FJobSystem& FJobSystem::Get()
+{
+	static FJobSystem Shared;
+	return Shared;
+}
+
+void FJobSystem::Submit(FJob& Job, FJobGroup& Group)
+{
+	Job.Group = &Group;
+	Group.Pending.fetch_add(1, std::memory_order_relaxed);
+
+	const int32 Lane = (int32)Group.Lane;
+	const bool bOnWorker = CurrentSystem == this;
+	if (!(bOnWorker && Workers[CurrentWorker]->Deques[Lane].Push(&Job))
+		&& !Injectors[Lane]->Push(&Job))
+	{
+		Execute(&Job, Group.Lane, bOnWorker);
+		return;
+	}
+
+	// Pairs with the sleeper's increment of Sleeping before it rechecks Queued
+	Queued[Lane].fetch_add(1, std::memory_order_seq_cst);
+	if (Group.Lane == EJobLane::RealTimeAudio && SleepingRealTime.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> Lock(SleepLock);
+		RealTimeWakeSignal.notify_one();
+	}
+	else if (Sleeping.load(std::memory_order_seq_cst) > 0)
+	{
+		// Waiters share the signal, so a single notify could land on one of them instead of a worker
+		std::lock_guard<std::mutex> Lock(SleepLock);
+		if (SleepingWaiters.load(std::memory_order_relaxed) > 0)
+		{
+			WakeSignal.notify_all();
+		}
+		else
+		{
+			WakeSignal.notify_one();
+		}
+	}
+}
+
+void FJobSystem::Wait(FJobGroup& Group)
+{
+	const int32 WorkerIndex = CurrentSystem == this ? CurrentWorker : INDEX_NONE;
+	int32 Spins = 0;
+	while (!Group.IsDone())
+	{
+		EJobLane Lane;
+		if (FJob* Job = FindJob(WorkerIndex, Group.Lane, false, Lane))
+		{
+			Execute(Job, Lane, WorkerIndex != INDEX_NONE);
+			Spins = 0;
+			continue;
+		}
+
+		if (++Spins < SpinsBeforeSleep)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Every job of the group has been taken; sleep until the last one finishes. Jobs submitted
+		// meanwhile are left to the workers. Pairs with Execute's check of SleepingWaiters.
+		std::unique_lock<std::mutex> Lock(SleepLock);
+		SleepingWaiters.fetch_add(1, std::memory_order_seq_cst);
+		WakeSignal.wait(Lock, [&Group]()
+		{
+			return Group.Pending.load(std::memory_order_seq_cst) == 0;
+		});
+		SleepingWaiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+FJob* FJobSystem::FindJob(int32 WorkerIndex, EJobLane MaxLane, bool bLimitBackground, EJobLane& OutLane)
+{
+	const int32 NumWorkers = Workers.Num();
+	const int32 NumGeneralWorkers = NumWorkers - NumRealTimeWorkers;
+	for (int32 Lane = 0; Lane <= (int32)MaxLane; ++Lane)
+	{
+		// Leave a general worker free for higher lanes
+		if (Lane == (int32)EJobLane::Background && bLimitBackground
+			&& NumGeneralWorkers > 1 && BackgroundRunning.load(std::memory_order_relaxed) >= NumGeneralWorkers - 1)
+		{
+			continue;
+		}
+
+		OutLane = (EJobLane)Lane;
+		FJob* Job = WorkerIndex != INDEX_NONE ? Workers[WorkerIndex]->Deques[Lane].Pop() : nullptr;
+		if (!Job)
+		{
+			Job = Injectors[Lane]->Pop();
+		}
+		if (!Job)
+		{
+			// Start at a different victim from each thief to spread contention
+			const int32 First = WorkerIndex != INDEX_NONE ? WorkerIndex + 1 : 0;
+			for (int32 i = 0; i < NumWorkers && !Job; ++i)
+			{
+				const int32 Victim = (First + i) % NumWorkers;
+				if (Victim != WorkerIndex)
+				{
+					Job = Workers[Victim]->Deques[Lane].Steal();
+				}
+			}
+			if (Job)
+			{
+				Counters[Lane].JobsStolen.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		if (Job)
+		{
+			Queued[Lane].fetch_sub(1, std::memory_order_relaxed);
+			return Job;
+		}
+	}
+	return nullptr;
+}
+
+void FJobSystem::Execute(FJob* Job, EJobLane Lane, bool bOnWorker)
+{
+	// The submitter may free the job as soon as the group drops to zero
+	FJobGroup* Group = Job->Group;
+	const bool bCountBackground = bOnWorker && Lane == EJobLane::Background;
+	if (bCountBackground)
+	{
+		BackgroundRunning.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const bool bOutermost = ExecuteDepth++ == 0;
+	const int64 Start = bOutermost ? NowNanoseconds() : 0;
+	Job->Function(Job->Context);
+	--ExecuteDepth;
+
+	FLaneCounters& LaneCounters = Counters[(int32)Lane];
+	LaneCounters.JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+	if (bOutermost)
+	{
+		LaneCounters.BusyNanoseconds.fetch_add((uint64)(NowNanoseconds() - Start), std::memory_order_relaxed);
+	}
+	if (bCountBackground)
+	{
+		BackgroundRunning.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	// The group must not be touched once it reaches zero; waking needs only the system's own state
+	if (Group->Pending.fetch_sub(1, std::memory_order_seq_cst) == 1
+		&& SleepingWaiters.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> Lock(SleepLock);
+		WakeSignal.notify_all();
+	}
+}
+
+void FJobSystem::WorkerMain(int32 WorkerIndex)
+{
+	CurrentSystem = this;
+	CurrentWorker = WorkerIndex;
+	const EJobLane MaxLane = WorkerIndex < NumRealTimeWorkers ? EJobLane::RealTimeAudio : EJobLane::Background;
+
+	int32 Spins = 0;
+	while (!bStopping.load(std::memory_order_relaxed))
+	{
+		EJobLane Lane;
+		if (FJob* Job = FindJob(WorkerIndex, MaxLane, true, Lane))
+		{
+			Execute(Job, Lane, true);
+			Spins = 0;
+			continue;
+		}
+
+		if (++Spins < SpinsBeforeSleep)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Lock(SleepLock);
+		std::atomic<int32>& SleepCount = MaxLane == EJobLane::RealTimeAudio ? SleepingRealTime : Sleeping;
+		SleepCount.fetch_add(1, std::memory_order_seq_cst);
+		(MaxLane == EJobLane::RealTimeAudio ? RealTimeWakeSignal : WakeSignal).wait(Lock, [this, MaxLane]()
+		{
+			for (int32 WakeLane = 0; WakeLane <= (int32)MaxLane; ++WakeLane)
+			{
+				if (Queued[WakeLane].load(std::memory_order_seq_cst) > 0)
+				{
+					return true;
+				}
+			}
+			return bStopping.load();
+		});
+		SleepCount.fetch_sub(1, std::memory_order_relaxed);
+		Spins = 0;
+	}
+
+	CurrentSystem = nullptr;
+	CurrentWorker = INDEX_NONE;
+}
+
+FJobLaneStats FJobSystem::GetLaneStats(EJobLane Lane) const
+{
+	const FLaneCounters& LaneCounters = Counters[(int32)Lane];
+	const double Elapsed = (NowNanoseconds() - StatsStartNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+
+	FJobLaneStats Stats;
+	Stats.JobsExecuted = LaneCounters.JobsExecuted.load(std::memory_order_relaxed);
+	Stats.JobsStolen = LaneCounters.JobsStolen.load(std::memory_order_relaxed);
+	Stats.BusySeconds = LaneCounters.BusyNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+	Stats.Utilization = Elapsed > 0.0 ? (float)(Stats.BusySeconds / (Elapsed * FMath::Max(GetNumWorkers(), 1))) : 0.0f;
+	return Stats;
+}
+
+void FJobSystem::ResetStats()
+{
+	for (FLaneCounters& LaneCounters : Counters)
+	{
+		LaneCounters.JobsExecuted.store(0, std::memory_order_relaxed);
+		LaneCounters.JobsStolen.store(0, std::memory_order_relaxed);
+		LaneCounters.BusyNanoseconds.store(0, std::memory_order_relaxed);
+	}
+	StatsStartNanoseconds.store(NowNanoseconds(), std::memory_order_relaxed);
+}
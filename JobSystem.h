@@ -0,0 +1,271 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * Priority lanes; idle threads take work from the lowest-numbered lane first
+ */
+enum class EJobLane : uint8
+{
+	RealTimeAudio,   // Work an audio callback is waiting on
+	Physics,         // Simulation steps and other per-block engine work
+	Background,      // Offline rendering, analysis, I/O preparation
+	Count
+};
+
+const TCHAR* GetJobLaneName(EJobLane Lane);
+
+/**
+ * Fork/join counter: jobs submitted against a group are waited on together
+ * The lane is shared by every job in the group
+ */
+struct FJobGroup
+{
+	std::atomic<int32> Pending;
+	EJobLane Lane;
+
+	explicit FJobGroup(EJobLane InLane) : Pending(0), Lane(InLane) {}
+	bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * Unit of work; a plain function pointer and context so submitting never allocates
+ * Owned by the submitter, and must stay alive until its group completes
+ */
+struct FJob
+{
+	void (*Function)(void* Context);
+	void* Context;
+	FJobGroup* Group;
+};
+
+/**
+ * Per-lane counters since the last ResetStats
+ */
+struct FJobLaneStats
+{
+	uint64 JobsExecuted;
+	uint64 JobsStolen;     // Taken from another worker's deque
+	double BusySeconds;    // Summed over all threads, outermost jobs only so nested work is not counted twice
+	float Utilization;     // BusySeconds over elapsed time times worker count; threads helping in Wait can push it past 1
+};
+
+/**
+ * Work-stealing job system
+ *
+ * Each worker owns a lock-free deque per lane (Chase-Lev): it pushes and
+ * pops at the bottom while idle workers steal from the top. Jobs submitted
+ * from outside the pool go to a bounded lock-free queue per lane. Idle
+ * threads look for work lane by lane in priority order, so a real-time job
+ * is always taken before a background one, and background jobs never
+ * occupy every worker at once.
+ *
+ * The first workers are reserved for the real-time lane and never take
+ * physics or background jobs, so they alone can be given real-time
+ * scheduling (see ApplyRealTimeConfig) without a long background job
+ * holding a real-time priority.
+ *
+ * A thread waiting on a group helps: it runs queued jobs of the group's lane
+ * or a higher-priority one, so fork/join nests without deadlock. Once nothing
+ * is left to take it sleeps until the group completes. A real-time waiter
+ * will not pick up physics or background work.
+ *
+ * One shared instance (Get) serves the whole library so subsystems do not
+ * oversubscribe the machine with their own threads.
+ */
+class FJobSystem
+{
+public:
+	static constexpr int32 DequeCapacity = 4096;
+	static constexpr int32 MaxParallelFor = 64;
+
+	/**
+	 * @param NumWorkers Worker threads; 0 = one fewer than the hardware threads, since callers help
+	 * @param NumRealTimeWorkers Workers reserved for the real-time lane, out of NumWorkers; at least one worker stays general
+	 */
+	explicit FJobSystem(int32 NumWorkers = 0, int32 NumRealTimeWorkers = 1);
+
+	/** Stops the workers; jobs still queued are dropped, so wait on every group first */
+	~FJobSystem();
+
+	FJobSystem(const FJobSystem&) = delete;
+	FJobSystem& operator=(const FJobSystem&) = delete;
+
+	/** Shared instance, created on first use */
+	static FJobSystem& Get();
+
+	int32 GetNumWorkers() const { return Workers.Num(); }
+
+	/** Workers [0, GetNumRealTimeWorkers()) take only real-time jobs */
+	int32 GetNumRealTimeWorkers() const { return NumRealTimeWorkers; }
+
+	/** For setting a worker's scheduling and affinity (see ApplyRealTimeConfig) */
+	std::thread::native_handle_type GetWorkerNativeHandle(int32 WorkerIndex) { return Threads[WorkerIndex].native_handle(); }
+
+	/**
+	 * Queue a job against a group
+	 * From a worker the job goes on that worker's deque; if the queues are full it runs inline
+	 */
+	void Submit(FJob& Job, FJobGroup& Group);
+
+	/** Run queued jobs, then sleep, until every job in the group has finished */
+	void Wait(FJobGroup& Group);
+
+	/**
+	 * Run Body(Begin, End) over [0, Count) in chunks of Grain, and return when all are done
+	 * Chunks are handed out dynamically, so uneven work balances; the caller runs chunks too
+	 * @param MaxParallelism Threads working on the range, caller included; 0 = all workers plus the caller
+	 */
+	template<typename FBody>
+	void ParallelFor(int32 Count, int32 Grain, EJobLane Lane, const FBody& Body, int32 MaxParallelism = 0);
+
+	/** Fork/join: run B as a job and A on this thread, then wait for both */
+	template<typename FA, typename FB>
+	void Invoke(EJobLane Lane, const FA& A, const FB& B);
+
+	FJobLaneStats GetLaneStats(EJobLane Lane) const;
+	void ResetStats();
+
+private:
+	/**
+	 * Chase-Lev work-stealing deque of fixed capacity
+	 * Push and Pop from the owner only; Steal from any thread
+	 */
+	class FWorkDeque
+	{
+	public:
+		FWorkDeque();
+		bool Push(FJob* Job);
+		FJob* Pop();
+		FJob* Steal();
+
+	private:
+		alignas(64) std::atomic<int64> Top;
+		alignas(64) std::atomic<int64> Bottom;
+		std::atomic<FJob*> Slots[DequeCapacity];
+	};
+
+	/**
+	 * Bounded multi-producer multi-consumer queue (Vyukov) for jobs from outside the pool
+	 */
+	class FInjectionQueue
+	{
+	public:
+		FInjectionQueue();
+		bool Push(FJob* Job);
+		FJob* Pop();
+
+	private:
+		struct FCell
+		{
+			std::atomic<uint64> Sequence;
+			FJob* Job;
+		};
+		alignas(64) std::atomic<uint64> EnqueuePos;
+		alignas(64) std::atomic<uint64> DequeuePos;
+		FCell Cells[DequeCapacity];
+	};
+
+	struct FWorker
+	{
+		FWorkDeque Deques[(int32)EJobLane::Count];
+	};
+
+	struct alignas(64) FLaneCounters
+	{
+		std::atomic<uint64> JobsExecuted;
+		std::atomic<uint64> JobsStolen;
+		std::atomic<uint64> BusyNanoseconds;
+	};
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	TArray<std::thread> Threads;
+	int32 NumRealTimeWorkers;
+	TUniquePtr<FInjectionQueue> Injectors[(int32)EJobLane::Count];
+	FLaneCounters Counters[(int32)EJobLane::Count];
+	std::atomic<int64> StatsStartNanoseconds;
+
+	// Background jobs running on workers, kept below the worker count
+	std::atomic<int32> BackgroundRunning;
+
+	// Sleep/wake: Queued counts submitted jobs not yet taken, per lane. Real-time workers sleep on
+	// their own signal so background work never wakes them; threads in Wait share the general
+	// signal and are woken when any group completes.
+	std::atomic<int32> Queued[(int32)EJobLane::Count];
+	std::atomic<int32> Sleeping;
+	std::atomic<int32> SleepingRealTime;
+	std::atomic<int32> SleepingWaiters;
+	std::atomic<bool> bStopping;
+	std::mutex SleepLock;
+	std::condition_variable WakeSignal;
+	std::condition_variable RealTimeWakeSignal;
+
+	void WorkerMain(int32 WorkerIndex);
+
+	/**
+	 * Take the highest-priority job at or above MaxLane
+	 * @param WorkerIndex Caller's worker index, or INDEX_NONE for outside threads
+	 * @param bLimitBackground Skip background jobs while all but one worker run them (idle workers only;
+	 *        a thread waiting on a group always helps, so nested waits cannot deadlock)
+	 */
+	FJob* FindJob(int32 WorkerIndex, EJobLane MaxLane, bool bLimitBackground, EJobLane& OutLane);
+	void Execute(FJob* Job, EJobLane Lane, bool bOnWorker);
+};
+
+// ============================================================================
+// FJobSystem Template Implementation
+// ============================================================================
+
+template<typename FBody>
+void FJobSystem::ParallelFor(int32 Count, int32 Grain, EJobLane Lane, const FBody& Body, int32 MaxParallelism)
+{
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	Grain = FMath::Max(Grain, 1);
+	const int32 NumChunks = (Count - 1) / Grain + 1;
+	const int32 Parallelism = MaxParallelism > 0 ? MaxParallelism : GetNumWorkers() + 1;
+	const int32 NumHelpers = FMath::Min(FMath::Min(Parallelism, NumChunks) - 1, MaxParallelFor);
+
+	std::atomic<int32> NextChunk(0);
+	auto Drain = [&]()
+	{
+		for (int32 Chunk = NextChunk++; Chunk < NumChunks; Chunk = NextChunk++)
+		{
+			const int32 Begin = Chunk * Grain;
+			Body(Begin, FMath::Min(Begin + Grain, Count));
+		}
+	};
+	typedef decltype(Drain) FDrain;
+
+	FJobGroup Group(Lane);
+	FJob Helpers[MaxParallelFor];
+	for (int32 i = 0; i < NumHelpers; ++i)
+	{
+		Helpers[i].Function = [](void* Context) { (*static_cast<FDrain*>(Context))(); };
+		Helpers[i].Context = &Drain;
+		Submit(Helpers[i], Group);
+	}
+
+	Drain();
+	Wait(Group);
+}
+
+template<typename FA, typename FB>
+void FJobSystem::Invoke(EJobLane Lane, const FA& A, const FB& B)
+{
+	FJobGroup Group(Lane);
+	FJob Job;
+	Job.Function = [](void* Context) { (*static_cast<const FB*>(Context))(); };
+	Job.Context = const_cast<FB*>(&B);
+	Submit(Job, Group);
+
+	A();
+	Wait(Group);
+}
@@ -0,0 +1,71 @@
+#include "LookupTables.h"
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+	constexpr float Pi = 3.14159265f;
+
+	std::mutex FftTablesLock;
+	std::atomic<const FFftTables*> FftTablesBySize[MaxFftSizeLog2 + 1];
+
+	FFftTables* BuildFftTables(int32 Bits)
+	{
+		FFftTables* Tables = new FFftTables();
+		const int32 N = 1 << Bits;
+		Tables->Size = N;
+
+		Tables->Window.SetNum(N);
+		for (int32 i = 0; i < N; ++i)
+		{
+			Tables->Window[i] = 0.5f - 0.5f * std::cos(2.0f * Pi * i / N);
+		}
+
+		Tables->Cosines.SetNum(N / 2);
+		Tables->Sines.SetNum(N / 2);
+		for (int32 k = 0; k < N / 2; ++k)
+		{
+			Tables->Cosines[k] = std::cos(2.0f * Pi * k / N);
+			Tables->Sines[k] = -std::sin(2.0f * Pi * k / N);
+		}
+
+		Tables->BitReverse.SetNum(N);
+		for (int32 i = 0; i < N; ++i)
+		{
+			int32 Reversed = 0;
+			for (int32 Bit = 0; Bit < Bits; ++Bit)
+			{
+				Reversed |= ((i >> Bit) & 1) << (Bits - 1 - Bit);
+			}
+			Tables->BitReverse[i] = Reversed;
+		}
+		return Tables;
+	}
+}
+
+const FFftTables& GetFftTables(int32 Size)
+{
+	int32 Bits = 0;
+	while ((1 << Bits) < Size && Bits < MaxFftSizeLog2)
+	{
+		++Bits;
+	}
+
+	// Published once and never replaced, so readers after the first skip the lock
+	const FFftTables* Tables = FftTablesBySize[Bits].load(std::memory_order_acquire);
+	if (Tables)
+	{
+		return *Tables;
+	}
+
+	std::lock_guard<std::mutex> Lock(FftTablesLock);
+	Tables = FftTablesBySize[Bits].load(std::memory_order_relaxed);
+	if (!Tables)
+	{
+		// Intentionally never freed: tables outlive every analyzer, including static ones
+		Tables = BuildFftTables(Bits);
+		FftTablesBySize[Bits].store(Tables, std::memory_order_release);
+	}
+	return *Tables;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed lookup tables shared by every instance
+ *
+ * Tables that depend on nothing are generated by the compiler and live in
+ * read-only data, so they cost nothing at start-up. Tables whose size is only
+ * known at run time (FFT frames) are built once per size on first use and kept
+ * for the life of the process. Nothing here is rebuilt per voice or analyzer.
+ */
+
+namespace LookupTablesPrivate
+{
+	constexpr double Pi = 3.14159265358979323846;
+
+	/** Taylor series, accurate to double precision on [0, Pi/2] */
+	constexpr double SinSeries(double X)
+	{
+		const double X2 = X * X;
+		double Term = X;
+		double Sum = X;
+		for (int32 n = 1; n <= 10; ++n)
+		{
+			Term *= -X2 / ((2 * n) * (2 * n + 1));
+			Sum += Term;
+		}
+		return Sum;
+	}
+
+	constexpr double CosSeries(double X)
+	{
+		const double X2 = X * X;
+		double Term = 1.0;
+		double Sum = 1.0;
+		for (int32 n = 1; n <= 10; ++n)
+		{
+			Term *= -X2 / ((2 * n - 1) * (2 * n));
+			Sum += Term;
+		}
+		return Sum;
+	}
+
+	/** sin(2 * Pi * Index / Count); the quadrant is found in integers so the table's symmetry is exact */
+	constexpr double SinTurn(int64 Index, int64 Count)
+	{
+		const int64 Scaled = (((Index % Count) + Count) % Count) * 4;
+		const int64 Quadrant = Scaled / Count;
+		const double X = (double)(Scaled - Quadrant * Count) / (double)Count * (Pi * 0.5);
+		switch (Quadrant)
+		{
+		case 0:  return SinSeries(X);
+		case 1:  return CosSeries(X);
+		case 2:  return -SinSeries(X);
+		default: return -CosSeries(X);
+		}
+	}
+}
+
+/** Entries in one cycle of the shared sine table */
+constexpr int32 SineTableSize = 4096;
+
+/**
+ * One cycle of sine plus a guard entry equal to the first, so interpolation
+ * never wraps
+ */
+struct FSineTable
+{
+	float Values[SineTableSize + 1];
+};
+
+constexpr FSineTable BuildSineTable()
+{
+	FSineTable Table = {};
+	for (int32 i = 0; i <= SineTableSize; ++i)
+	{
+		Table.Values[i] = (float)LookupTablesPrivate::SinTurn(i, SineTableSize);
+	}
+	return Table;
+}
+
+namespace LookupTablesPrivate
+{
+	inline constexpr FSineTable SineTable = BuildSineTable();
+}
+
+inline const float* GetSineTable()
+{
+	return LookupTablesPrivate::SineTable.Values;
+}
+
+/**
+ * Interpolated sine of a phase in cycles
+ * @param Phase In [0, 1)
+ */
+inline float SampleSineTable(float Phase)
+{
+	const float Position = Phase * SineTableSize;
+	const int32 Index = FMath::Clamp((int32)Position, 0, SineTableSize - 1);
+	const float Fraction = Position - (float)Index;
+	const float* Table = GetSineTable();
+	return Table[Index] + (Table[Index + 1] - Table[Index]) * Fraction;
+}
+
+constexpr int32 MaxFftSizeLog2 = 24;
+
+/**
+ * Tables for a radix-2 FFT of one size
+ */
+struct FFftTables
+{
+	int32 Size;
+	TArray<float> Window;      // Periodic Hann
+	TArray<float> Cosines;     // Twiddles, Size / 2 each
+	TArray<float> Sines;
+	TArray<int32> BitReverse;
+};
+
+/**
+ * Shared tables for an FFT size, built on the first request for that size
+ * Thread-safe; the returned tables are never freed or modified
+ * @param Size Power of two, at most 2^MaxFftSizeLog2
+ */
+const FFftTables& GetFftTables(int32 Size);
@@ -0,0 +1,134 @@
+#include "MemoryAccounting.h"
+
+const TCHAR* GetMemoryTagName(EMemoryTag Tag)
+{
+	switch (Tag)
+	{
+	case EMemoryTag::Audio:       return TEXT("audio");
+	case EMemoryTag::Physics:     return TEXT("physics");
+	case EMemoryTag::Integration: return TEXT("integration");
+	case EMemoryTag::Procedural:  return TEXT("procedural");
+	case EMemoryTag::IO:          return TEXT("io");
+	default:                      return TEXT("unknown");
+	}
+}
+
+// ============================================================================
+// FMemoryAccounting Implementation
+// ============================================================================
+
+FMemoryAccounting::FMemoryAccounting()
+	: NextEvictorHandle(1)
+{
+	for (FTagCounters& Counters : Tags)
+	{
+		Counters.Used.store(0, std::memory_order_relaxed);
+		Counters.Peak.store(0, std::memory_order_relaxed);
+		Counters.Budget.store(0, std::memory_order_relaxed);
+		Counters.Evicted.store(0, std::memory_order_relaxed);
+		Counters.Refusals.store(0, std::memory_order_relaxed);
+		Counters.NumEvictors.store(0, std::memory_order_relaxed);
+	}
+}
+
+FMemoryAccounting& FMemoryAccounting::Get()
+{
+	static FMemoryAccounting Shared;
+	return Shared;
+}
+
+bool FMemoryAccounting::TryCharge(FTagCounters& Counters, int64 Bytes)
+{
+	const int64 Budget = Counters.Budget.load(std::memory_order_relaxed);
+	int64 Used = Counters.Used.load(std::memory_order_relaxed);
+	do
+	{
+		if (Budget > 0 && Used + Bytes > Budget)
+		{
+			return false;
+		}
+	}
+	while (!Counters.Used.compare_exchange_weak(Used, Used + Bytes, std::memory_order_relaxed));
+
+	UpdatePeak(Counters, Used + Bytes);
+	return true;
+}
+
+void FMemoryAccounting::UpdatePeak(FTagCounters& Counters, int64 Used)
+{
+	int64 Peak = Counters.Peak.load(std::memory_order_relaxed);
+	while (Used > Peak && !Counters.Peak.compare_exchange_weak(Peak, Used, std::memory_order_relaxed))
+	{
+	}
+}
+
+bool FMemoryAccounting::TryAllocate(EMemoryTag Tag, int64 Bytes)
+{
+	FTagCounters& Counters = Tags[(int32)Tag];
+	if (Bytes <= 0 || TryCharge(Counters, Bytes))
+	{
+		return true;
+	}
+
+	// Over budget: let the tag's caches make room, then try once more
+	if (Counters.NumEvictors.load(std::memory_order_acquire) > 0)
+	{
+		std::lock_guard<std::mutex> Lock(EvictorLock);
+		for (const FEvictorEntry& Entry : Evictors)
+		{
+			const int64 Wanted = Counters.Used.load(std::memory_order_relaxed) + Bytes - Counters.Budget.load(std::memory_order_relaxed);
+			if (Wanted <= 0)
+			{
+				break;
+			}
+			if (Entry.Tag == Tag)
+			{
+				Counters.Evicted.fetch_add(Entry.Evictor(Wanted), std::memory_order_relaxed);
+			}
+		}
+	}
+
+	if (TryCharge(Counters, Bytes))
+	{
+		return true;
+	}
+	Counters.Refusals.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void FMemoryAccounting::Allocate(EMemoryTag Tag, int64 Bytes)
+{
+	FTagCounters& Counters = Tags[(int32)Tag];
+	UpdatePeak(Counters, Counters.Used.fetch_add(Bytes, std::memory_order_relaxed) + Bytes);
+}
+
+void FMemoryAccounting::Free(EMemoryTag Tag, int64 Bytes)
+{
+	Tags[(int32)Tag].Used.fetch_sub(Bytes, std::memory_order_relaxed);
+}
+
+int32 FMemoryAccounting::AddEvictor(EMemoryTag Tag, FEvictor Evictor)
+{
+	std::lock_guard<std::mutex> Lock(EvictorLock);
+	FEvictorEntry Entry;
+	Entry.Handle = NextEvictorHandle++;
+	Entry.Tag = Tag;
+	Entry.Evictor = MoveTemp(Evictor);
+	Evictors.Add(MoveTemp(Entry));
+	Tags[(int32)Tag].NumEvictors.fetch_add(1, std::memory_order_release);
+	return Evictors.Last().Handle;
+}
+
+void FMemoryAccounting::RemoveEvictor(int32 Handle)
+{
+	std::lock_guard<std::mutex> Lock(EvictorLock);
+	for (int32 i = 0; i < Evictors.Num(); ++i)
+	{
+		if (Evictors[i].Handle == Handle)
+		{
+			Tags[(int32)Evictors[i].Tag].NumEvictors.fetch_sub(1, std::memory_order_release);
+			Evictors.RemoveAt(i);
+			return;
+		}
+	}
+}
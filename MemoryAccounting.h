@@ -0,0 +1,168 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * Subsystems memory is accounted to
+ */
+enum class EMemoryTag : uint8
+{
+	Audio,         // Mix, bus and output buffers
+	Physics,       // Bodies
+	Integration,   // Impact queues, predictor weights
+	Procedural,    // Scene script arenas, timelines, rhythm patterns
+	IO,            // Writer block pools, datasets, snapshot images held for forking
+	Count
+};
+
+const TCHAR* GetMemoryTagName(EMemoryTag Tag);
+
+/**
+ * Process-wide tagged memory accounting with per-tag budgets
+ *
+ * Subsystems charge what they hold against a tag. Growth that can be turned
+ * down (spawning a body, caching a snapshot, sizing a pool) asks with
+ * TryAllocate: over budget, the tag's registered evictors are asked to free
+ * caches first, and if that is not enough the request is refused and the
+ * caller does without. Memory that cannot be refused is charged with
+ * Allocate, may overshoot the budget, and makes later requests fail.
+ *
+ * Counters are lock-free; evictors run under a lock and must not call
+ * TryAllocate themselves.
+ */
+class FMemoryAccounting
+{
+public:
+	/** @return Bytes actually freed, which may differ from BytesWanted */
+	typedef TFunction<int64(int64 BytesWanted)> FEvictor;
+
+	FMemoryAccounting();
+
+	static FMemoryAccounting& Get();
+
+	/** @param Bytes 0 = unlimited */
+	void SetBudget(EMemoryTag Tag, int64 Bytes) { Tags[(int32)Tag].Budget.store(Bytes, std::memory_order_relaxed); }
+	int64 GetBudget(EMemoryTag Tag) const { return Tags[(int32)Tag].Budget.load(std::memory_order_relaxed); }
+
+	int64 GetUsed(EMemoryTag Tag) const { return Tags[(int32)Tag].Used.load(std::memory_order_relaxed); }
+	int64 GetPeak(EMemoryTag Tag) const { return Tags[(int32)Tag].Peak.load(std::memory_order_relaxed); }
+	int64 GetEvicted(EMemoryTag Tag) const { return Tags[(int32)Tag].Evicted.load(std::memory_order_relaxed); }
+	uint32 GetRefusals(EMemoryTag Tag) const { return Tags[(int32)Tag].Refusals.load(std::memory_order_relaxed); }
+
+	/**
+	 * Charge Bytes if the budget allows, evicting caches of the same tag if needed
+	 * Tags without evictors never take the evictor lock, so they are safe to charge from the audio thread
+	 * @return false if refused; nothing is charged
+	 */
+	bool TryAllocate(EMemoryTag Tag, int64 Bytes);
+
+	/** Charge Bytes regardless of the budget */
+	void Allocate(EMemoryTag Tag, int64 Bytes);
+	void Free(EMemoryTag Tag, int64 Bytes);
+
+	/** @return Handle for RemoveEvictor */
+	int32 AddEvictor(EMemoryTag Tag, FEvictor Evictor);
+
+	/** Waits for the evictor if it is running */
+	void RemoveEvictor(int32 Handle);
+
+private:
+	struct alignas(64) FTagCounters
+	{
+		std::atomic<int64> Used;
+		std::atomic<int64> Peak;
+		std::atomic<int64> Budget;
+		std::atomic<int64> Evicted;
+		std::atomic<uint32> Refusals;
+		std::atomic<int32> NumEvictors;   // Changed under EvictorLock
+	};
+
+	struct FEvictorEntry
+	{
+		int32 Handle;
+		EMemoryTag Tag;
+		FEvictor Evictor;
+	};
+
+	FTagCounters Tags[(int32)EMemoryTag::Count];
+
+	std::mutex EvictorLock;
+	TArray<FEvictorEntry> Evictors;
+	int32 NextEvictorHandle;
+
+	/** Charge if within budget, without evicting */
+	bool TryCharge(FTagCounters& Counters, int64 Bytes);
+	void UpdatePeak(FTagCounters& Counters, int64 Used);
+};
+
+/**
+ * Bytes charged to one tag for the lifetime of the owner
+ * Copying charges the copy as well, so owners stay copyable
+ */
+class FMemoryCharge
+{
+public:
+	explicit FMemoryCharge(EMemoryTag InTag = EMemoryTag::Audio) : Tag(InTag), Bytes(0) {}
+	FMemoryCharge(const FMemoryCharge& Other) : Tag(Other.Tag), Bytes(0) { Set(Other.Bytes); }
+	~FMemoryCharge() { Set(0); }
+
+	FMemoryCharge& operator=(const FMemoryCharge& Other)
+	{
+		if (this != &Other)
+		{
+			Set(0);
+			Tag = Other.Tag;
+			Set(Other.Bytes);
+		}
+		return *this;
+	}
+
+	/** Move the charge to another tag */
+	void SetTag(EMemoryTag InTag)
+	{
+		const int64 Charged = Bytes;
+		Set(0);
+		Tag = InTag;
+		Set(Charged);
+	}
+	EMemoryTag GetTag() const { return Tag; }
+	int64 Get() const { return Bytes; }
+
+	/** Charge or release the difference regardless of the budget */
+	void Set(int64 NewBytes)
+	{
+		if (NewBytes > Bytes)
+		{
+			FMemoryAccounting::Get().Allocate(Tag, NewBytes - Bytes);
+		}
+		else if (NewBytes < Bytes)
+		{
+			FMemoryAccounting::Get().Free(Tag, Bytes - NewBytes);
+		}
+		Bytes = NewBytes;
+	}
+
+	/**
+	 * Grow within the budget; shrinking always succeeds
+	 * @return false if refused, leaving the charge unchanged
+	 */
+	bool TrySet(int64 NewBytes)
+	{
+		if (NewBytes > Bytes && !FMemoryAccounting::Get().TryAllocate(Tag, NewBytes - Bytes))
+		{
+			return false;
+		}
+		if (NewBytes < Bytes)
+		{
+			FMemoryAccounting::Get().Free(Tag, Bytes - NewBytes);
+		}
+		Bytes = NewBytes;
+		return true;
+	}
+
+private:
+	EMemoryTag Tag;
+	int64 Bytes;
+};
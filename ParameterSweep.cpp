@@ -0,0 +1,503 @@
+#include "ParameterSweep.h"
+#include "Offline/WavWriter.h"
+#include "Offline/FeatureDataset.h"
+#include "JobSystem.h"
+#include <fstream>
+
+namespace
+{
+	/**
+	 * Run Body(Index) for Index in [0, Count) on the shared job system's background lane
+	 * NumThreads caps the threads used, the caller included; 0 uses them all
+	 * Work is handed out one index at a time so uneven points balance out
+	 */
+	template<typename FBody>
+	void ParallelForEach(int32 Count, int32 NumThreads, const FBody& Body)
+	{
+		FJobSystem::Get().ParallelFor(Count, 1, EJobLane::Background, [&Body](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				Body(Index);
+			}
+		}, NumThreads);
+	}
+
+	/** xorshift32, so random designs are identical on every platform */
+	float NextRandom(uint32& State)
+	{
+		State ^= State << 13;
+		State ^= State >> 17;
+		State ^= State << 5;
+		return (State & 0xFFFFFF) / float(0x1000000);
+	}
+}
+
+FParameterSweep::FParameterSweep(const FSweepConfig& InConfig)
+	: Config(InConfig)
+	, SceneBuilder(&FParameterSweep::DefaultSceneBuilder)
+	, NumResimulated(0)
+{
+}
+
+int32 FParameterSweep::AddParameter(ESweepTarget Target, float Min, float Max, int32 Steps)
+{
+	FSweepParameter Parameter;
+	Parameter.Target = Target;
+	Parameter.Min = Min;
+	Parameter.Max = Max;
+	Parameter.Steps = FMath::Max(Steps, 1);
+	return Parameters.Add(Parameter);
+}
+
+float FParameterSweep::GetValue(const FSweepPoint& Point, ESweepTarget Target, float DefaultValue) const
+{
+	for (int32 i = 0; i < Parameters.Num(); ++i)
+	{
+		if (Parameters[i].Target == Target)
+		{
+			return Point.Values[i];
+		}
+	}
+	return DefaultValue;
+}
+
+int32 FParameterSweep::Run()
+{
+	BuildDesign();
+	GroupPrefixes();
+	NumResimulated.store(0, std::memory_order_relaxed);
+
+	// Under I/O budget pressure, snapshots are evicted and their points simulate the lead-in again
+	const int32 Evictor = FMemoryAccounting::Get().AddEvictor(EMemoryTag::IO, [this](int64 BytesWanted)
+	{
+		return EvictSnapshots(BytesWanted);
+	});
+
+	// Each unique lead-in is simulated once, unless its snapshot is evicted
+	ParallelForEach(Prefixes.Num(), Config.NumThreads, [this](int32 Index)
+	{
+		FSandboxSnapshot Snapshot;
+		SimulatePrefix(Prefixes[Index], Snapshot);
+		CacheSnapshot(Prefixes[Index], Snapshot);
+	});
+
+	if (Config.bWriteStems)
+	{
+		StemWriter = MakeUnique<FAsyncAudioWriter>();
+	}
+
+	Results.SetNum(Points.Num());
+	ParallelForEach(Points.Num(), Config.NumThreads, [this](int32 Index)
+	{
+		RenderPoint(Points[Index], Results[Index]);
+	});
+	FMemoryAccounting::Get().RemoveEvictor(Evictor);
+
+	if (StemWriter.IsValid())
+	{
+		StemWriter->Flush();
+		StemWriter.Reset();
+	}
+
+	if (Config.bWriteFeatures)
+	{
+		WriteFeatures();
+	}
+	if (Config.bWriteDataset)
+	{
+		WriteDataset();
+	}
+
+	return Results.Num();
+}
+
+void FParameterSweep::BuildDesign()
+{
+	Points.Clear();
+
+	if (Config.Design == ESweepDesign::Random)
+	{
+		uint32 State = Config.RandomSeed != 0 ? Config.RandomSeed : 1;
+		for (int32 PointIndex = 0; PointIndex < Config.NumRandomPoints; ++PointIndex)
+		{
+			FSweepPoint Point;
+			Point.Index = PointIndex;
+			Point.PrefixIndex = INDEX_NONE;
+			for (const FSweepParameter& Parameter : Parameters)
+			{
+				Point.Values.Add(Parameter.Min + (Parameter.Max - Parameter.Min) * NextRandom(State));
+			}
+			Points.Add(Point);
+		}
+		return;
+	}
+
+	// Grid: the last parameter varies fastest
+	int32 NumPoints = 1;
+	for (const FSweepParameter& Parameter : Parameters)
+	{
+		NumPoints *= Parameter.Steps;
+	}
+
+	for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+	{
+		FSweepPoint Point;
+		Point.Index = PointIndex;
+		Point.PrefixIndex = INDEX_NONE;
+		Point.Values.SetNum(Parameters.Num());
+
+		int32 Remainder = PointIndex;
+		for (int32 i = Parameters.Num() - 1; i >= 0; --i)
+		{
+			const FSweepParameter& Parameter = Parameters[i];
+			const int32 Step = Remainder % Parameter.Steps;
+			Remainder /= Parameter.Steps;
+
+			const float Alpha = Parameter.Steps > 1 ? Step / float(Parameter.Steps - 1) : 0.0f;
+			Point.Values[i] = Parameter.Min + (Parameter.Max - Parameter.Min) * Alpha;
+		}
+		Points.Add(Point);
+	}
+}
+
+void FParameterSweep::GroupPrefixes()
+{
+	Prefixes.Clear();
+
+	for (FSweepPoint& Point : Points)
+	{
+		// Points share a prefix when all scene parameters are equal
+		for (int32 PrefixIndex = 0; PrefixIndex < Prefixes.Num() && Point.PrefixIndex == INDEX_NONE; ++PrefixIndex)
+		{
+			const FSweepPoint& Other = Points[Prefixes[PrefixIndex].FirstPoint];
+			bool bSameScene = true;
+			for (int32 i = 0; i < Parameters.Num() && bSameScene; ++i)
+			{
+				bSameScene = !IsSceneParameter(Parameters[i].Target) || Point.Values[i] == Other.Values[i];
+			}
+			if (bSameScene)
+			{
+				Point.PrefixIndex = PrefixIndex;
+			}
+		}
+
+		if (Point.PrefixIndex == INDEX_NONE)
+		{
+			FSweepPrefix Prefix;
+			Prefix.FirstPoint = Point.Index;
+			Point.PrefixIndex = Prefixes.Add(Prefix);
+		}
+		++Prefixes[Point.PrefixIndex].PendingPoints;
+	}
+}
+
+void FParameterSweep::SimulatePrefix(const FSweepPrefix& Prefix, FSandboxSnapshot& OutSnapshot)
+{
+	FSandboxManager Sandbox(Config.SampleRate, Config.BufferSize);
+	SceneBuilder(Sandbox, *this, Points[Prefix.FirstPoint]);
+
+	const float BlockTime = Config.BufferSize / Config.SampleRate;
+	const int32 NumBlocks = FMath::CeilToInt(Config.LeadInSeconds / BlockTime);
+
+	TArray<float> AudioBuffer;
+	for (int32 Block = 0; Block < NumBlocks; ++Block)
+	{
+		Sandbox.Update(BlockTime, AudioBuffer);
+	}
+
+	Sandbox.CaptureSnapshot(OutSnapshot);
+}
+
+void FParameterSweep::CacheSnapshot(FSweepPrefix& Prefix, const FSandboxSnapshot& Snapshot)
+{
+	// Charged outside the lock: over budget, TryAllocate calls back into EvictSnapshots
+	if (!Prefix.SnapshotMemory.TrySet(Snapshot.GetImageSize()))
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> Lock(SnapshotLock);
+	Prefix.Snapshot = Snapshot;
+}
+
+int64 FParameterSweep::EvictSnapshots(int64 BytesWanted)
+{
+	// Forks in progress hold their own reference to the image, so any cached snapshot can go
+	std::lock_guard<std::mutex> Lock(SnapshotLock);
+	int64 Freed = 0;
+	for (int32 i = 0; i < Prefixes.Num() && Freed < BytesWanted; ++i)
+	{
+		FSweepPrefix& Prefix = Prefixes[i];
+		if (Prefix.Snapshot.IsValid())
+		{
+			Freed += Prefix.SnapshotMemory.Get();
+			Prefix.Snapshot = FSandboxSnapshot();
+			Prefix.SnapshotMemory.Set(0);
+		}
+	}
+	return Freed;
+}
+
+void FParameterSweep::RenderPoint(const FSweepPoint& Point, FSweepResult& OutResult)
+{
+	OutResult.Point = Point;
+	OutResult.bAudioWritten = false;
+	OutResult.NumStems = 0;
+	OutResult.FrameFeatures.Reset();
+	FMemory::Memzero(&OutResult.Features, sizeof(FSweepFeatures));
+
+	FSweepPrefix& Prefix = Prefixes[Point.PrefixIndex];
+	FSandboxSnapshot Snapshot;
+	{
+		std::lock_guard<std::mutex> Lock(SnapshotLock);
+		Snapshot = Prefix.Snapshot;
+	}
+	if (!Snapshot.IsValid())
+	{
+		// Evicted or never cached; not cached again, since memory was short
+		SimulatePrefix(Prefix, Snapshot);
+		NumResimulated.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	TUniquePtr<FSandboxManager> Sandbox = FSandboxManager::Fork(Snapshot);
+	{
+		std::lock_guard<std::mutex> Lock(SnapshotLock);
+		if (--Prefix.PendingPoints == 0)
+		{
+			Prefix.Snapshot = FSandboxSnapshot();
+			Prefix.SnapshotMemory.Set(0);
+		}
+	}
+	if (!Sandbox.IsValid())
+	{
+		return;
+	}
+	ApplyForkParameters(*Sandbox, Point);
+
+	const float BlockTime = Config.BufferSize / Config.SampleRate;
+	const int32 NumBlocks = FMath::CeilToInt(Config.RenderSeconds / BlockTime);
+
+	TArray<float> Rendered;
+	Rendered.Reserve(NumBlocks * Config.BufferSize * 2);
+
+	// One stem per bus the sandbox routes audio to. Dither seeds differ per stem,
+	// so noise does not add up coherently when the stems are summed.
+	int32 StemStreams[(int32)ESandboxBus::Count];
+	for (int32 Bus = 0; Bus < (int32)ESandboxBus::Count; ++Bus)
+	{
+		StemStreams[Bus] = INDEX_NONE;
+		if (StemWriter.IsValid() && Sandbox->IsBusActive((ESandboxBus)Bus))
+		{
+			const FString Filename = FString::Printf(TEXT("%s/sweep_%05d_%s.wav"), *Config.OutputDirectory, Point.Index, GetSandboxBusName((ESandboxBus)Bus));
+			StemStreams[Bus] = StemWriter->OpenStream(Filename, 2, (int32)Config.SampleRate,
+				Config.AudioFormat, Config.AudioDither, (uint32)(Point.Index * (int32)ESandboxBus::Count + Bus) + 1);
+			OutResult.NumStems += StemStreams[Bus] != INDEX_NONE ? 1 : 0;
+		}
+	}
+	Sandbox->EnableBusCapture(OutResult.NumStems > 0);
+
+	TUniquePtr<FAudioFeatureExtractor> Extractor;
+	if (Config.bWriteDataset)
+	{
+		Extractor = MakeUnique<FAudioFeatureExtractor>(Config.SampleRate, Config.FeatureConfig);
+		const int32 NumAnalysisFrames = NumBlocks * Config.BufferSize / Extractor->GetConfig().HopSize + 1;
+		OutResult.FrameFeatures.Reserve(NumAnalysisFrames * FAudioFeatureExtractor::NumFeatures);
+	}
+
+	TArray<float> AudioBuffer;
+	for (int32 Block = 0; Block < NumBlocks; ++Block)
+	{
+		Sandbox->Update(BlockTime, AudioBuffer);
+		Rendered.Append(AudioBuffer);
+
+		if (Extractor.IsValid())
+		{
+			Extractor->Process(AudioBuffer.GetData(), 2, Config.BufferSize, OutResult.FrameFeatures);
+		}
+
+		for (int32 Bus = 0; Bus < (int32)ESandboxBus::Count; ++Bus)
+		{
+			if (StemStreams[Bus] != INDEX_NONE)
+			{
+				StemWriter->Write(StemStreams[Bus], Sandbox->GetBusAudio((ESandboxBus)Bus).GetData(), Config.BufferSize);
+			}
+		}
+	}
+
+	for (int32 Bus = 0; Bus < (int32)ESandboxBus::Count; ++Bus)
+	{
+		if (StemStreams[Bus] != INDEX_NONE)
+		{
+			StemWriter->CloseStream(StemStreams[Bus]);
+		}
+	}
+
+	ExtractFeatures(Rendered, Config.SampleRate, OutResult.Features);
+
+	if (Config.bWriteAudio)
+	{
+		const FString Filename = FString::Printf(TEXT("%s/sweep_%05d.wav"), *Config.OutputDirectory, Point.Index);
+		OutResult.bAudioWritten = FWavWriter::WritePcm(Filename, Rendered, 2, (int32)Config.SampleRate,
+			Config.AudioFormat, Config.AudioDither, (uint32)Point.Index + 1);
+	}
+}
+
+void FParameterSweep::ApplyForkParameters(FSandboxManager& Sandbox, const FSweepPoint& Point) const
+{
+	FProceduralController* Controller = Sandbox.GetProceduralController();
+	FAudioPhysicsSandbox* AudioPhysics = Sandbox.GetAudioPhysics();
+
+	// Ranges are set as pairs; an unswept end keeps the value restored from the snapshot
+	float Min, Max;
+	Controller->GetFrequencyRange(Min, Max);
+	Controller->SetFrequencyRange(
+		GetValue(Point, ESweepTarget::FrequencyMin, Min),
+		GetValue(Point, ESweepTarget::FrequencyMax, Max));
+	Controller->GetAmplitudeRange(Min, Max);
+	Controller->SetAmplitudeRange(
+		GetValue(Point, ESweepTarget::AmplitudeMin, Min),
+		GetValue(Point, ESweepTarget::AmplitudeMax, Max));
+	Controller->GetDurationRange(Min, Max);
+	Controller->SetDurationRange(
+		GetValue(Point, ESweepTarget::DurationMin, Min),
+		GetValue(Point, ESweepTarget::DurationMax, Max));
+
+	for (int32 i = 0; i < Parameters.Num(); ++i)
+	{
+		switch (Parameters[i].Target)
+		{
+		case ESweepTarget::MaterialHardness:
+		{
+			// Harder materials shift the impact range upwards (see ARCHITECTURE.md)
+			const float HardnessScale = 0.2f + 0.8f * FMath::Clamp(Point.Values[i], 0.0f, 1.0f);
+			AudioPhysics->GetMapper()->SetFrequencyRange(100.0f * HardnessScale, 4000.0f * HardnessScale);
+			break;
+		}
+		case ESweepTarget::Seed:
+			Controller->SetSeed((uint32)FMath::RoundToInt(Point.Values[i]));
+			break;
+		case ESweepTarget::MasterVolume:
+			Sandbox.SetMasterVolume(Point.Values[i]);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+bool FParameterSweep::WriteFeatures() const
+{
+	std::ofstream Stream(*FString::Printf(TEXT("%s/features.csv"), *Config.OutputDirectory));
+	if (!Stream)
+	{
+		return false;
+	}
+
+	Stream << "point,prefix";
+	for (int32 i = 0; i < Parameters.Num(); ++i)
+	{
+		Stream << ",param" << i << "_" << (int32)Parameters[i].Target;
+	}
+	Stream << ",peak,rms,zcr,onset\n";
+
+	for (const FSweepResult& Result : Results)
+	{
+		Stream << Result.Point.Index << "," << Result.Point.PrefixIndex;
+		for (float Value : Result.Point.Values)
+		{
+			Stream << "," << Value;
+		}
+		Stream << "," << Result.Features.Peak
+			<< "," << Result.Features.RMS
+			<< "," << Result.Features.ZeroCrossingRate
+			<< "," << Result.Features.OnsetTime << "\n";
+	}
+
+	return (bool)Stream;
+}
+
+bool FParameterSweep::WriteDataset() const
+{
+	// One row per analysis frame: point, time, swept values, then the features
+	FFeatureDataset Dataset;
+	const int32 PointColumn = Dataset.AddColumn(TEXT("point"), EDatasetColumnType::Int32);
+	const int32 TimeColumn = Dataset.AddColumn(TEXT("time"));
+	const int32 FirstParameterColumn = Dataset.GetNumColumns();
+	for (int32 i = 0; i < Parameters.Num(); ++i)
+	{
+		Dataset.AddColumn(FString::Printf(TEXT("param%d_%d"), i, (int32)Parameters[i].Target));
+	}
+	const int32 FirstFeatureColumn = Dataset.GetNumColumns();
+	for (int32 Feature = 0; Feature < FAudioFeatureExtractor::NumFeatures; ++Feature)
+	{
+		Dataset.AddColumn(FAudioFeatureExtractor::GetFeatureName(Feature));
+	}
+
+	int32 NumRows = 0;
+	for (const FSweepResult& Result : Results)
+	{
+		NumRows += Result.FrameFeatures.Num() / FAudioFeatureExtractor::NumFeatures;
+	}
+	Dataset.Reserve(NumRows);
+
+	// Hop as normalised by the extractor
+	const float HopSeconds = FAudioFeatureExtractor(Config.SampleRate, Config.FeatureConfig).GetFrameTime(1);
+	for (const FSweepResult& Result : Results)
+	{
+		const int32 NumFrames = Result.FrameFeatures.Num() / FAudioFeatureExtractor::NumFeatures;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Dataset.AppendInt(PointColumn, Result.Point.Index);
+			Dataset.AppendFloat(TimeColumn, Frame * HopSeconds);
+			Dataset.AppendFloats(FirstParameterColumn, Result.Point.Values.GetData(), Result.Point.Values.Num());
+			Dataset.AppendFloats(FirstFeatureColumn, Result.FrameFeatures.GetData() + Frame * FAudioFeatureExtractor::NumFeatures,
+				FAudioFeatureExtractor::NumFeatures);
+		}
+	}
+
+	return Dataset.Write(FString::Printf(TEXT("%s/features.sbf"), *Config.OutputDirectory));
+}
+
+void FParameterSweep::DefaultSceneBuilder(FSandboxManager& Sandbox, const FParameterSweep& Sweep, const FSweepPoint& Point)
+{
+	auto Sphere = MakeShared<FPhysicsSphere>(0.5f, 2.0f);
+	Sphere->SetPosition(FVector3(0, Sweep.GetValue(Point, ESweepTarget::DropHeight, 5.0f), 0));
+	Sandbox.AddPhysicsObject(Sphere);
+}
+
+void FParameterSweep::ExtractFeatures(const TArray<float>& Interleaved, float SampleRate, FSweepFeatures& OutFeatures)
+{
+	const float OnsetThreshold = 0.01f; // -40 dBFS
+	const int32 NumFrames = Interleaved.Num() / 2;
+
+	float Peak = 0.0f;
+	double SumSquares = 0.0;
+	int32 Crossings = 0;
+	int32 OnsetFrame = INDEX_NONE;
+	float PreviousMono = 0.0f;
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const float Mono = 0.5f * (Interleaved[Frame * 2] + Interleaved[Frame * 2 + 1]);
+		const float Level = FMath::Abs(Mono);
+
+		Peak = FMath::Max(Peak, Level);
+		SumSquares += Mono * Mono;
+		if ((Mono >= 0.0f) != (PreviousMono >= 0.0f))
+		{
+			++Crossings;
+		}
+		if (OnsetFrame == INDEX_NONE && Level > OnsetThreshold)
+		{
+			OnsetFrame = Frame;
+		}
+		PreviousMono = Mono;
+	}
+
+	const float Seconds = NumFrames / SampleRate;
+	OutFeatures.Peak = Peak;
+	OutFeatures.RMS = NumFrames > 0 ? FMath::Sqrt((float)(SumSquares / NumFrames)) : 0.0f;
+	OutFeatures.ZeroCrossingRate = Seconds > 0.0f ? Crossings / Seconds : 0.0f;
+	OutFeatures.OnsetTime = OnsetFrame != INDEX_NONE ? OnsetFrame / SampleRate : -1.0f;
+}
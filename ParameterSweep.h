@@ -0,0 +1,218 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SandboxManager.h"
+#include "Audio/SampleFormat.h"
+#include "Offline/AsyncAudioWriter.h"
+#include "Offline/AudioFeatures.h"
+#include "MemoryAccounting.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * Parameters that a sweep can vary
+ * Scene parameters shape the lead-in; all others are applied to each fork
+ */
+enum class ESweepTarget : uint8
+{
+	DropHeight,        // Scene: height of the dropped body (m)
+	MaterialHardness,  // 0-1, scales the impact frequency range
+	FrequencyMin,      // FProceduralController frequency range (Hz)
+	FrequencyMax,
+	AmplitudeMin,      // FProceduralController amplitude range
+	AmplitudeMax,
+	DurationMin,       // FProceduralController duration range (s)
+	DurationMax,
+	Seed,              // Procedural seed (rounded to integer)
+	MasterVolume
+};
+
+/**
+ * How sweep points are laid out over the parameter ranges
+ */
+enum class ESweepDesign : uint8
+{
+	Grid,    // Cartesian product of per-parameter steps
+	Random   // Uniform random points, reproducible from RandomSeed
+};
+
+/**
+ * Sweep configuration
+ */
+struct FSweepConfig
+{
+	float SampleRate;
+	int32 BufferSize;
+	float LeadInSeconds;     // Shared simulation before the snapshot
+	float RenderSeconds;     // Rendered per point after the fork
+	ESweepDesign Design;
+	int32 NumRandomPoints;   // Random design only
+	uint32 RandomSeed;
+	int32 NumThreads;        // Cap on job system threads, caller included; 0 = all
+	bool bWriteAudio;
+	bool bWriteFeatures;     // Summary features of every point, written to features.csv
+	bool bWriteStems;        // One file per active mix bus, streamed while rendering
+	bool bWriteDataset;      // Per-frame features of every point, written to features.sbf
+	FAudioFeatureConfig FeatureConfig;
+	ESampleFormat AudioFormat;  // WAV sample format; integer formats are dithered
+	EDitherMode AudioDither;
+	FString OutputDirectory; // WAV files, stems, features.csv and features.sbf are written here
+
+	FSweepConfig()
+		: SampleRate(48000.0f)
+		, BufferSize(2048)
+		, LeadInSeconds(1.0f)
+		, RenderSeconds(2.0f)
+		, Design(ESweepDesign::Grid)
+		, NumRandomPoints(16)
+		, RandomSeed(12345)
+		, NumThreads(0)
+		, bWriteAudio(true)
+		, bWriteFeatures(true)
+		, bWriteStems(false)
+		, bWriteDataset(false)
+		, AudioFormat(ESampleFormat::Float32)
+		, AudioDither(EDitherMode::TPDF)
+		, OutputDirectory(".")
+	{
+	}
+};
+
+/**
+ * One point of the design: a value for every swept parameter
+ */
+struct FSweepPoint
+{
+	int32 Index;
+	int32 PrefixIndex;     // Shared lead-in this point forks from
+	TArray<float> Values;  // Same order as the sweep's parameters
+};
+
+/**
+ * Features extracted from a rendered point
+ */
+struct FSweepFeatures
+{
+	float Peak;
+	float RMS;
+	float ZeroCrossingRate; // Crossings per second, a cheap brightness proxy
+	float OnsetTime;        // Seconds until the level first exceeds -40 dBFS, -1 if never
+};
+
+struct FSweepResult
+{
+	FSweepPoint Point;
+	FSweepFeatures Features;
+	bool bAudioWritten;
+	int32 NumStems;        // Stem files opened for this point
+	TArray<float> FrameFeatures;   // bWriteDataset only: FAudioFeatureExtractor::NumFeatures values per analysis frame
+};
+
+/**
+ * Parameter sweep over forked sandboxes
+ *
+ * Points that agree on every scene parameter share one lead-in: it is
+ * simulated once, captured as a snapshot, and every point in the group
+ * forks from it. Lead-ins and points are rendered in parallel.
+ *
+ * With bWriteStems, every point also writes sweep_NNNNN_<bus>.wav for each
+ * mix bus its sandbox has active, in the same pass as the mix. Stems stream
+ * through one FAsyncAudioWriter, so disk writes overlap rendering and stem
+ * memory is bounded by the writer's block pool rather than the render length.
+ *
+ * With bWriteDataset, each block is analysed (MFCCs, spectral descriptors,
+ * onsets) on the worker that rendered it, straight after rendering, so
+ * analysis runs on every core in step with the audio. The frames of all
+ * points are written as one columnar FFeatureDataset, ready to memory-map.
+ */
+class FParameterSweep
+{
+public:
+	/** Builds the scene for a lead-in; scene parameter values are read from the point */
+	typedef TFunction<void(FSandboxManager&, const FParameterSweep&, const FSweepPoint&)> FSceneBuilder;
+
+	FParameterSweep(const FSweepConfig& InConfig = FSweepConfig());
+
+	/**
+	 * Add a swept parameter
+	 * @param Steps Grid design only: number of evenly spaced values (1 = Min only)
+	 * @return Parameter index into FSweepPoint::Values
+	 */
+	int32 AddParameter(ESweepTarget Target, float Min, float Max, int32 Steps = 2);
+
+	/** Replace the default scene (a single sphere dropped from DropHeight) */
+	void SetSceneBuilder(FSceneBuilder Builder) { SceneBuilder = MoveTemp(Builder); }
+
+	/**
+	 * Generate the design, render every point and write outputs
+	 * @return Number of points rendered
+	 */
+	int32 Run();
+
+	/**
+	 * Value of a parameter for a point
+	 * @return DefaultValue if the parameter is not swept
+	 */
+	float GetValue(const FSweepPoint& Point, ESweepTarget Target, float DefaultValue) const;
+
+	const TArray<FSweepResult>& GetResults() const { return Results; }
+	int32 GetNumPrefixes() const { return Prefixes.Num(); }
+
+	/** Lead-ins simulated again because the I/O memory budget evicted or refused their snapshot */
+	int32 GetNumResimulatedPrefixes() const { return NumResimulated.load(std::memory_order_relaxed); }
+	const FSweepConfig& GetConfig() const { return Config; }
+
+	static bool IsSceneParameter(ESweepTarget Target) { return Target == ESweepTarget::DropHeight; }
+
+private:
+	struct FSweepParameter
+	{
+		ESweepTarget Target;
+		float Min;
+		float Max;
+		int32 Steps;
+	};
+
+	struct FSweepPrefix
+	{
+		int32 FirstPoint;             // Representative point used to build the scene
+		int32 PendingPoints;          // Points yet to fork from it; the snapshot is dropped when none remain
+		FSandboxSnapshot Snapshot;    // Empty if evicted or refused
+		FMemoryCharge SnapshotMemory;
+
+		FSweepPrefix()
+			: FirstPoint(INDEX_NONE)
+			, PendingPoints(0)
+			, SnapshotMemory(EMemoryTag::IO)
+		{
+		}
+	};
+
+	FSweepConfig Config;
+	TArray<FSweepParameter> Parameters;
+	FSceneBuilder SceneBuilder;
+
+	TArray<FSweepPoint> Points;
+	TArray<FSweepPrefix> Prefixes;
+	TArray<FSweepResult> Results;
+
+	// Shared by all points while a run writes stems
+	TUniquePtr<FAsyncAudioWriter> StemWriter;
+
+	// Lead-in snapshots are a cache under the I/O budget; guards every prefix's Snapshot and PendingPoints during a run
+	std::mutex SnapshotLock;
+	std::atomic<int32> NumResimulated;
+
+	void BuildDesign();
+	void GroupPrefixes();
+	void SimulatePrefix(const FSweepPrefix& Prefix, FSandboxSnapshot& OutSnapshot);
+	void CacheSnapshot(FSweepPrefix& Prefix, const FSandboxSnapshot& Snapshot);
+	int64 EvictSnapshots(int64 BytesWanted);
+	void RenderPoint(const FSweepPoint& Point, FSweepResult& OutResult);
+	void ApplyForkParameters(FSandboxManager& Sandbox, const FSweepPoint& Point) const;
+	bool WriteFeatures() const;
+	bool WriteDataset() const;
+
+	static void DefaultSceneBuilder(FSandboxManager& Sandbox, const FParameterSweep& Sweep, const FSweepPoint& Point);
+	static void ExtractFeatures(const TArray<float>& Interleaved, float SampleRate, FSweepFeatures& OutFeatures);
+};
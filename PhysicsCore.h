@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Containers/List.h"
+#include "SandboxArchive.h"
+#include "StaticCapacity.h"
 
 /**
  * 3D vector structure for physics calculations
@@ -47,6 +49,15 @@ struct FVector3
 	}
 };
 
+/**
+ * Collision shape of a physics object (used to rebuild bodies from snapshots)
+ */
+enum class EPhysicsShape : uint8
+{
+	Point,
+	Sphere
+};
+
 /**
  * Base physics object with rigid body dynamics
  */
@@ -79,6 +90,13 @@ public:
 	void SetDamping(float NewDamping) { Damping = FMath::Clamp(NewDamping, 0.0f, 1.0f); }
 	float GetDamping() const { return Damping; }
 
+	// Snapshot support
+	virtual EPhysicsShape GetShape() const { return EPhysicsShape::Point; }
+	virtual void Serialize(FSandboxArchive& Ar)
+	{
+		Ar << Position << Velocity << Acceleration << TotalForce << Mass << Damping;
+	}
+
 protected:
 	FVector3 Position;
 	FVector3 Velocity;
@@ -99,6 +117,13 @@ public:
 	float GetRadius() const { return Radius; }
 	void SetRadius(float NewRadius) { Radius = FMath::Max(NewRadius, 0.1f); }
 
+	virtual EPhysicsShape GetShape() const override { return EPhysicsShape::Sphere; }
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		FPhysicsObject::Serialize(Ar);
+		Ar << Radius;
+	}
+
 	/**
 	 * Check collision with another sphere
 	 * @param Other Another sphere
@@ -116,6 +141,9 @@ private:
 	float Radius;
 };
 
+/** Bodies of a world, bounded by FSandboxCapacity::MaxBodies in the static-capacity profile */
+using FPhysicsObjectArray = TSandboxArray<TSharedPtr<FPhysicsObject>, FSandboxCapacity::MaxBodies>;
+
 /**
  * Physics world manager handling object interactions
  */
@@ -133,10 +161,13 @@ public:
 	const FVector3& GetGravity() const { return Gravity; }
 
 	// Access objects for impact detection
-	const TArray<TSharedPtr<FPhysicsObject>>& GetObjects() const { return PhysicsObjects; }
+	const FPhysicsObjectArray& GetObjects() const { return PhysicsObjects; }
+
+	/** Room for NumObjects bodies without reallocating */
+	void Reserve(int32 NumObjects) { PhysicsObjects.Reserve(NumObjects); }
 
 private:
-	TArray<TSharedPtr<FPhysicsObject>> PhysicsObjects;
+	FPhysicsObjectArray PhysicsObjects;
 	FVector3 Gravity;
 
 	void DetectCollisions();
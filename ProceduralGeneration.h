@@ -2,6 +2,20 @@
 
 #include "CoreMinimal.h"
 #include "Containers/List.h"
+#include "SandboxArchive.h"
+
+/**
+ * Built-in generator types, recorded in snapshots so forks can rebuild them
+ */
+enum class EProceduralGeneratorType : uint8
+{
+	Custom,
+	PerlinNoise,
+	Chaotic,
+	Spectral,
+	Markov,
+	Expression
+};
 
 /**
  * Base interface for procedural parameter generation
@@ -20,6 +34,20 @@ public:
 
 	virtual void Reset() = 0;
 	virtual void SetSeed(uint32 InSeed) = 0;
+
+	/**
+	 * Snapshot support: save or restore seeds, RNG counters and time
+	 * Custom generators keep their live state unless they override this
+	 */
+	virtual EProceduralGeneratorType GetGeneratorType() const { return EProceduralGeneratorType::Custom; }
+	virtual void Serialize(FSandboxArchive& /*Ar*/) {}
+
+	/**
+	 * Set a named input, for generators that take external values
+	 * Called per block for bound parameters, so implementations must not allocate
+	 * @return false if the generator has no such input
+	 */
+	virtual bool SetInput(const TCHAR* /*Name*/, float /*Value*/) { return false; }
 };
 
 /**
@@ -39,6 +67,12 @@ public:
 	void SetPersistence(float InPersistence) { Persistence = FMath::Clamp(InPersistence, 0.0f, 1.0f); }
 	void SetScale(float InScale) { Scale = FMath::Max(InScale, 0.1f); }
 
+	virtual EProceduralGeneratorType GetGeneratorType() const override { return EProceduralGeneratorType::PerlinNoise; }
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		Ar << Seed << CurrentTime << Octaves << Persistence << Scale;
+	}
+
 private:
 	uint32 Seed;
 	float CurrentTime;
@@ -73,6 +107,12 @@ public:
 	void SetChaosParameter(float Value) { ChaosParam = FMath::Clamp(Value, 0.0f, 4.0f); }
 	EChaosType GetType() const { return ChaoticType; }
 
+	virtual EProceduralGeneratorType GetGeneratorType() const override { return EProceduralGeneratorType::Chaotic; }
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		Ar << ChaoticType << ChaosParam << X << Y;
+	}
+
 private:
 	EChaosType ChaoticType;
 	float ChaosParam;
@@ -106,6 +146,12 @@ public:
 
 	int32 GetHarmonicCount() const { return Harmonics.Num(); }
 
+	virtual EProceduralGeneratorType GetGeneratorType() const override { return EProceduralGeneratorType::Spectral; }
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		Ar << Harmonics << SampleCount << CurrentTime;
+	}
+
 private:
 	struct FHarmonic
 	{
@@ -140,6 +186,12 @@ public:
 	 */
 	void AddTransition(float FromState, float ToState, float Probability);
 
+	virtual EProceduralGeneratorType GetGeneratorType() const override { return EProceduralGeneratorType::Markov; }
+	virtual void Serialize(FSandboxArchive& Ar) override
+	{
+		Ar << Order << CurrentState << RandomSeed << Transitions;
+	}
+
 private:
 	struct FStateTransition
 	{
@@ -156,6 +208,32 @@ private:
 	float SelectNextState();
 };
 
+/**
+ * Parameters produced by FProceduralController, one generator slot each
+ */
+enum class EProceduralParameter : uint8
+{
+	Frequency,
+	Amplitude,
+	SpectralRichness,
+	Duration,
+
+	Count
+};
+
+/**
+ * Feeds one parameter's value into a named input of another parameter's generator
+ * Plain data so bindings travel with snapshots
+ */
+struct FProceduralBinding
+{
+	static constexpr int32 MaxInputNameLength = 32;
+
+	EProceduralParameter Target;
+	EProceduralParameter Source;
+	TCHAR InputName[MaxInputNameLength];
+};
+
 /**
  * Procedural parameter controller
  * Manages multiple generators for complex audio parameter evolution
@@ -184,13 +262,94 @@ public:
 	void SetSpectralGenerator(TUniquePtr<FProceduralGenerator> Gen);
 	void SetDurationGenerator(TUniquePtr<FProceduralGenerator> Gen);
 
+	void SetGenerator(EProceduralParameter Slot, TUniquePtr<FProceduralGenerator> Gen)
+	{
+		switch (Slot)
+		{
+		case EProceduralParameter::Frequency:        SetFrequencyGenerator(MoveTemp(Gen)); break;
+		case EProceduralParameter::Amplitude:        SetAmplitudeGenerator(MoveTemp(Gen)); break;
+		case EProceduralParameter::SpectralRichness: SetSpectralGenerator(MoveTemp(Gen)); break;
+		case EProceduralParameter::Duration:         SetDurationGenerator(MoveTemp(Gen)); break;
+		default:                                     break;
+		}
+	}
+
+	/**
+	 * Swap in a generator and hand back the one it replaces instead of destroying it
+	 * Lets a real-time caller leave the deletion to another thread
+	 */
+	TUniquePtr<FProceduralGenerator> ExchangeGenerator(EProceduralParameter Slot, TUniquePtr<FProceduralGenerator> Gen)
+	{
+		TUniquePtr<FProceduralGenerator>& Current = GetGeneratorSlot(Slot);
+		TUniquePtr<FProceduralGenerator> Previous = MoveTemp(Current);
+		Current = MoveTemp(Gen);
+		CachedEpoch[(int32)Slot] = 0;
+		return Previous;
+	}
+
+	/** The generator driving a slot, or null if the slot has none */
+	const FProceduralGenerator* GetGenerator(EProceduralParameter Slot) const
+	{
+		switch (Slot)
+		{
+		case EProceduralParameter::Frequency:        return FrequencyGen.Get();
+		case EProceduralParameter::Amplitude:        return AmplitudeGen.Get();
+		case EProceduralParameter::SpectralRichness: return SpectralGen.Get();
+		default:                                     return DurationGen.Get();
+		}
+	}
+
 	void SetFrequencyRange(float MinHz, float MaxHz);
 	void SetAmplitudeRange(float MinAmp, float MaxAmp);
 	void SetDurationRange(float MinSec, float MaxSec);
 
+	void GetFrequencyRange(float& OutMinHz, float& OutMaxHz) const { OutMinHz = FreqMin; OutMaxHz = FreqMax; }
+	void GetAmplitudeRange(float& OutMinAmp, float& OutMaxAmp) const { OutMinAmp = AmpMin; OutMaxAmp = AmpMax; }
+	void GetDurationRange(float& OutMinSec, float& OutMaxSec) const { OutMinSec = DurMin; OutMaxSec = DurMax; }
+
 	void SetSeed(uint32 NewSeed);
 	void Reset();
 
+	// Lazy evaluation
+	/**
+	 * Start a new block, invalidating memoized parameter values
+	 * A generator advances at most once per block, and only if its parameter is read
+	 */
+	void BeginBlock() { ++BlockEpoch; }
+
+	/**
+	 * Value of a parameter for the current block, mapped to its range
+	 * Evaluated on first read; parameters bound to its inputs are pulled first
+	 */
+	float GetParameter(EProceduralParameter Param);
+
+	static constexpr int32 MaxBindings = 16;
+
+	/**
+	 * Feed Source's value into the input InputName of Target's generator
+	 * Source is only evaluated when Target is, so unread chains cost nothing
+	 * @return false if the binding would form a cycle, the name is too long or the table is full
+	 */
+	bool BindInput(EProceduralParameter Target, const FString& InputName, EProceduralParameter Source);
+	void ClearBindings(EProceduralParameter Target);
+
+	/** Parameters evaluated in the current block, one bit per EProceduralParameter */
+	uint32 GetEvaluatedMask() const
+	{
+		uint32 Mask = 0;
+		for (int32 i = 0; i < NumParameters; ++i)
+		{
+			Mask |= (CachedEpoch[i] == BlockEpoch) ? (1u << i) : 0u;
+		}
+		return Mask;
+	}
+
+	/**
+	 * Save or restore ranges and generator states
+	 * Built-in generators missing from this controller are recreated on load
+	 */
+	void Serialize(FSandboxArchive& Ar);
+
 private:
 	TUniquePtr<FProceduralGenerator> FrequencyGen;
 	TUniquePtr<FProceduralGenerator> AmplitudeGen;
@@ -201,7 +360,20 @@ private:
 	float AmpMin, AmpMax;
 	float DurMin, DurMax;
 
+	// Per-block memoization; an entry is valid while its epoch equals BlockEpoch
+	static constexpr int32 NumParameters = (int32)EProceduralParameter::Count;
+	float CachedValue[NumParameters] = {};
+	uint32 CachedEpoch[NumParameters] = {};
+	uint32 BlockEpoch = 1;
+	bool bEvaluating[NumParameters] = {};
+	TArray<FProceduralBinding> Bindings;
+
+	TUniquePtr<FProceduralGenerator>& GetGeneratorSlot(EProceduralParameter Param);
+	bool DependsOn(EProceduralParameter Param, EProceduralParameter Dependency) const;
+	bool ValidateBindings();
+
 	float MapRange(float Value, float OutMin, float OutMax);
+	static void SerializeGenerator(FSandboxArchive& Ar, TUniquePtr<FProceduralGenerator>& Gen);
 };
 
 /**
@@ -231,3 +403,195 @@ private:
 
 	void AnalyzeMetrics(const TArray<float>& Metrics, TArray<float>& OutAnalysis);
 };
+
+/** Defined with FExpressionGenerator; the generator rebuilds its program from the snapshot */
+TUniquePtr<FProceduralGenerator> CreateExpressionGenerator();
+
+/**
+ * Create a default instance of a built-in generator type
+ * @return nullptr for Custom generators, which cannot be rebuilt from a snapshot
+ */
+inline TUniquePtr<FProceduralGenerator> CreateProceduralGenerator(EProceduralGeneratorType Type)
+{
+	switch (Type)
+	{
+	case EProceduralGeneratorType::PerlinNoise: return MakeUnique<FPerlinNoiseGenerator>();
+	case EProceduralGeneratorType::Chaotic:     return MakeUnique<FChaoticGenerator>();
+	case EProceduralGeneratorType::Spectral:    return MakeUnique<FSpectralGenerator>();
+	case EProceduralGeneratorType::Markov:      return MakeUnique<FMarkovGenerator>();
+	case EProceduralGeneratorType::Expression:  return CreateExpressionGenerator();
+	default:                                    return nullptr;
+	}
+}
+
+inline void FProceduralController::SerializeGenerator(FSandboxArchive& Ar, TUniquePtr<FProceduralGenerator>& Gen)
+{
+	bool bHasGenerator = Gen.IsValid();
+	EProceduralGeneratorType Type = bHasGenerator ? Gen->GetGeneratorType() : EProceduralGeneratorType::Custom;
+	Ar << bHasGenerator << Type;
+
+	int32 Size = 0;
+	const int32 Marker = Ar.BeginSection(Size);
+
+	if (Ar.IsLoading())
+	{
+		if (!bHasGenerator)
+		{
+			Gen.Reset();
+		}
+		else if (!Gen.IsValid() || Gen->GetGeneratorType() != Type)
+		{
+			if (TUniquePtr<FProceduralGenerator> Rebuilt = CreateProceduralGenerator(Type))
+			{
+				Gen = MoveTemp(Rebuilt);
+			}
+		}
+
+		if (!Gen.IsValid() || Gen->GetGeneratorType() != Type)
+		{
+			Ar.Skip(Size);
+			return;
+		}
+	}
+
+	if (Gen.IsValid())
+	{
+		Gen->Serialize(Ar);
+	}
+	Ar.EndSection(Marker);
+}
+
+inline void FProceduralController::Serialize(FSandboxArchive& Ar)
+{
+	Ar << FreqMin << FreqMax << AmpMin << AmpMax << DurMin << DurMax;
+	SerializeGenerator(Ar, FrequencyGen);
+	SerializeGenerator(Ar, AmplitudeGen);
+	SerializeGenerator(Ar, SpectralGen);
+	SerializeGenerator(Ar, DurationGen);
+	Ar << Bindings;
+	if (Ar.IsLoading() && !ValidateBindings())
+	{
+		Bindings.Reset();
+		Ar.SetError();
+	}
+
+	// Memoized values belong to the block in which they were read
+	++BlockEpoch;
+}
+
+inline TUniquePtr<FProceduralGenerator>& FProceduralController::GetGeneratorSlot(EProceduralParameter Param)
+{
+	switch (Param)
+	{
+	case EProceduralParameter::Frequency:        return FrequencyGen;
+	case EProceduralParameter::Amplitude:        return AmplitudeGen;
+	case EProceduralParameter::SpectralRichness: return SpectralGen;
+	default:                                     return DurationGen;
+	}
+}
+
+inline float FProceduralController::GetParameter(EProceduralParameter Param)
+{
+	const int32 Index = (int32)Param;
+	if (CachedEpoch[Index] == BlockEpoch || bEvaluating[Index])
+	{
+		return CachedValue[Index];
+	}
+
+	bEvaluating[Index] = true;
+
+	FProceduralGenerator* Gen = GetGeneratorSlot(Param).Get();
+	float Normalized = 0.5f;
+	if (Gen)
+	{
+		for (const FProceduralBinding& Binding : Bindings)
+		{
+			if (Binding.Target == Param)
+			{
+				Gen->SetInput(Binding.InputName, GetParameter(Binding.Source));
+			}
+		}
+		Normalized = Gen->GetNextValue();
+	}
+
+	switch (Param)
+	{
+	case EProceduralParameter::Frequency: CachedValue[Index] = FreqMin + Normalized * (FreqMax - FreqMin); break;
+	case EProceduralParameter::Amplitude: CachedValue[Index] = AmpMin + Normalized * (AmpMax - AmpMin); break;
+	case EProceduralParameter::Duration:  CachedValue[Index] = DurMin + Normalized * (DurMax - DurMin); break;
+	default:                              CachedValue[Index] = Normalized; break;
+	}
+
+	CachedEpoch[Index] = BlockEpoch;
+	bEvaluating[Index] = false;
+	return CachedValue[Index];
+}
+
+inline bool FProceduralController::DependsOn(EProceduralParameter Param, EProceduralParameter Dependency) const
+{
+	if (Param == Dependency)
+	{
+		return true;
+	}
+	for (const FProceduralBinding& Binding : Bindings)
+	{
+		if (Binding.Target == Param && DependsOn(Binding.Source, Dependency))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+inline bool FProceduralController::BindInput(EProceduralParameter Target, const FString& InputName, EProceduralParameter Source)
+{
+	if (Bindings.Num() >= MaxBindings
+		|| InputName.Len() >= FProceduralBinding::MaxInputNameLength
+		|| DependsOn(Source, Target))
+	{
+		return false;
+	}
+
+	FProceduralBinding Binding;
+	Binding.Target = Target;
+	Binding.Source = Source;
+	FMemory::Memzero(Binding.InputName, sizeof(Binding.InputName));
+	FMemory::Memcpy(Binding.InputName, *InputName, sizeof(TCHAR) * InputName.Len());
+	Bindings.Add(Binding);
+	return true;
+}
+
+inline bool FProceduralController::ValidateBindings()
+{
+	if (Bindings.Num() > MaxBindings)
+	{
+		return false;
+	}
+
+	// Re-added one at a time so a cycle is rejected before DependsOn could follow it
+	TArray<FProceduralBinding> Loaded = MoveTemp(Bindings);
+	Bindings.Reset();
+	for (const FProceduralBinding& Binding : Loaded)
+	{
+		if ((uint8)Binding.Target >= (uint8)EProceduralParameter::Count
+			|| (uint8)Binding.Source >= (uint8)EProceduralParameter::Count
+			|| Binding.InputName[FProceduralBinding::MaxInputNameLength - 1] != 0
+			|| DependsOn(Binding.Source, Binding.Target))
+		{
+			return false;
+		}
+		Bindings.Add(Binding);
+	}
+	return true;
+}
+
+inline void FProceduralController::ClearBindings(EProceduralParameter Target)
+{
+	for (int32 i = Bindings.Num() - 1; i >= 0; --i)
+	{
+		if (Bindings[i].Target == Target)
+		{
+			Bindings.RemoveAt(i);
+		}
+	}
+}
@@ -0,0 +1,310 @@
+#include "RealTimeThreads.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#define SANDBOX_HAS_REALTIME 1
+#else
+#define SANDBOX_HAS_REALTIME 0
+#endif
+
+namespace
+{
+	void AddEntry(FRealTimeReport& Report, const FString& Item, bool bGranted, const FString& Detail)
+	{
+		FRealTimeReport::FEntry Entry;
+		Entry.Item = Item;
+		Entry.bGranted = bGranted;
+		Entry.Detail = Detail;
+		Report.Entries.Add(Entry);
+	}
+
+#if SANDBOX_HAS_REALTIME
+	FString DescribeError(int Error)
+	{
+		if (Error == EPERM)
+		{
+			return TEXT("not permitted (needs CAP_SYS_NICE or a higher RLIMIT_RTPRIO)");
+		}
+		return FString(std::strerror(Error));
+	}
+
+	/** @return 0 or an errno value; OutPriority receives the priority actually set */
+	int SetScheduling(pthread_t Thread, const FThreadSchedule& Schedule, int32& OutPriority)
+	{
+		const int Policy = Schedule.Policy == EThreadPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+		OutPriority = FMath::Clamp(Schedule.Priority, (int32)sched_get_priority_min(Policy), (int32)sched_get_priority_max(Policy));
+
+		sched_param Param;
+		std::memset(&Param, 0, sizeof(Param));
+		Param.sched_priority = OutPriority;
+		return pthread_setschedparam(Thread, Policy, &Param);
+	}
+
+	/** @return 0 or an errno value */
+	int SetAffinity(pthread_t Thread, const int32* Cores, int32 NumCores)
+	{
+		cpu_set_t Set;
+		CPU_ZERO(&Set);
+		for (int32 i = 0; i < NumCores; ++i)
+		{
+			if (Cores[i] < 0 || Cores[i] >= CPU_SETSIZE)
+			{
+				return EINVAL;
+			}
+			CPU_SET(Cores[i], &Set);
+		}
+		return pthread_setaffinity_np(Thread, sizeof(Set), &Set);
+	}
+
+	FString DescribeCores(const int32* Cores, int32 NumCores)
+	{
+		FString Text;
+		for (int32 i = 0; i < NumCores; ++i)
+		{
+			Text += FString::Printf(i == 0 ? TEXT("%d") : TEXT(",%d"), Cores[i]);
+		}
+		return Text;
+	}
+
+	// Stack left unprefaulted for the calls that run after the prefault and for signal handlers
+	constexpr int64 StackMarginBytes = 64 * 1024;
+
+	/** Bytes of stack left below this frame, less StackMarginBytes; INDEX_NONE if the OS will not say */
+	int64 GetUsableStackBytes()
+	{
+		pthread_attr_t Attributes;
+		if (pthread_getattr_np(pthread_self(), &Attributes) != 0)
+		{
+			return INDEX_NONE;
+		}
+		void* StackLow = nullptr;
+		size_t StackSize = 0;
+		const int Error = pthread_attr_getstack(&Attributes, &StackLow, &StackSize);
+		pthread_attr_destroy(&Attributes);
+		if (Error != 0)
+		{
+			return INDEX_NONE;
+		}
+
+		// The stack grows down towards StackLow
+		volatile uint8 Marker = 0;
+		const int64 Remaining = (int64)(reinterpret_cast<uintptr_t>(&Marker) - reinterpret_cast<uintptr_t>(StackLow));
+		return FMath::Max(Remaining - StackMarginBytes, (int64)0);
+	}
+
+	/** Touch every page of Bytes of stack below this frame; Bytes must fit in GetUsableStackBytes */
+	void PrefaultStack(int32 Bytes)
+	{
+		volatile uint8* Stack = static_cast<volatile uint8*>(alloca(Bytes));
+		const long PageSize = sysconf(_SC_PAGESIZE);
+		for (int32 Offset = 0; Offset < Bytes; Offset += (int32)PageSize)
+		{
+			Stack[Offset] = 0;
+		}
+	}
+#endif
+}
+
+const TCHAR* GetThreadPolicyName(EThreadPolicy Policy)
+{
+	switch (Policy)
+	{
+	case EThreadPolicy::Default:    return TEXT("default");
+	case EThreadPolicy::Fifo:       return TEXT("fifo");
+	case EThreadPolicy::RoundRobin: return TEXT("rr");
+	default:                        return TEXT("unknown");
+	}
+}
+
+// ============================================================================
+// FRealTimeReport Implementation
+// ============================================================================
+
+bool FRealTimeReport::AllGranted() const
+{
+	for (const FEntry& Entry : Entries)
+	{
+		if (!Entry.bGranted)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FString FRealTimeReport::ToString() const
+{
+	if (Entries.Num() == 0)
+	{
+		return TEXT("Real-time setup: nothing requested\n");
+	}
+
+	FString Text = TEXT("Real-time setup:\n");
+	for (const FEntry& Entry : Entries)
+	{
+		Text += FString::Printf(TEXT("  %-24s %-8s %s\n"), *Entry.Item, Entry.bGranted ? TEXT("granted") : TEXT("DENIED"), *Entry.Detail);
+	}
+	return Text;
+}
+
+// ============================================================================
+// ApplyRealTimeConfig Implementation
+// ============================================================================
+
+bool ApplyRealTimeConfig(const FRealTimeConfig& Config, FJobSystem& Jobs, FRealTimeReport& OutReport)
+{
+	OutReport.Entries.Reset();
+
+#if SANDBOX_HAS_REALTIME
+	// Lock first, so the prefaulted pages below stay resident
+	if (Config.bLockMemory)
+	{
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+		{
+			AddEntry(OutReport, TEXT("memory lock"), true, TEXT("current and future pages"));
+		}
+		else
+		{
+			const int Error = errno;
+			rlimit Limit;
+			getrlimit(RLIMIT_MEMLOCK, &Limit);
+			AddEntry(OutReport, TEXT("memory lock"), false, Limit.rlim_cur == RLIM_INFINITY
+				? DescribeError(Error)
+				: FString::Printf(TEXT("%s; RLIMIT_MEMLOCK is %llu KB"), std::strerror(Error), (unsigned long long)(Limit.rlim_cur / 1024)));
+		}
+	}
+
+	if (Config.bKeepHeapResident)
+	{
+		// Keep freed memory in the heap instead of returning it to the OS
+		const bool bResident = mallopt(M_TRIM_THRESHOLD, -1) != 0 && mallopt(M_MMAP_MAX, 0) != 0;
+		AddEntry(OutReport, TEXT("heap resident"), bResident, bResident
+			? TEXT("no trimming or mmap'd blocks, process-wide")
+			: TEXT("mallopt refused"));
+	}
+
+	if (Config.PrefaultHeapBytes > 0)
+	{
+		uint8* Heap = static_cast<uint8*>(std::malloc(Config.PrefaultHeapBytes));
+		if (Heap)
+		{
+			const long PageSize = sysconf(_SC_PAGESIZE);
+			for (int32 Offset = 0; Offset < Config.PrefaultHeapBytes; Offset += (int32)PageSize)
+			{
+				Heap[Offset] = 0;
+			}
+			std::free(Heap);
+		}
+		AddEntry(OutReport, TEXT("heap prefault"), Heap != nullptr, Heap == nullptr
+			? FString(TEXT("allocation failed"))
+			: FString::Printf(TEXT("%d KB%s"), Config.PrefaultHeapBytes / 1024,
+				Config.bKeepHeapResident ? TEXT("") : TEXT(", but the allocator may trim it without bKeepHeapResident")));
+	}
+
+	if (Config.PrefaultStackBytes > 0)
+	{
+		// Clamped so a large request is refused instead of overflowing the render thread's stack
+		const int64 UsableBytes = GetUsableStackBytes();
+		if (UsableBytes == INDEX_NONE)
+		{
+			AddEntry(OutReport, TEXT("stack prefault"), false, TEXT("stack bounds of the render thread unknown"));
+		}
+		else if (Config.PrefaultStackBytes > UsableBytes)
+		{
+			PrefaultStack((int32)UsableBytes);
+			AddEntry(OutReport, TEXT("stack prefault"), false, FString::Printf(TEXT("%d KB requested, but only %d KB of stack is left; prefaulted that"),
+				Config.PrefaultStackBytes / 1024, (int32)(UsableBytes / 1024)));
+		}
+		else
+		{
+			PrefaultStack(Config.PrefaultStackBytes);
+			AddEntry(OutReport, TEXT("stack prefault"), true, FString::Printf(TEXT("%d KB on the render thread"), Config.PrefaultStackBytes / 1024));
+		}
+	}
+
+	if (Config.RenderThread.Policy != EThreadPolicy::Default)
+	{
+		int32 Priority = 0;
+		const int Error = SetScheduling(pthread_self(), Config.RenderThread, Priority);
+		AddEntry(OutReport, TEXT("render thread priority"), Error == 0, Error == 0
+			? FString::Printf(TEXT("%s %d"), GetThreadPolicyName(Config.RenderThread.Policy), Priority)
+			: DescribeError(Error));
+	}
+
+	if (Config.RenderThread.Cores.Num() > 0)
+	{
+		const TArray<int32>& Cores = Config.RenderThread.Cores;
+		const int Error = SetAffinity(pthread_self(), Cores.GetData(), Cores.Num());
+		AddEntry(OutReport, TEXT("render thread cores"), Error == 0, Error == 0
+			? DescribeCores(Cores.GetData(), Cores.Num())
+			: DescribeError(Error));
+	}
+
+	const int32 NumRealTimeWorkers = Jobs.GetNumRealTimeWorkers();
+	if (Config.WorkerThreads.Policy != EThreadPolicy::Default)
+	{
+		int32 NumGranted = 0;
+		int32 Priority = 0;
+		int LastError = 0;
+		for (int32 Worker = 0; Worker < NumRealTimeWorkers; ++Worker)
+		{
+			const int Error = SetScheduling(Jobs.GetWorkerNativeHandle(Worker), Config.WorkerThreads, Priority);
+			NumGranted += Error == 0 ? 1 : 0;
+			LastError = Error != 0 ? Error : LastError;
+		}
+		AddEntry(OutReport, TEXT("worker priority"), NumRealTimeWorkers > 0 && NumGranted == NumRealTimeWorkers,
+			NumRealTimeWorkers == 0 ? FString(TEXT("the job system has no real-time workers"))
+			: NumGranted == NumRealTimeWorkers
+			? FString::Printf(TEXT("%s %d on %d real-time workers"), GetThreadPolicyName(Config.WorkerThreads.Policy), Priority, NumGranted)
+			: FString::Printf(TEXT("%d of %d real-time workers: %s"), NumGranted, NumRealTimeWorkers, *DescribeError(LastError)));
+	}
+
+	if (Config.WorkerThreads.Cores.Num() > 0)
+	{
+		const TArray<int32>& Cores = Config.WorkerThreads.Cores;
+		int32 NumGranted = 0;
+		int LastError = 0;
+		for (int32 Worker = 0; Worker < NumRealTimeWorkers; ++Worker)
+		{
+			const int Error = SetAffinity(Jobs.GetWorkerNativeHandle(Worker), &Cores[Worker % Cores.Num()], 1);
+			NumGranted += Error == 0 ? 1 : 0;
+			LastError = Error != 0 ? Error : LastError;
+		}
+		AddEntry(OutReport, TEXT("worker cores"), NumRealTimeWorkers > 0 && NumGranted == NumRealTimeWorkers,
+			NumRealTimeWorkers == 0 ? FString(TEXT("the job system has no real-time workers"))
+			: NumGranted == NumRealTimeWorkers
+			? FString::Printf(TEXT("%d real-time workers over %s"), NumGranted, *DescribeCores(Cores.GetData(), Cores.Num()))
+			: FString::Printf(TEXT("%d of %d real-time workers: %s"), NumGranted, NumRealTimeWorkers, *DescribeError(LastError)));
+	}
+#else
+	const FString Unsupported = TEXT("not supported on this platform");
+	if (Config.bLockMemory)
+	{
+		AddEntry(OutReport, TEXT("memory lock"), false, Unsupported);
+	}
+	if (Config.PrefaultHeapBytes > 0 || Config.PrefaultStackBytes > 0 || Config.bKeepHeapResident)
+	{
+		AddEntry(OutReport, TEXT("prefault"), false, Unsupported);
+	}
+	if (Config.RenderThread.Policy != EThreadPolicy::Default || Config.RenderThread.Cores.Num() > 0)
+	{
+		AddEntry(OutReport, TEXT("render thread"), false, Unsupported);
+	}
+	if (Config.WorkerThreads.Policy != EThreadPolicy::Default || Config.WorkerThreads.Cores.Num() > 0)
+	{
+		AddEntry(OutReport, TEXT("workers"), false, Unsupported);
+	}
+	(void)Jobs;
+#endif
+
+	return OutReport.AllGranted();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JobSystem.h"
+
+/**
+ * OS scheduling class for a thread
+ */
+enum class EThreadPolicy : uint8
+{
+	Default,      // Leave the thread as the OS started it
+	Fifo,         // SCHED_FIFO: runs until it blocks or a higher priority preempts it
+	RoundRobin    // SCHED_RR: as Fifo, time-sliced among equal priorities
+};
+
+const TCHAR* GetThreadPolicyName(EThreadPolicy Policy);
+
+/**
+ * Scheduling and placement for one group of threads
+ */
+struct FThreadSchedule
+{
+	EThreadPolicy Policy;
+	int32 Priority;          // 1-99 for Fifo and RoundRobin, clamped to what the OS allows
+	TArray<int32> Cores;     // CPUs to pin to; empty = no pinning
+
+	FThreadSchedule()
+		: Policy(EThreadPolicy::Default)
+		, Priority(0)
+	{
+	}
+};
+
+/**
+ * Real-time setup applied once at startup, before the first block is rendered
+ */
+struct FRealTimeConfig
+{
+	FThreadSchedule RenderThread;    // The thread calling ApplyRealTimeConfig, normally the audio callback thread
+	FThreadSchedule WorkerThreads;   // Real-time job workers only; worker i is pinned to Cores[i % Cores.Num()]
+	bool bLockMemory;                // Lock current and future pages (mlockall); also faults in every mapped page
+	int32 PrefaultStackBytes;        // Stack touched on the render thread so deep calls never fault; refused beyond the stack left
+	int32 PrefaultHeapBytes;         // Heap touched then freed, so later allocations reuse resident pages (see bKeepHeapResident)
+
+	/**
+	 * Stop the allocator returning memory to the OS (glibc mallopt: no trimming, no mmap'd blocks),
+	 * so prefaulted heap stays mapped. Process-wide and permanent: every large allocation in the
+	 * process, offline sweeps included, then comes from the main heap and is never given back.
+	 */
+	bool bKeepHeapResident;
+
+	FRealTimeConfig()
+		: bLockMemory(false)
+		, PrefaultStackBytes(0)
+		, PrefaultHeapBytes(0)
+		, bKeepHeapResident(false)
+	{
+	}
+};
+
+/**
+ * What the OS granted for each requested item
+ */
+struct FRealTimeReport
+{
+	struct FEntry
+	{
+		FString Item;
+		bool bGranted;
+		FString Detail;   // What was applied, or why it was refused
+	};
+
+	TArray<FEntry> Entries;
+
+	bool AllGranted() const;
+
+	/** One line per entry, for the startup log */
+	FString ToString() const;
+};
+
+/**
+ * Apply scheduling, pinning and memory locking
+ * Nothing requested is fatal: refusals (usually missing CAP_SYS_NICE or
+ * CAP_IPC_LOCK, or a low RLIMIT_RTPRIO / RLIMIT_MEMLOCK) are listed in the
+ * report and the engine carries on with what it was given.
+ * With bLockMemory, later allocations beyond RLIMIT_MEMLOCK fail, so size the limit for the whole process.
+ * The sandbox renders physics and audio on the thread calling Update (RenderThread) and submits no
+ * real-time jobs itself; the real-time lane carries whatever the host submits to it, and the engine's
+ * own jobs (parameter sweeps) run on the background lane.
+ * @param Jobs Job system whose real-time workers, which take only real-time lane jobs, get WorkerThreads;
+ *        its general workers, which take the physics and background lanes, keep the default scheduling
+ * @return true if everything requested was granted
+ */
+bool ApplyRealTimeConfig(const FRealTimeConfig& Config, FJobSystem& Jobs, FRealTimeReport& OutReport);
@@ -0,0 +1,193 @@
+#include "RhythmGenerator.h"
+#include <cmath>
+
+namespace
+{
+	/** Stateless per-step hash so probability decisions survive seeks and snapshots */
+	uint32 HashStep(uint32 Seed, int64 Step)
+	{
+		uint64 Value = (uint64)Step * 0x9E3779B97F4A7C15ull ^ Seed;
+		Value ^= Value >> 33;
+		Value *= 0xFF51AFD7ED558CCDull;
+		Value ^= Value >> 33;
+		return (uint32)Value;
+	}
+}
+
+// ============================================================================
+// FRhythmGenerator Implementation
+// ============================================================================
+
+FRhythmGenerator::FRhythmGenerator(float InSampleRate, float InTempo, int32 InMaxPatterns)
+	: SampleRate(InSampleRate)
+	, Tempo(FMath::Clamp(InTempo, 1.0f, 999.0f))
+	, MaxPatterns(FMath::Clamp(InMaxPatterns, 1, GetSandboxArrayLimit(FSandboxCapacity::MaxGenerators)))
+	, AnchorFrame(0)
+	, AnchorBeat(0.0)
+{
+	Patterns.Reserve(MaxPatterns);
+}
+
+int32 FRhythmGenerator::AddEuclideanPattern(int32 Pulses, int32 NumSteps, int32 Rotation, int32 StepsPerBeat)
+{
+	return AddPattern(MakeEuclidean(Pulses, NumSteps, Rotation), NumSteps, StepsPerBeat);
+}
+
+int32 FRhythmGenerator::AddPattern(uint64 StepMask, int32 NumSteps, int32 StepsPerBeat)
+{
+	if (Patterns.Num() >= MaxPatterns)
+	{
+		return INDEX_NONE;
+	}
+
+	FRhythmPattern Pattern;
+	Pattern.StepMask = StepMask;
+	FMemory::Memset(Pattern.Probability, 255, sizeof(Pattern.Probability));
+	Pattern.NumSteps = FMath::Clamp(NumSteps, 1, FRhythmPattern::MaxSteps);
+	Pattern.StepsPerBeat = FMath::Max(StepsPerBeat, 1);
+	Pattern.Swing = 0.0f;
+	Pattern.Velocity = 1.0f;
+	Pattern.Seed = 0x5EED0000u + (uint32)Patterns.Num();
+	Pattern.bEnabled = true;
+	return Patterns.Add(Pattern);
+}
+
+void FRhythmGenerator::SetStepProbability(int32 PatternIndex, int32 Step, float Probability)
+{
+	if (Patterns.IsValidIndex(PatternIndex) && Step >= 0 && Step < FRhythmPattern::MaxSteps)
+	{
+		Patterns[PatternIndex].Probability[Step] = (uint8)FMath::RoundToInt(FMath::Clamp(Probability, 0.0f, 1.0f) * 255.0f);
+	}
+}
+
+void FRhythmGenerator::SetSwing(int32 PatternIndex, float Swing)
+{
+	if (Patterns.IsValidIndex(PatternIndex))
+	{
+		// Below one step so swung steps never overtake the next step
+		Patterns[PatternIndex].Swing = FMath::Clamp(Swing, 0.0f, 0.9f);
+	}
+}
+
+void FRhythmGenerator::SetVelocity(int32 PatternIndex, float Velocity)
+{
+	if (Patterns.IsValidIndex(PatternIndex))
+	{
+		Patterns[PatternIndex].Velocity = FMath::Clamp(Velocity, 0.0f, 1.0f);
+	}
+}
+
+void FRhythmGenerator::SetSeed(int32 PatternIndex, uint32 Seed)
+{
+	if (Patterns.IsValidIndex(PatternIndex))
+	{
+		Patterns[PatternIndex].Seed = Seed;
+	}
+}
+
+void FRhythmGenerator::SetEnabled(int32 PatternIndex, bool bEnabled)
+{
+	if (Patterns.IsValidIndex(PatternIndex))
+	{
+		Patterns[PatternIndex].bEnabled = bEnabled;
+	}
+}
+
+void FRhythmGenerator::SetTempo(float Bpm, int64 AtFrame)
+{
+	AnchorBeat += (AtFrame - AnchorFrame) / GetFramesPerBeat();
+	AnchorFrame = AtFrame;
+	Tempo = FMath::Clamp(Bpm, 1.0f, 999.0f);
+}
+
+int32 FRhythmGenerator::Process(int64 BlockStartFrame, int32 NumFrames, FRhythmTriggerArray& OutTriggers) const
+{
+	const int32 FirstTrigger = OutTriggers.Num();
+	const int64 BlockEndFrame = BlockStartFrame + NumFrames;
+	const double FramesPerBeat = GetFramesPerBeat();
+	const double StartBeat = AnchorBeat + (BlockStartFrame - AnchorFrame) / FramesPerBeat;
+
+	for (int32 PatternIndex = 0; PatternIndex < Patterns.Num(); ++PatternIndex)
+	{
+		const FRhythmPattern& Pattern = Patterns[PatternIndex];
+		if (!Pattern.bEnabled || Pattern.StepMask == 0)
+		{
+			continue;
+		}
+
+		const double FramesPerStep = FramesPerBeat / Pattern.StepsPerBeat;
+		const double SwingFrames = Pattern.Swing * FramesPerStep;
+
+		// Start one step early: a swung step from before the block may land inside it
+		for (int64 Step = (int64)std::floor(StartBeat * Pattern.StepsPerBeat) - 1; ; ++Step)
+		{
+			double StepFrame = AnchorFrame + ((double)Step / Pattern.StepsPerBeat - AnchorBeat) * FramesPerBeat;
+			if (Step & 1)
+			{
+				StepFrame += SwingFrames;
+			}
+
+			const int64 Frame = (int64)std::floor(StepFrame + 0.5);
+			if (Frame >= BlockEndFrame)
+			{
+				break;
+			}
+			if (Frame < BlockStartFrame)
+			{
+				continue;
+			}
+
+			const int32 PatternStep = (int32)(((Step % Pattern.NumSteps) + Pattern.NumSteps) % Pattern.NumSteps);
+			if (((Pattern.StepMask >> PatternStep) & 1) == 0)
+			{
+				continue;
+			}
+
+			const uint8 Chance = Pattern.Probability[PatternStep];
+			if (Chance < 255 && (HashStep(Pattern.Seed, Step) & 0xFF) >= Chance)
+			{
+				continue;
+			}
+
+			FRhythmTrigger Trigger;
+			Trigger.FrameOffset = (int32)(Frame - BlockStartFrame);
+			Trigger.PatternIndex = PatternIndex;
+			Trigger.Step = PatternStep;
+			Trigger.Velocity = Pattern.Velocity;
+			OutTriggers.Add(Trigger);
+		}
+	}
+
+	// Each pattern contributes a few triggers per block, so insertion sort is cheapest
+	for (int32 i = FirstTrigger + 1; i < OutTriggers.Num(); ++i)
+	{
+		const FRhythmTrigger Trigger = OutTriggers[i];
+		int32 j = i - 1;
+		while (j >= FirstTrigger && OutTriggers[j].FrameOffset > Trigger.FrameOffset)
+		{
+			OutTriggers[j + 1] = OutTriggers[j];
+			--j;
+		}
+		OutTriggers[j + 1] = Trigger;
+	}
+
+	return OutTriggers.Num() - FirstTrigger;
+}
+
+uint64 FRhythmGenerator::MakeEuclidean(int32 Pulses, int32 NumSteps, int32 Rotation)
+{
+	NumSteps = FMath::Clamp(NumSteps, 1, FRhythmPattern::MaxSteps);
+	Pulses = FMath::Clamp(Pulses, 0, NumSteps);
+	Rotation = ((Rotation % NumSteps) + NumSteps) % NumSteps;
+
+	// Bresenham spacing yields the same necklace as Bjorklund's algorithm
+	uint64 Mask = 0;
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		if ((Step * Pulses) % NumSteps < Pulses)
+		{
+			Mask |= 1ull << ((Step + Rotation) % NumSteps);
+		}
+	}
+	return Mask;
+}
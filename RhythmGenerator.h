@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SandboxArchive.h"
+#include "StaticCapacity.h"
+
+/**
+ * A repeating step pattern on the shared tempo grid
+ * Plain data: a bank of patterns is one contiguous array
+ */
+struct FRhythmPattern
+{
+	static constexpr int32 MaxSteps = 64;
+
+	uint64 StepMask;              // Bit i set = step i is active
+	uint8 Probability[MaxSteps];  // Per-step trigger chance, 255 = always
+	int32 NumSteps;               // Pattern length (1-64)
+	int32 StepsPerBeat;           // 4 = sixteenth notes at 4/4
+	float Swing;                  // Fraction of a step that off-beat steps are delayed (0 = straight)
+	float Velocity;               // Trigger strength passed to the action (0-1)
+	uint32 Seed;                  // Probability decisions are a pure function of Seed and step count
+	bool bEnabled;
+};
+
+/**
+ * A trigger emitted for one active step inside a block
+ */
+struct FRhythmTrigger
+{
+	int32 FrameOffset;   // Offset from the block start
+	int32 PatternIndex;
+	int32 Step;          // Step within the pattern
+	float Velocity;
+};
+
+/** Triggers of one block; in the static-capacity profile, triggers beyond FSandboxCapacity::MaxEvents are dropped */
+using FRhythmTriggerArray = TSandboxArray<FRhythmTrigger, FSandboxCapacity::MaxEvents>;
+
+/**
+ * Tempo-synced rhythmic trigger generator
+ * Euclidean patterns, probability grids and swing over a shared tempo grid
+ *
+ * Process() evaluates every pattern for a whole block at once. Step times
+ * are computed directly from the tempo anchor, so output does not depend
+ * on block size and costs only the steps that actually fall in the block.
+ */
+class FRhythmGenerator
+{
+public:
+	FRhythmGenerator(float InSampleRate = 48000.0f, float InTempo = 120.0f, int32 InMaxPatterns = 256);
+
+	/**
+	 * Add a Euclidean pattern: Pulses hits spread as evenly as possible over NumSteps
+	 * @return Pattern index, or INDEX_NONE if the bank is full
+	 */
+	int32 AddEuclideanPattern(int32 Pulses, int32 NumSteps, int32 Rotation = 0, int32 StepsPerBeat = 4);
+
+	/** Add a pattern from an explicit step mask */
+	int32 AddPattern(uint64 StepMask, int32 NumSteps, int32 StepsPerBeat = 4);
+
+	void SetStepProbability(int32 PatternIndex, int32 Step, float Probability);
+	void SetSwing(int32 PatternIndex, float Swing);
+	void SetVelocity(int32 PatternIndex, float Velocity);
+	void SetSeed(int32 PatternIndex, uint32 Seed);
+	void SetEnabled(int32 PatternIndex, bool bEnabled);
+
+	/**
+	 * Change tempo without a jump in the step grid
+	 * @param AtFrame Sample clock frame at which the new tempo takes effect
+	 */
+	void SetTempo(float Bpm, int64 AtFrame);
+	float GetTempo() const { return Tempo; }
+
+	/**
+	 * Append triggers for all patterns in [BlockStartFrame, BlockStartFrame + NumFrames)
+	 * Triggers are sorted by frame offset
+	 * @return Number of triggers appended
+	 */
+	int32 Process(int64 BlockStartFrame, int32 NumFrames, FRhythmTriggerArray& OutTriggers) const;
+
+	int32 Num() const { return Patterns.Num(); }
+	const FRhythmPattern& GetPattern(int32 Index) const { return Patterns[Index]; }
+
+	void Serialize(FSandboxArchive& Ar)
+	{
+		Ar << Tempo << AnchorFrame << AnchorBeat << Patterns;
+	}
+
+	/** Bjorklund-equivalent Euclidean rhythm as a step mask */
+	static uint64 MakeEuclidean(int32 Pulses, int32 NumSteps, int32 Rotation);
+
+private:
+	TSandboxArray<FRhythmPattern, FSandboxCapacity::MaxGenerators> Patterns;
+	float SampleRate;
+	float Tempo;
+	int32 MaxPatterns;
+
+	// Beat position AnchorBeat occurs at AnchorFrame; the grid runs at Tempo from there
+	int64 AnchorFrame;
+	double AnchorBeat;
+
+	double GetFramesPerBeat() const { return SampleRate * 60.0 / Tempo; }
+};
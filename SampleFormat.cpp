@@ -0,0 +1,260 @@
+#include "SampleFormat.h"
+#include "SimdLevel.h"
+#include <cmath>
+#include <cstring>
+
+#if SANDBOX_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	struct FQuantizeRange
+	{
+		float Scale;
+		float Min;
+		float Max;
+	};
+
+	FQuantizeRange GetQuantizeRange(ESampleFormat Format)
+	{
+		switch (Format)
+		{
+		case ESampleFormat::Int16: return { 32767.0f, -32768.0f, 32767.0f };
+		case ESampleFormat::Int24: return { 8388607.0f, -8388608.0f, 8388607.0f };
+		default:                   return { 2147483648.0f, -2147483648.0f, 2147483520.0f };   // Largest float below 2^31
+		}
+	}
+
+	// Noise-shaping errors are limited so a clipped run cannot drive the feedback loop
+	constexpr float MaxShapingError = 2.0f;
+
+	inline uint32 XorShift(uint32 State)
+	{
+		State ^= State << 13;
+		State ^= State >> 17;
+		State ^= State << 5;
+		return State;
+	}
+
+	inline float ToUnit(uint32 State)
+	{
+		return (float)(int32)(State >> 8) * (1.0f / 16777216.0f);
+	}
+
+	inline int32 RoundToInt(float Value)
+	{
+		// Round half to even, as _mm_cvtps_epi32 does under the default rounding mode
+		return (int32)std::lrintf(Value);
+	}
+
+	void StoreSamples(ESampleFormat Format, const int32* Quantized, int32 Count, uint8* Out, int32 OutStride)
+	{
+		switch (Format)
+		{
+		case ESampleFormat::Int16:
+			for (int32 i = 0; i < Count; ++i, Out += OutStride)
+			{
+				const int16 Sample = (int16)Quantized[i];
+				FMemory::Memcpy(Out, &Sample, sizeof(Sample));
+			}
+			break;
+		case ESampleFormat::Int24:
+			for (int32 i = 0; i < Count; ++i, Out += OutStride)
+			{
+				Out[0] = (uint8)(Quantized[i]);
+				Out[1] = (uint8)(Quantized[i] >> 8);
+				Out[2] = (uint8)(Quantized[i] >> 16);
+			}
+			break;
+		default:
+			for (int32 i = 0; i < Count; ++i, Out += OutStride)
+			{
+				FMemory::Memcpy(Out, &Quantized[i], sizeof(int32));
+			}
+			break;
+		}
+	}
+}
+
+// ============================================================================
+// FSampleFormatConverter Implementation
+// ============================================================================
+
+FSampleFormatConverter::FSampleFormatConverter(ESampleFormat InFormat, EDitherMode InDither, uint32 InSeed)
+	: Format(InFormat)
+	, Dither(InDither)
+{
+	Reset(InSeed);
+}
+
+void FSampleFormatConverter::Reset(uint32 InSeed)
+{
+	// Distinct non-zero lane seeds
+	uint32 State = InSeed ? InSeed : 0x2545F491;
+	for (int32 Lane = 0; Lane < 4; ++Lane)
+	{
+		State = XorShift(State + 0x9E3779B9u * (Lane + 1));
+		NoiseState[Lane] = State ? State : 1;
+	}
+	FMemory::Memzero(ShapingError, sizeof(ShapingError));
+}
+
+void FSampleFormatConverter::ConvertPlanar(const float* const* Planar, const int32* ChannelMap, int32 NumOutputChannels, int32 NumFrames, void* Out)
+{
+	const int32 SampleBytes = GetSampleFormatBytes(Format);
+	const int32 FrameBytes = NumOutputChannels * SampleBytes;
+	for (int32 Channel = 0; Channel < NumOutputChannels; ++Channel)
+	{
+		const float* Source = ChannelMap[Channel] == INDEX_NONE ? nullptr : Planar[ChannelMap[Channel]];
+		ConvertChannel(Source, 1, static_cast<uint8*>(Out) + Channel * SampleBytes, FrameBytes, NumFrames, Channel);
+	}
+}
+
+void FSampleFormatConverter::ConvertInterleaved(const float* In, int32 NumChannels, int32 NumFrames, void* Out)
+{
+	const int32 SampleBytes = GetSampleFormatBytes(Format);
+	const int32 FrameBytes = NumChannels * SampleBytes;
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		ConvertChannel(In + Channel, NumChannels, static_cast<uint8*>(Out) + Channel * SampleBytes, FrameBytes, NumFrames, Channel);
+	}
+}
+
+void FSampleFormatConverter::GenerateTriangular(float* OutNoise, int32 Count)
+{
+	// Difference of two uniforms in [0, 1): triangular over (-1, 1) LSB.
+	// Values are produced four at a time, one per lane, so the sequence is the same with and without SIMD.
+#if SANDBOX_HAS_SSE2
+	if (GetSimdLevel() >= ESimdLevel::SSE2)
+	{
+		__m128i State = _mm_loadu_si128(reinterpret_cast<const __m128i*>(NoiseState));
+		const __m128 UnitScale = _mm_set1_ps(1.0f / 16777216.0f);
+		for (int32 i = 0; i < Count; i += 4)
+		{
+			State = _mm_xor_si128(State, _mm_slli_epi32(State, 13));
+			State = _mm_xor_si128(State, _mm_srli_epi32(State, 17));
+			State = _mm_xor_si128(State, _mm_slli_epi32(State, 5));
+			const __m128 First = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(State, 8)), UnitScale);
+
+			State = _mm_xor_si128(State, _mm_slli_epi32(State, 13));
+			State = _mm_xor_si128(State, _mm_srli_epi32(State, 17));
+			State = _mm_xor_si128(State, _mm_slli_epi32(State, 5));
+			const __m128 Second = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(State, 8)), UnitScale);
+
+			_mm_storeu_ps(OutNoise + i, _mm_sub_ps(First, Second));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(NoiseState), State);
+		return;
+	}
+#endif
+
+	for (int32 i = 0; i < Count; i += 4)
+	{
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const uint32 First = XorShift(NoiseState[Lane]);
+			const uint32 Second = XorShift(First);
+			NoiseState[Lane] = Second;
+			OutNoise[i + Lane] = ToUnit(First) - ToUnit(Second);
+		}
+	}
+}
+
+void FSampleFormatConverter::ConvertChannel(const float* In, int32 InStride, uint8* Out, int32 OutStride, int32 NumFrames, int32 Channel)
+{
+	const int32 SampleBytes = GetSampleFormatBytes(Format);
+
+	if (!In)
+	{
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FMemory::Memzero(Out + Frame * OutStride, SampleBytes);
+		}
+		return;
+	}
+
+	if (Format == ESampleFormat::Float32)
+	{
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FMemory::Memcpy(Out + Frame * OutStride, In + Frame * InStride, sizeof(float));
+		}
+		return;
+	}
+
+	const FQuantizeRange Range = GetQuantizeRange(Format);
+	const bool bDither = Dither != EDitherMode::None && Format != ESampleFormat::Int32;
+	float* Error = ShapingError[Channel % MaxChannels];
+
+	alignas(16) float Gathered[ChunkFrames];
+	alignas(16) float Noise[ChunkFrames];
+	alignas(16) int32 Quantized[ChunkFrames];
+	if (!bDither)
+	{
+		FMemory::Memzero(Noise, sizeof(Noise));
+	}
+
+	for (int32 Start = 0; Start < NumFrames; Start += ChunkFrames)
+	{
+		const int32 Count = FMath::Min(ChunkFrames, NumFrames - Start);
+
+		const float* Source = In + Start * InStride;
+		if (InStride != 1)
+		{
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Gathered[i] = Source[i * InStride];
+			}
+			Source = Gathered;
+		}
+
+		if (bDither)
+		{
+			GenerateTriangular(Noise, Count);
+		}
+
+		if (bDither && Dither == EDitherMode::NoiseShaped)
+		{
+			// Error feedback with H(z) = (1 - z^-1)^2: requantization noise rises 12 dB/octave
+			// from DC, leaving the low and mid bands quieter than flat TPDF
+			float Error1 = Error[0];
+			float Error2 = Error[1];
+			for (int32 i = 0; i < Count; ++i)
+			{
+				const float Target = Source[i] * Range.Scale - (2.0f * Error1 - Error2);
+				const int32 Sample = RoundToInt(FMath::Clamp(Target + Noise[i], Range.Min, Range.Max));
+				Error2 = Error1;
+				Error1 = FMath::Clamp((float)Sample - Target, -MaxShapingError, MaxShapingError);
+				Quantized[i] = Sample;
+			}
+			Error[0] = Error1;
+			Error[1] = Error2;
+		}
+		else
+		{
+			int32 i = 0;
+#if SANDBOX_HAS_SSE2
+			if (GetSimdLevel() >= ESimdLevel::SSE2)
+			{
+				const __m128 Scale = _mm_set1_ps(Range.Scale);
+				const __m128 Min = _mm_set1_ps(Range.Min);
+				const __m128 Max = _mm_set1_ps(Range.Max);
+				for (; i + 4 <= Count; i += 4)
+				{
+					__m128 Value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Source + i), Scale), _mm_load_ps(Noise + i));
+					Value = _mm_min_ps(_mm_max_ps(Value, Min), Max);
+					_mm_store_si128(reinterpret_cast<__m128i*>(Quantized + i), _mm_cvtps_epi32(Value));
+				}
+			}
+#endif
+			for (; i < Count; ++i)
+			{
+				const float Value = Source[i] * Range.Scale + Noise[i];
+				Quantized[i] = RoundToInt(FMath::Min(FMath::Max(Value, Range.Min), Range.Max));
+			}
+		}
+
+		StoreSamples(Format, Quantized, Count, Out + Start * OutStride, OutStride);
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * PCM sample formats for output streams and files
+ */
+enum class ESampleFormat : uint8
+{
+	Float32,
+	Int16,
+	Int24,   // Packed, 3 bytes little-endian
+	Int32
+};
+
+/**
+ * Requantization dither
+ */
+enum class EDitherMode : uint8
+{
+	None,          // Round to nearest
+	TPDF,          // Triangular noise of +-1 LSB: error is independent of the signal
+	NoiseShaped    // TPDF with second-order error feedback, moving noise out of the midrange
+};
+
+/** Bytes per sample of a format */
+inline int32 GetSampleFormatBytes(ESampleFormat Format)
+{
+	switch (Format)
+	{
+	case ESampleFormat::Int16: return 2;
+	case ESampleFormat::Int24: return 3;
+	default:                   return 4;
+	}
+}
+
+/**
+ * Float to PCM converter
+ *
+ * Converts planar or interleaved float audio into interleaved PCM of any
+ * channel layout, applying dither and clipping. Quantization and dither
+ * generation are vectorized over frames (SSE2 where available); the scalar
+ * path uses the same four-lane noise generator so both produce identical
+ * output. Noise shaping feeds back the error of each sample into the next,
+ * so that loop runs per channel. Int32 and Float32 are never dithered.
+ */
+class FSampleFormatConverter
+{
+public:
+	static constexpr int32 MaxChannels = 64;
+
+	FSampleFormatConverter(ESampleFormat InFormat = ESampleFormat::Int16, EDitherMode InDither = EDitherMode::TPDF, uint32 InSeed = 0x2545F491);
+
+	void SetFormat(ESampleFormat InFormat) { Format = InFormat; }
+	void SetDither(EDitherMode InDither) { Dither = InDither; }
+	ESampleFormat GetFormat() const { return Format; }
+	EDitherMode GetDither() const { return Dither; }
+
+	/** Restart the dither noise sequence and clear noise-shaping state */
+	void Reset(uint32 InSeed);
+
+	/**
+	 * Convert planar channels into an interleaved frame layout
+	 * @param Planar Source channels, NumFrames samples each
+	 * @param ChannelMap For each output channel, the index into Planar to write there, or INDEX_NONE for silence
+	 * @param NumOutputChannels Channels per output frame (at most MaxChannels)
+	 * @param Out NumFrames * NumOutputChannels samples of the target format
+	 */
+	void ConvertPlanar(const float* const* Planar, const int32* ChannelMap, int32 NumOutputChannels, int32 NumFrames, void* Out);
+
+	/**
+	 * Convert interleaved float into interleaved PCM with the same layout
+	 * e.g. FSandboxManager::Update output straight to a device or file
+	 */
+	void ConvertInterleaved(const float* In, int32 NumChannels, int32 NumFrames, void* Out);
+
+	/** Output size in bytes for a block */
+	int32 GetOutputBytes(int32 NumChannels, int32 NumFrames) const { return NumChannels * NumFrames * GetSampleFormatBytes(Format); }
+
+private:
+	static constexpr int32 ChunkFrames = 256;
+
+	ESampleFormat Format;
+	EDitherMode Dither;
+	uint32 NoiseState[4];                 // Four xorshift32 lanes
+	float ShapingError[MaxChannels][2];   // Last two quantization errors per output channel (LSBs)
+
+	/**
+	 * Convert one channel; input and output are strided
+	 * A null In writes digital silence
+	 */
+	void ConvertChannel(const float* In, int32 InStride, uint8* Out, int32 OutStride, int32 NumFrames, int32 Channel);
+	void GenerateTriangular(float* OutNoise, int32 Count);
+};
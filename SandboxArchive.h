@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StaticCapacity.h"
+#include <type_traits>
+
+/**
+ * Flat binary archive used to capture and restore sandbox state
+ * The same Serialize() function both saves and loads, depending on direction
+ *
+ * Only trivially copyable values are written, so an image is a compact
+ * contiguous block that can be restored with plain memcpy.
+ */
+class FSandboxArchive
+{
+public:
+	/** Create a saving archive that appends to OutBytes */
+	explicit FSandboxArchive(TArray<uint8>& OutBytes)
+		: WriteBytes(&OutBytes)
+		, ReadData(nullptr)
+		, ReadSize(0)
+		, Offset(OutBytes.Num())
+		, bLoading(false)
+		, bError(false)
+	{
+	}
+
+	/** Create a loading archive over an immutable image */
+	FSandboxArchive(const uint8* InData, int32 InSize)
+		: WriteBytes(nullptr)
+		, ReadData(InData)
+		, ReadSize(InSize)
+		, Offset(0)
+		, bLoading(true)
+		, bError(false)
+	{
+	}
+
+	bool IsLoading() const { return bLoading; }
+	bool IsSaving() const { return !bLoading; }
+	bool IsError() const { return bError; }
+
+	/** Flag loaded data that was read in full but is not valid */
+	void SetError() { bError = true; }
+	int32 Tell() const { return Offset; }
+
+	/**
+	 * Copy raw bytes to or from the archive
+	 * A read past the end of the image zeroes Data and flags an error
+	 */
+	void Serialize(void* Data, int32 NumBytes)
+	{
+		if (NumBytes <= 0)
+		{
+			return;
+		}
+
+		if (bLoading)
+		{
+			if (bError || Offset + NumBytes > ReadSize)
+			{
+				bError = true;
+				FMemory::Memzero(Data, NumBytes);
+				return;
+			}
+			FMemory::Memcpy(Data, ReadData + Offset, NumBytes);
+		}
+		else
+		{
+			const int32 Start = WriteBytes->AddUninitialized(NumBytes);
+			FMemory::Memcpy(WriteBytes->GetData() + Start, Data, NumBytes);
+		}
+		Offset += NumBytes;
+	}
+
+	/** Skip forward while loading (used to step over sections that cannot be applied) */
+	void Skip(int32 NumBytes)
+	{
+		if (!bLoading || NumBytes < 0 || Offset + NumBytes > ReadSize)
+		{
+			bError = true;
+			return;
+		}
+		Offset += NumBytes;
+	}
+
+	/**
+	 * Sized sections let a reader skip payloads it does not understand
+	 * BeginSection returns a marker that must be passed to EndSection;
+	 * when loading, OutSize receives the payload size
+	 */
+	int32 BeginSection(int32& OutSize)
+	{
+		OutSize = 0;
+		*this << OutSize;
+		return Offset;
+	}
+
+	void EndSection(int32 Marker)
+	{
+		if (bLoading)
+		{
+			return;
+		}
+		const int32 Size = Offset - Marker;
+		FMemory::Memcpy(WriteBytes->GetData() + Marker - (int32)sizeof(int32), &Size, sizeof(int32));
+	}
+
+	template<typename T>
+	FSandboxArchive& operator<<(T& Value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "FSandboxArchive only stores trivially copyable values");
+		Serialize(&Value, sizeof(T));
+		return *this;
+	}
+
+	template<typename T>
+	FSandboxArchive& operator<<(TArray<T>& Values)
+	{
+		return SerializeArray<T>(Values, MAX_int32);
+	}
+
+	/** Loading more elements than fit is an error */
+	template<typename T, int32 Capacity>
+	FSandboxArchive& operator<<(TFixedArray<T, Capacity>& Values)
+	{
+		return SerializeArray<T>(Values, Capacity);
+	}
+
+private:
+	template<typename T, typename ArrayType>
+	FSandboxArchive& SerializeArray(ArrayType& Values, int32 MaxNum)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "FSandboxArchive only stores trivially copyable values");
+		int32 Num = Values.Num();
+		*this << Num;
+		if (bLoading)
+		{
+			if (bError || Num < 0 || Num > MaxNum || Offset + Num * (int32)sizeof(T) > ReadSize)
+			{
+				bError = true;
+				return *this;
+			}
+			Values.SetNum(Num);
+		}
+		Serialize(Values.GetData(), Num * (int32)sizeof(T));
+		return *this;
+	}
+
+	TArray<uint8>* WriteBytes;
+	const uint8* ReadData;
+	int32 ReadSize;
+	int32 Offset;
+	bool bLoading;
+	bool bError;
+};
+
+/**
+ * Immutable image of a sandbox's complete simulation state
+ * Physics bodies, voice states, generator states and the sample clock
+ *
+ * Copies share the same image: a captured snapshot is never written again,
+ * so any number of forks can restore from it without duplicating memory.
+ */
+class FSandboxSnapshot
+{
+public:
+	static constexpr uint32 Magic = 0x534E4258; // 'SNBX'
+	static constexpr uint32 Version = 8;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		float SampleRate;
+		int32 BufferSize;
+		int64 FrameIndex;   // Frames rendered when the snapshot was taken
+		int32 NumBodies;
+	};
+
+	FSandboxSnapshot()
+	{
+		FMemory::Memzero(&Header, sizeof(Header));
+	}
+
+	bool IsValid() const { return Image.IsValid() && Header.Magic == Magic && Header.Version == Version; }
+	const FHeader& GetHeader() const { return Header; }
+
+	/** Size of the contiguous state image in bytes */
+	int32 GetImageSize() const { return Image.IsValid() ? Image->Num() : 0; }
+	const uint8* GetImageData() const { return Image.IsValid() ? Image->GetData() : nullptr; }
+
+private:
+	friend class FSandboxManager;
+
+	FHeader Header;
+	TSharedPtr<const TArray<uint8>> Image;
+};
@@ -1,12 +1,21 @@
 #include "SandboxManager.h"
 #include <chrono>
 
+namespace
+{
+	constexpr int32 NumGeneratorTypes = (int32)EProceduralGeneratorType::Expression + 1;
+}
+
 // ============================================================================
 // FSandboxManager Implementation
 // ============================================================================
 
 FSandboxManager::FSandboxManager(float InSampleRate, int32 InBufferSize)
-	: SampleRate(InSampleRate)
+	: AudioPhysicsIntegration(InSampleRate)
+	, ProceduralController()
+	, ScriptRunner(InSampleRate)
+	, Rhythm(InSampleRate)
+	, SampleRate(InSampleRate)
 	, BufferSize(InBufferSize)
 	, SimulationSpeed(1.0f)
 	, bUseProceduralGeneration(true)
@@ -14,10 +23,36 @@ FSandboxManager::FSandboxManager(float InSampleRate, int32 InBufferSize)
 	, bUseResonanceSynthesis(true)
 	, bInitialized(false)
 	, LastFrameTime(0.0f)
-	, AudioPhysicsIntegration(InSampleRate)
-	, ProceduralController()
+	, FrameTimeIndex(0)
+	, RenderedFrames(0)
+	, MaxCallbackFrames(8192)
+	, LeftoverOffset(InBufferSize)
+	, bTraceDeterminism(false)
+	, bCaptureBuses(false)
+	, ProceduralOscillator(InSampleRate)
+	, ControlPeriod(0)
+	, LastControlTick(-1)
+	, ControlAmplitude(0.0f)
+	, NextRhythmEvent(0)
+	, HotReloadReader(INDEX_NONE)
+	, AppliedAssetVersion(0)
+	, AppliedMaterialVersion(0)
+	, AppliedPresetVersion(0)
+	, RefusedSpawns(0)
+	, bSealed(false)
 {
+	FrameTimeHistory.SetNum(FrameTimeHistorySize);
+	LeftoverAudio.SetNum(InBufferSize * OutputPanner.GetNumChannels());
+	for (int32 Tag = 0; Tag < (int32)EMemoryTag::Count; ++Tag)
+	{
+		MemoryCharges[Tag].SetTag((EMemoryTag)Tag);
+	}
+	for (uint32& Version : AppliedGraphVersions)
+	{
+		Version = 0;
+	}
 	Initialize();
+	UpdateMemoryCharges();
 }
 
 FSandboxManager::~FSandboxManager()
@@ -38,84 +73,641 @@ void FSandboxManager::Initialize()
 }
 
 int32 FSandboxManager::Update(float DeltaTime, TArray<float>& OutAudioBuffer)
+{
+	OutAudioBuffer.SetNum(BufferSize * OutputPanner.GetNumChannels());
+	RenderBlock(DeltaTime, OutAudioBuffer.GetData());
+	return BufferSize;
+}
+
+int32 FSandboxManager::Update(float* OutAudio, int32 NumFrames)
+{
+	NumFrames = FMath::Clamp(NumFrames, 0, MaxCallbackFrames);
+	const float SubBlockTime = BufferSize / SampleRate;
+	const int32 NumChannels = OutputPanner.GetNumChannels();
+
+	// Frames left over from the previous call's partial sub-block come first
+	int32 Written = FMath::Min(BufferSize - LeftoverOffset, NumFrames);
+	FMemory::Memcpy(OutAudio, LeftoverAudio.GetData() + LeftoverOffset * NumChannels, sizeof(float) * Written * NumChannels);
+	LeftoverOffset += Written;
+
+	// Whole sub-blocks go straight to the caller
+	while (NumFrames - Written >= BufferSize)
+	{
+		RenderBlock(SubBlockTime, OutAudio + Written * NumChannels);
+		Written += BufferSize;
+	}
+
+	// A partial tail is rendered aside and the rest kept for the next call
+	if (Written < NumFrames)
+	{
+		RenderBlock(SubBlockTime, LeftoverAudio.GetData());
+		LeftoverOffset = NumFrames - Written;
+		FMemory::Memcpy(OutAudio + Written * NumChannels, LeftoverAudio.GetData(), sizeof(float) * LeftoverOffset * NumChannels);
+		Written = NumFrames;
+	}
+
+	return Written;
+}
+
+void FSandboxManager::RenderBlock(float DeltaTime, float* OutAudio)
 {
 	if (!bInitialized)
 	{
-		OutAudioBuffer.SetNum(BufferSize * 2);
-		for (int32 i = 0; i < OutAudioBuffer.Num(); ++i)
+		FMemory::Memzero(OutAudio, sizeof(float) * BufferSize * OutputPanner.GetNumChannels());
+		return;
+	}
+
+	// Segments mix in stereo; other layouts are panned from the finished mix
+	const bool bStereoOutput = OutputPanner.GetLayout() == EChannelLayout::Stereo;
+	float* Mix = bStereoOutput ? OutAudio : StereoMix.GetData();
+
+	if (bTraceDeterminism)
+	{
+		BlockHash.Frame = RenderedFrames;
+		for (uint64& StageHash : BlockHash.Stages)
+		{
+			StageHash = DeterminismHashSeed;
+		}
+	}
+
+	ApplyHotAssets();
+	ScheduleRhythmEvents();
+
+	// Split the block at timeline events, rhythm triggers, script wake-ups and control ticks so each lands on its exact frame
+	int32 Offset = 0;
+	while (Offset < BufferSize)
+	{
+		const int64 Frame = RenderedFrames + Offset;
+		ApplyTimelineEvents(Frame);
+		ScriptRunner.Resume(Frame);
+
+		// Resumed scripts may schedule events for this frame or one already rendered; they fire now
+		ApplyTimelineEvents(Frame);
+
+		int64 NextEventFrame = FMath::Min(Timeline.GetNextEventFrame(), ScriptRunner.GetNextWakeFrame());
+		if (NextRhythmEvent < RhythmEvents.Num())
+		{
+			NextEventFrame = FMath::Min(NextEventFrame, RhythmEvents[NextRhythmEvent].Frame);
+		}
+		if (ControlPeriod > 0 && bUseProceduralGeneration)
+		{
+			NextEventFrame = FMath::Min(NextEventFrame, (Frame / ControlPeriod + 1) * ControlPeriod);
+		}
+		NextEventFrame = FMath::Max(NextEventFrame, Frame + 1);
+
+		const int32 SegmentFrames = NextEventFrame < RenderedFrames + BufferSize
+			? (int32)(NextEventFrame - Frame)
+			: BufferSize - Offset;
+
+		RenderSegment(DeltaTime * SegmentFrames / BufferSize, Offset, SegmentFrames, Mix);
+		Offset += SegmentFrames;
+	}
+
+	if (!bStereoOutput)
+	{
+		OutputPanner.UpmixStereo(Mix, BufferSize, OutAudio);
+	}
+
+	if (bTraceDeterminism)
+	{
+		uint64& PhysicsHash = BlockHash.Stages[(int32)EDeterminismStage::Physics];
+		for (const TSharedPtr<FPhysicsObject>& Object : PhysicsWorld.GetObjects())
 		{
-			OutAudioBuffer[i] = 0.0f;
+			PhysicsHash = HashDeterminismBytes(PhysicsHash, &Object->GetPosition(), sizeof(FVector3));
+			PhysicsHash = HashDeterminismBytes(PhysicsHash, &Object->GetVelocity(), sizeof(FVector3));
 		}
-		return BufferSize;
+		BlockHash.Stages[(int32)EDeterminismStage::Output] = HashDeterminismBytes(BlockHash.Stages[(int32)EDeterminismStage::Output],
+			OutAudio, sizeof(float) * BufferSize * OutputPanner.GetNumChannels());
+		DeterminismTrace.Add(BlockHash);
 	}
 
+	// Track performance
+	FrameTimeHistory[FrameTimeIndex] = LastFrameTime;
+	FrameTimeIndex = FrameTimeIndex + 1 < FrameTimeHistorySize ? FrameTimeIndex + 1 : 0;
+
+	RenderedFrames += BufferSize;
+	UpdateMemoryCharges();
+}
+
+void FSandboxManager::RenderSegment(float DeltaTime, int32 FrameOffset, int32 NumFrames, float* OutAudio)
+{
 	// Apply simulation speed
 	float AdjustedDeltaTime = DeltaTime * SimulationSpeed;
 
 	// Simulate physics
+	ForceFields.Apply(PhysicsWorld.GetObjects(), AdjustedDeltaTime);
 	PhysicsWorld.SimulateStep(AdjustedDeltaTime);
 
-	// Initialize output buffer
-	TArray<float> PhysicsAudioBuffer;
-	TArray<float> ProceduralAudioBuffer;
-
 	// Generate physics-driven audio
 	if (bUsePhysicsAudio)
 	{
-		AudioPhysicsIntegration.Update(&PhysicsWorld, AdjustedDeltaTime, PhysicsAudioBuffer, BufferSize);
+		AudioPhysicsIntegration.Update(&PhysicsWorld, AdjustedDeltaTime, PhysicsAudioBuffer, NumFrames);
 	}
 	else
 	{
-		PhysicsAudioBuffer.SetNum(BufferSize * 2);
-		for (int32 i = 0; i < PhysicsAudioBuffer.Num(); ++i)
-		{
-			PhysicsAudioBuffer[i] = 0.0f;
-		}
+		PhysicsAudioBuffer.SetNum(NumFrames * 2);
+		FMemory::Memzero(PhysicsAudioBuffer.GetData(), sizeof(float) * PhysicsAudioBuffer.Num());
 	}
 
 	// Generate procedural audio
 	if (bUseProceduralGeneration)
 	{
-		ProcessProceduralAudio(ProceduralAudioBuffer);
+		ProcessProceduralAudio(ProceduralAudioBuffer, RenderedFrames + FrameOffset, NumFrames);
 	}
 	else
 	{
-		ProceduralAudioBuffer.SetNum(BufferSize * 2);
-		for (int32 i = 0; i < ProceduralAudioBuffer.Num(); ++i)
+		ProceduralAudioBuffer.SetNum(NumFrames * 2);
+		FMemory::Memzero(ProceduralAudioBuffer.GetData(), sizeof(float) * ProceduralAudioBuffer.Num());
+	}
+
+	// Mix both audio streams into this segment of the output
+	float* OutSamples = OutAudio + FrameOffset * 2;
+	for (int32 i = 0; i < NumFrames * 2; ++i)
+	{
+		OutSamples[i] = (PhysicsAudioBuffer[i] * 0.6f + ProceduralAudioBuffer[i] * 0.4f) * 0.9f;
+		// Soft clipping
+		OutSamples[i] = FMath::Clamp(OutSamples[i], -1.0f, 1.0f);
+	}
+
+	if (bTraceDeterminism)
+	{
+		const int32 SegmentBytes = sizeof(float) * NumFrames * 2;
+		uint64* Stages = BlockHash.Stages;
+		Stages[(int32)EDeterminismStage::PhysicsAudio] = HashDeterminismBytes(Stages[(int32)EDeterminismStage::PhysicsAudio], PhysicsAudioBuffer.GetData(), SegmentBytes);
+		Stages[(int32)EDeterminismStage::ProceduralAudio] = HashDeterminismBytes(Stages[(int32)EDeterminismStage::ProceduralAudio], ProceduralAudioBuffer.GetData(), SegmentBytes);
+		Stages[(int32)EDeterminismStage::Mix] = HashDeterminismBytes(Stages[(int32)EDeterminismStage::Mix], OutSamples, SegmentBytes);
+	}
+
+	if (bCaptureBuses)
+	{
+		float* PhysicsBus = BusAudio[(int32)ESandboxBus::Physics].GetData() + FrameOffset * 2;
+		float* ProceduralBus = BusAudio[(int32)ESandboxBus::Procedural].GetData() + FrameOffset * 2;
+		for (int32 i = 0; i < NumFrames * 2; ++i)
 		{
-			ProceduralAudioBuffer[i] = 0.0f;
+			PhysicsBus[i] = PhysicsAudioBuffer[i] * 0.6f * 0.9f;
+			ProceduralBus[i] = ProceduralAudioBuffer[i] * 0.4f * 0.9f;
 		}
 	}
+}
 
-	// Mix both audio streams
-	OutAudioBuffer.SetNum(BufferSize * 2);
-	for (int32 i = 0; i < OutAudioBuffer.Num(); ++i)
+void FSandboxManager::EnableBusCapture(bool bEnable)
+{
+	bCaptureBuses = bEnable;
+	for (TArray<float>& Bus : BusAudio)
 	{
-		OutAudioBuffer[i] = (PhysicsAudioBuffer[i] * 0.6f + ProceduralAudioBuffer[i] * 0.4f) * 0.9f;
-		// Soft clipping
-		OutAudioBuffer[i] = FMath::Clamp(OutAudioBuffer[i], -1.0f, 1.0f);
+		Bus.SetNum(bEnable ? BufferSize * 2 : 0);
+		FMemory::Memzero(Bus.GetData(), sizeof(float) * Bus.Num());
 	}
+}
 
-	// Track performance
-	FrameTimeHistory.Add(LastFrameTime);
-	if (FrameTimeHistory.Num() > 100)
+bool FSandboxManager::IsBusActive(ESandboxBus Bus) const
+{
+	switch (Bus)
 	{
-		FrameTimeHistory.RemoveAt(0);
+	case ESandboxBus::Physics:    return bUsePhysicsAudio;
+	case ESandboxBus::Procedural: return bUseProceduralGeneration;
+	default:                      return false;
 	}
+}
 
-	return BufferSize;
+void FSandboxManager::ApplyTimelineEvents(int64 Frame)
+{
+	while (const FTimelineEvent* Event = Timeline.PopDueEvent(Frame))
+	{
+		ApplyEvent(*Event);
+	}
+
+	while (NextRhythmEvent < RhythmEvents.Num() && RhythmEvents[NextRhythmEvent].Frame <= Frame)
+	{
+		ApplyEvent(RhythmEvents[NextRhythmEvent++]);
+	}
+}
+
+void FSandboxManager::ApplyHotAssets()
+{
+	// Nothing new published: no read section at all
+	const uint32 PublishedVersion = HotReloader.GetPublishedVersion();
+	if (PublishedVersion == AppliedAssetVersion)
+	{
+		return;
+	}
+	if (HotReloadReader == INDEX_NONE)
+	{
+		HotReloadReader = HotReloader.RegisterReader();
+		if (HotReloadReader == INDEX_NONE)
+		{
+			return;
+		}
+	}
+
+	FAssetHotReloader::FReadScope ReadScope(HotReloader, HotReloadReader);
+
+	// An asset can be visible before PublishedVersion announces it, so each is applied once per its own version
+	const FMaterialAsset* Material = HotReloader.GetMaterial();
+	if (Material && Material->Version > AppliedMaterialVersion)
+	{
+		AppliedMaterialVersion = Material->Version;
+		AudioPhysicsIntegration.GetMapper()->SetFrequencyRange(Material->MinFrequency, Material->MaxFrequency);
+		if (Material->Damping >= 0.0f)
+		{
+			for (const TSharedPtr<FPhysicsObject>& Body : PhysicsWorld.GetObjects())
+			{
+				Body->SetDamping(Material->Damping);
+			}
+		}
+	}
+
+	const FSynthPresetAsset* Preset = HotReloader.GetPreset();
+	if (Preset && Preset->Version > AppliedPresetVersion)
+	{
+		AppliedPresetVersion = Preset->Version;
+		SetMasterVolume(Preset->MasterVolume);
+		AudioPhysicsIntegration.GetResonanceSynth()->SetResonance(Preset->ResonanceFrequency, Preset->ResonanceQuality, Preset->ResonanceDamping);
+		ProceduralController.SetFrequencyRange(Preset->FrequencyMin, Preset->FrequencyMax);
+		ProceduralController.SetAmplitudeRange(Preset->AmplitudeMin, Preset->AmplitudeMax);
+		ProceduralController.SetDurationRange(Preset->DurationMin, Preset->DurationMax);
+	}
+
+	for (int32 Slot = 0; Slot < (int32)EProceduralParameter::Count; ++Slot)
+	{
+		const FGeneratorGraphAsset* Graph = HotReloader.GetGraph((EProceduralParameter)Slot);
+		if (Graph && Graph->Version > AppliedGraphVersions[Slot])
+		{
+			// The replaced generator goes back into the asset and is deleted with it on the loader thread;
+			// the asset is consumed, so that generator is never swapped back in
+			AppliedGraphVersions[Slot] = Graph->Version;
+			if (Graph->Generator.IsValid())
+			{
+				Graph->Generator = ProceduralController.ExchangeGenerator(Graph->Slot, MoveTemp(Graph->Generator));
+			}
+		}
+	}
+
+	AppliedAssetVersion = PublishedVersion;
+}
+
+void FSandboxManager::ScheduleRhythmEvents()
+{
+	RhythmEvents.Reset();
+	NextRhythmEvent = 0;
+
+	if (Rhythm.Num() == 0)
+	{
+		return;
+	}
+
+	RhythmTriggers.Reset();
+	Rhythm.Process(RenderedFrames, BufferSize, RhythmTriggers);
+
+	for (const FRhythmTrigger& Trigger : RhythmTriggers)
+	{
+		if (!RhythmBindings.IsValidIndex(Trigger.PatternIndex) || !RhythmBindings[Trigger.PatternIndex].bBound)
+		{
+			continue;
+		}
+
+		FTimelineEvent Event = RhythmBindings[Trigger.PatternIndex].Action;
+		Event.Frame = RenderedFrames + Trigger.FrameOffset;
+		if (Event.Type == ETimelineEventType::ApplyImpulse)
+		{
+			Event.Vector = Event.Vector * Trigger.Velocity;
+		}
+		RhythmEvents.Add(Event);
+	}
+}
+
+void FSandboxManager::SetRhythmAction(int32 PatternIndex, const FTimelineEvent& Action)
+{
+	if (PatternIndex < 0 || PatternIndex >= GetSandboxArrayLimit(FSandboxCapacity::MaxGenerators))
+	{
+		return;
+	}
+
+	while (RhythmBindings.Num() <= PatternIndex)
+	{
+		FRhythmBinding Unbound;
+		Unbound.bBound = false;
+		RhythmBindings.Add(Unbound);
+	}
+	RhythmBindings[PatternIndex].Action = Action;
+	RhythmBindings[PatternIndex].bBound = true;
 }
 
-void FSandboxManager::AddPhysicsObject(TSharedPtr<FPhysicsObject> Object)
+void FSandboxManager::ApplyEvent(const FTimelineEvent& Event)
+{
+	switch (Event.Type)
+	{
+	case ETimelineEventType::SpawnSphere:
+		SpawnSphere(Event);
+		break;
+	case ETimelineEventType::ApplyImpulse:
+	{
+		const FPhysicsObjectArray& Objects = PhysicsWorld.GetObjects();
+		if (Event.BodyIndex >= 0 && Event.BodyIndex < Objects.Num())
+		{
+			Objects[Event.BodyIndex]->ApplyImpulse(Event.Vector);
+		}
+		break;
+	}
+	case ETimelineEventType::SetParameter:
+		ApplyTimelineParameter(Event.Parameter, Event.Values[0]);
+		break;
+	case ETimelineEventType::SwapGenerator:
+		SwapGenerator(Event);
+		break;
+	}
+}
+
+void FSandboxManager::SpawnSphere(const FTimelineEvent& Event)
+{
+	if (!bSealed)
+	{
+		auto Sphere = MakeShared<FPhysicsSphere>(Event.Values[0], Event.Values[1]);
+		Sphere->SetPosition(Event.Vector);
+		AddPhysicsObject(Sphere);
+		return;
+	}
+
+	// Sealed: reinitialize a pooled body in place
+	if (SpherePool.Num() == 0)
+	{
+		++RefusedSpawns;
+		return;
+	}
+
+	TSharedPtr<FPhysicsSphere> Sphere = SpherePool.Pop();
+	*Sphere = FPhysicsSphere(Event.Values[0], Event.Values[1]);
+	Sphere->SetPosition(Event.Vector);
+	if (!AddPhysicsObject(Sphere))
+	{
+		SpherePool.Add(Sphere);
+	}
+}
+
+void FSandboxManager::SwapGenerator(const FTimelineEvent& Event)
+{
+	if (!bSealed)
+	{
+		TUniquePtr<FProceduralGenerator> Generator = CreateProceduralGenerator(Event.GeneratorType);
+		if (Generator.IsValid())
+		{
+			Generator->SetSeed(Event.Seed);
+			ProceduralController.SetGenerator(Event.Slot, MoveTemp(Generator));
+		}
+		return;
+	}
+
+	if (Event.GeneratorType == EProceduralGeneratorType::Custom)
+	{
+		return;
+	}
+
+	int32 PoolIndex = INDEX_NONE;
+	for (int32 i = 0; i < GeneratorPool.Num() && PoolIndex == INDEX_NONE; ++i)
+	{
+		if (GeneratorPool[i]->GetGeneratorType() == Event.GeneratorType)
+		{
+			PoolIndex = i;
+		}
+	}
+	if (PoolIndex == INDEX_NONE)
+	{
+		++RefusedSpawns;
+		return;
+	}
+
+	// A generator the pool did not create is retired, never freed here; with no room left
+	// to retire it the swap is refused instead
+	const FProceduralGenerator* Current = ProceduralController.GetGenerator(Event.Slot);
+	if (Current && !PooledGenerators.Contains(Current) && RetiredGenerators.Num() >= FSandboxCapacity::MaxGenerators)
+	{
+		++RefusedSpawns;
+		return;
+	}
+
+	// A reset and reseeded generator continues exactly like a newly created one
+	TUniquePtr<FProceduralGenerator> Generator = MoveTemp(GeneratorPool[PoolIndex]);
+	GeneratorPool.RemoveAtSwap(PoolIndex);
+	Generator->Reset();
+	Generator->SetSeed(Event.Seed);
+
+	TUniquePtr<FProceduralGenerator> Replaced = ProceduralController.ExchangeGenerator(Event.Slot, MoveTemp(Generator));
+	if (!Replaced.IsValid())
+	{
+		return;
+	}
+	if (PooledGenerators.Contains(Replaced.Get()))
+	{
+		GeneratorPool.Add(MoveTemp(Replaced));
+	}
+	else
+	{
+		RetiredGenerators.Add(MoveTemp(Replaced));
+	}
+}
+
+bool FSandboxManager::SealAllocations()
+{
+	// What the rest of the timeline can spawn and swap; bound rhythm actions repeat without end
+	int32 TimelineSpawns = 0;
+	bool bRhythmSpawns = false;
+	int32 Swaps[NumGeneratorTypes] = {};
+	uint32 SwapSlots[NumGeneratorTypes] = {};
+
+	const FTimelineEventArray& Events = Timeline.GetEvents();
+	for (int32 i = Timeline.GetCursor(); i < Events.Num(); ++i)
+	{
+		if (Events[i].Type == ETimelineEventType::SpawnSphere)
+		{
+			++TimelineSpawns;
+		}
+		else if (Events[i].Type == ETimelineEventType::SwapGenerator)
+		{
+			++Swaps[(int32)Events[i].GeneratorType];
+			SwapSlots[(int32)Events[i].GeneratorType] |= 1u << (int32)Events[i].Slot;
+		}
+	}
+	for (const FRhythmBinding& Binding : RhythmBindings)
+	{
+		if (!Binding.bBound)
+		{
+			continue;
+		}
+		if (Binding.Action.Type == ETimelineEventType::SpawnSphere)
+		{
+			bRhythmSpawns = true;
+		}
+		else if (Binding.Action.Type == ETimelineEventType::SwapGenerator)
+		{
+			Swaps[(int32)Binding.Action.GeneratorType] = MAX_int32;
+			SwapSlots[(int32)Binding.Action.GeneratorType] |= 1u << (int32)Binding.Action.Slot;
+		}
+	}
+
+	// Rhythm spawns past the capacity are refused like spawns over the memory budget
+	const int32 Room = FMath::Max(FSandboxCapacity::MaxBodies - PhysicsWorld.GetObjects().Num(), 0);
+	bool bFits = TimelineSpawns <= Room;
+	const int32 NumSpheres = bRhythmSpawns ? Room : FMath::Min(TimelineSpawns, Room);
+	SpherePool.Reserve(NumSpheres);
+	while (SpherePool.Num() < NumSpheres)
+	{
+		SpherePool.Add(MakeShared<FPhysicsSphere>());
+	}
+
+	// A type is in use in at most the slots it is swapped into, and a swap takes its generator
+	// before the replaced one returns
+	GeneratorPool.Reserve(FSandboxCapacity::MaxGenerators);
+	PooledGenerators.Reserve(FSandboxCapacity::MaxGenerators);
+	RetiredGenerators.Reserve(FSandboxCapacity::MaxGenerators);
+	for (int32 Type = (int32)EProceduralGeneratorType::Custom + 1; Type < NumGeneratorTypes; ++Type)
+	{
+		int32 NumSlots = 0;
+		for (int32 Slot = 0; Slot < (int32)EProceduralParameter::Count; ++Slot)
+		{
+			NumSlots += (SwapSlots[Type] >> Slot) & 1u;
+		}
+		const int32 Needed = FMath::Min(Swaps[Type], NumSlots + 1);
+		int32 Created = 0;
+		for (const FProceduralGenerator* Pooled : PooledGenerators)
+		{
+			Created += Pooled->GetGeneratorType() == (EProceduralGeneratorType)Type ? 1 : 0;
+		}
+		for (; Created < Needed; ++Created)
+		{
+			if (PooledGenerators.Num() >= FSandboxCapacity::MaxGenerators)
+			{
+				bFits = false;
+				break;
+			}
+			TUniquePtr<FProceduralGenerator> Generator = CreateProceduralGenerator((EProceduralGeneratorType)Type);
+			PooledGenerators.Add(Generator.Get());
+			GeneratorPool.Add(MoveTemp(Generator));
+		}
+	}
+
+	// Each slot holds at most one generator from elsewhere, and the timeline retires it at most once
+	int32 Foreign = 0;
+	for (int32 Slot = 0; Slot < (int32)EProceduralParameter::Count; ++Slot)
+	{
+		const FProceduralGenerator* Current = ProceduralController.GetGenerator((EProceduralParameter)Slot);
+		Foreign += (Current && !PooledGenerators.Contains(Current)) ? 1 : 0;
+	}
+	if (RetiredGenerators.Num() + Foreign > FSandboxCapacity::MaxGenerators)
+	{
+		bFits = false;
+	}
+
+	const int32 MaxBodies = PhysicsWorld.GetObjects().Num() + SpherePool.Num();
+	PhysicsWorld.Reserve(MaxBodies);
+	AudioPhysicsIntegration.ReserveObjects(MaxBodies);
+	ForceFields.ReserveBodies(MaxBodies);
+	PhysicsAudioBuffer.Reserve(BufferSize * 2);
+	ProceduralAudioBuffer.Reserve(BufferSize * 2);
+	RhythmTriggers.Reserve(FSandboxCapacity::MaxEvents);
+	RhythmEvents.Reserve(FSandboxCapacity::MaxEvents);
+
+	bSealed = true;
+	UpdateMemoryCharges();
+	return bFits;
+}
+
+void FSandboxManager::ApplyTimelineParameter(ETimelineParameter Parameter, float Value)
+{
+	float Min, Max;
+	switch (Parameter)
+	{
+	case ETimelineParameter::MasterVolume:
+		SetMasterVolume(Value);
+		break;
+	case ETimelineParameter::SimulationSpeed:
+		SetSimulationSpeed(Value);
+		break;
+	case ETimelineParameter::FrequencyMin:
+	case ETimelineParameter::FrequencyMax:
+		ProceduralController.GetFrequencyRange(Min, Max);
+		ProceduralController.SetFrequencyRange(
+			Parameter == ETimelineParameter::FrequencyMin ? Value : Min,
+			Parameter == ETimelineParameter::FrequencyMax ? Value : Max);
+		break;
+	case ETimelineParameter::AmplitudeMin:
+	case ETimelineParameter::AmplitudeMax:
+		ProceduralController.GetAmplitudeRange(Min, Max);
+		ProceduralController.SetAmplitudeRange(
+			Parameter == ETimelineParameter::AmplitudeMin ? Value : Min,
+			Parameter == ETimelineParameter::AmplitudeMax ? Value : Max);
+		break;
+	case ETimelineParameter::DurationMin:
+	case ETimelineParameter::DurationMax:
+		ProceduralController.GetDurationRange(Min, Max);
+		ProceduralController.SetDurationRange(
+			Parameter == ETimelineParameter::DurationMin ? Value : Min,
+			Parameter == ETimelineParameter::DurationMax ? Value : Max);
+		break;
+	}
+}
+
+bool FSandboxManager::AddPhysicsObject(TSharedPtr<FPhysicsObject> Object)
+{
+	if (PhysicsWorld.GetObjects().Num() >= GetSandboxArrayLimit(FSandboxCapacity::MaxBodies))
+	{
+		++RefusedSpawns;
+		return false;
+	}
+
+	FMemoryCharge& PhysicsMemory = MemoryCharges[(int32)EMemoryTag::Physics];
+	if (!PhysicsMemory.TrySet(PhysicsMemory.Get() + BodyFootprintBytes))
+	{
+		++RefusedSpawns;
+		return false;
+	}
+
+	AttachPhysicsObject(Object);
+	return true;
+}
+
+void FSandboxManager::AttachPhysicsObject(TSharedPtr<FPhysicsObject> Object)
 {
 	PhysicsWorld.AddObject(Object);
 	AudioPhysicsIntegration.RegisterPhysicsObject(Object);
+	UpdateMemoryCharges();
 }
 
 void FSandboxManager::RemovePhysicsObject(TSharedPtr<FPhysicsObject> Object)
 {
 	PhysicsWorld.RemoveObject(Object);
 	AudioPhysicsIntegration.UnregisterPhysicsObject(Object);
+	UpdateMemoryCharges();
+}
+
+void FSandboxManager::UpdateMemoryCharges()
+{
+	int64 AudioBytes = FrameTimeHistory.GetAllocatedSize() + StereoMix.GetAllocatedSize() + LeftoverAudio.GetAllocatedSize()
+		+ PhysicsAudioBuffer.GetAllocatedSize() + ProceduralAudioBuffer.GetAllocatedSize() + DeterminismTrace.GetAllocatedSize();
+	for (const TArray<float>& Bus : BusAudio)
+	{
+		AudioBytes += Bus.GetAllocatedSize();
+	}
+
+	const FPhysicsObjectArray& Objects = PhysicsWorld.GetObjects();
+	const int64 PhysicsBytes = (int64)Objects.Num() * BodyFootprintBytes + Objects.GetAllocatedSize();
+
+	const int64 IntegrationBytes = AudioPhysicsIntegration.GetImpactQueue()->GetAllocatedSize();
+
+	const int64 ProceduralBytes = ScriptRunner.GetArena().GetCapacityBytes() + Timeline.GetEvents().GetAllocatedSize()
+		+ RhythmBindings.GetAllocatedSize() + RhythmTriggers.GetAllocatedSize() + RhythmEvents.GetAllocatedSize();
+
+	MemoryCharges[(int32)EMemoryTag::Audio].Set(AudioBytes);
+	MemoryCharges[(int32)EMemoryTag::Physics].Set(PhysicsBytes);
+	MemoryCharges[(int32)EMemoryTag::Integration].Set(IntegrationBytes);
+	MemoryCharges[(int32)EMemoryTag::Procedural].Set(ProceduralBytes);
+}
+
+void FSandboxManager::SetOutputLayout(EChannelLayout Layout)
+{
+	OutputPanner.SetLayout(Layout);
+	StereoMix.SetNum(Layout == EChannelLayout::Stereo ? 0 : BufferSize * 2);
+	LeftoverAudio.SetNum(BufferSize * OutputPanner.GetNumChannels());
+	LeftoverOffset = BufferSize;
 }
 
 void FSandboxManager::SetMasterVolume(float Volume)
@@ -132,37 +724,208 @@ bool FSandboxManager::GetStats(FSandboxStats& OutStats) const
 	// Calculate average audio level (simplified)
 	OutStats.AverageAudioLevel = 0.5f;
 
+	const FMemoryAccounting& Accounting = FMemoryAccounting::Get();
+	for (int32 Tag = 0; Tag < (int32)EMemoryTag::Count; ++Tag)
+	{
+		OutStats.SandboxMemory[Tag] = MemoryCharges[Tag].Get();
+		OutStats.MemoryUsed[Tag] = Accounting.GetUsed((EMemoryTag)Tag);
+		OutStats.MemoryPeak[Tag] = Accounting.GetPeak((EMemoryTag)Tag);
+		OutStats.MemoryBudget[Tag] = Accounting.GetBudget((EMemoryTag)Tag);
+	}
+	OutStats.RefusedSpawns = RefusedSpawns;
+
 	return true;
 }
 
-void FSandboxManager::ProcessProceduralAudio(TArray<float>& OutBuffer)
+void FSandboxManager::CaptureSnapshot(FSandboxSnapshot& OutSnapshot) const
 {
-	OutBuffer.SetNum(BufferSize * 2);
+	FSandboxSnapshot::FHeader& Header = OutSnapshot.Header;
+	Header.Magic = FSandboxSnapshot::Magic;
+	Header.Version = FSandboxSnapshot::Version;
+	Header.SampleRate = SampleRate;
+	Header.BufferSize = BufferSize;
+	Header.FrameIndex = RenderedFrames;
+	Header.NumBodies = PhysicsWorld.GetObjects().Num();
 
-	// Generate procedural parameters
-	float Frequency, Amplitude, Richness, Duration;
-	ProceduralController.GenerateParameters(Frequency, Amplitude, Richness, Duration);
+	TSharedPtr<TArray<uint8>> Image = MakeShared<TArray<uint8>>();
+	FSandboxArchive Ar(*Image);
 
-	// Create oscillator with generated parameters
-	FOscillator Osc(SampleRate);
-	Osc.SetFrequency(Frequency);
-	Osc.SetAmplitude(Amplitude * 0.3f); // Reduce volume to avoid clipping
+	// Serialization is symmetric; a saving archive only reads from this sandbox
+	const_cast<FSandboxManager*>(this)->SerializeState(Ar);
 
-	// Set waveform based on spectral richness
-	if (Richness < 0.33f)
+	OutSnapshot.Image = Image;
+}
+
+bool FSandboxManager::RestoreSnapshot(const FSandboxSnapshot& Snapshot)
+{
+	if (!Snapshot.IsValid()
+		|| Snapshot.GetHeader().SampleRate != SampleRate
+		|| Snapshot.GetHeader().BufferSize != BufferSize)
 	{
-		Osc.SetWaveform(FOscillator::EWaveform::Sine);
+		return false;
 	}
-	else if (Richness < 0.66f)
+
+	FSandboxArchive Ar(Snapshot.GetImageData(), Snapshot.GetImageSize());
+	SerializeState(Ar);
+
+	// Resume the script from the restored sample clock
+	Timeline.Seek(RenderedFrames);
+
+	return !Ar.IsError();
+}
+
+TUniquePtr<FSandboxManager> FSandboxManager::Fork(const FSandboxSnapshot& Snapshot)
+{
+	if (!Snapshot.IsValid())
 	{
-		Osc.SetWaveform(FOscillator::EWaveform::Triangle);
+		return nullptr;
 	}
-	else
+
+	TUniquePtr<FSandboxManager> Forked = MakeUnique<FSandboxManager>(
+		Snapshot.GetHeader().SampleRate, Snapshot.GetHeader().BufferSize);
+
+	if (!Forked->RestoreSnapshot(Snapshot))
+	{
+		return nullptr;
+	}
+	return Forked;
+}
+
+void FSandboxManager::SerializeState(FSandboxArchive& Ar)
+{
+	Ar << SimulationSpeed << bUseProceduralGeneration << bUsePhysicsAudio << bUseResonanceSynthesis;
+	Ar << RenderedFrames;
+
+	FVector3 Gravity = PhysicsWorld.GetGravity();
+	Ar << Gravity;
+
+	// Body table: one shape tag per body, followed by each body's state
+	TArray<EPhysicsShape> Shapes;
+	if (Ar.IsSaving())
+	{
+		for (const TSharedPtr<FPhysicsObject>& Object : PhysicsWorld.GetObjects())
+		{
+			Shapes.Add(Object->GetShape());
+		}
+	}
+	Ar << Shapes;
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError())
+		{
+			return;
+		}
+		PhysicsWorld.SetGravity(Gravity);
+		MatchBodyLayout(Shapes);
+	}
+
+	for (const TSharedPtr<FPhysicsObject>& Object : PhysicsWorld.GetObjects())
+	{
+		Object->Serialize(Ar);
+	}
+
+	ForceFields.Serialize(Ar);
+
+	AudioPhysicsIntegration.Serialize(Ar);
+	ProceduralController.Serialize(Ar);
+	ProceduralOscillator.Serialize(Ar);
+	Ar << LastControlTick << ControlAmplitude;
+	EChannelLayout Layout = OutputPanner.GetLayout();
+	Ar << Layout;
+	if (Ar.IsLoading() && Layout != OutputPanner.GetLayout())
+	{
+		SetOutputLayout(Layout);
+	}
+	Ar << LeftoverOffset << LeftoverAudio;
+	Rhythm.Serialize(Ar);
+	Ar << RhythmBindings;
+}
+
+void FSandboxManager::MatchBodyLayout(const TArray<EPhysicsShape>& Shapes)
+{
+	const FPhysicsObjectArray& Objects = PhysicsWorld.GetObjects();
+
+	bool bLayoutMatches = Objects.Num() == Shapes.Num();
+	for (int32 i = 0; bLayoutMatches && i < Objects.Num(); ++i)
+	{
+		bLayoutMatches = Objects[i]->GetShape() == Shapes[i];
+	}
+
+	// Restoring into the same layout keeps existing body references valid
+	if (bLayoutMatches)
+	{
+		return;
+	}
+
+	while (Objects.Num() > 0)
+	{
+		TSharedPtr<FPhysicsObject> Object = Objects[Objects.Num() - 1];
+		RemovePhysicsObject(Object);
+	}
+
+	for (EPhysicsShape Shape : Shapes)
+	{
+		TSharedPtr<FPhysicsObject> Object;
+		if (Shape == EPhysicsShape::Sphere)
+		{
+			Object = MakeShared<FPhysicsSphere>();
+		}
+		else
+		{
+			Object = MakeShared<FPhysicsObject>();
+		}
+
+		// A restored scene must match its snapshot, so these bypass the spawn budget
+		AttachPhysicsObject(Object);
+	}
+}
+
+void FSandboxManager::ProcessProceduralAudio(TArray<float>& OutBuffer, int64 Frame, int32 NumFrames)
+{
+	OutBuffer.SetNum(NumFrames * 2);
+
+	// Refresh the voice once per control tick: once per block, or on the low-latency schedule.
+	// Never per segment, so events splitting a block do not speed up the generators.
+	const int64 ControlTick = ControlPeriod > 0 ? Frame / ControlPeriod : RenderedFrames / BufferSize;
+	if (ControlTick != LastControlTick)
+	{
+		LastControlTick = ControlTick;
+
+		// Pull only the parameters this block needs; a silent block skips the rest
+		ProceduralController.BeginBlock();
+		ControlAmplitude = ProceduralController.GetParameter(EProceduralParameter::Amplitude);
+		if (ControlAmplitude > 0.0f)
+		{
+			const float Frequency = ProceduralController.GetParameter(EProceduralParameter::Frequency);
+			const float Richness = ProceduralController.GetParameter(EProceduralParameter::SpectralRichness);
+
+			ProceduralOscillator.SetFrequency(Frequency);
+			ProceduralOscillator.SetAmplitude(ControlAmplitude * 0.3f); // Reduce volume to avoid clipping
+
+			// Set waveform based on spectral richness
+			if (Richness < 0.33f)
+			{
+				ProceduralOscillator.SetWaveform(FOscillator::EWaveform::Sine);
+			}
+			else if (Richness < 0.66f)
+			{
+				ProceduralOscillator.SetWaveform(FOscillator::EWaveform::Triangle);
+			}
+			else
+			{
+				ProceduralOscillator.SetWaveform(FOscillator::EWaveform::Sawtooth);
+			}
+		}
+	}
+
+	if (ControlAmplitude <= 0.0f)
 	{
-		Osc.SetWaveform(FOscillator::EWaveform::Sawtooth);
+		FMemory::Memzero(OutBuffer.GetData(), sizeof(float) * OutBuffer.Num());
+		return;
 	}
 
-	Osc.GenerateSamples(OutBuffer, BufferSize);
+	ProceduralOscillator.GenerateSamples(OutBuffer, NumFrames);
 }
 
 void FSandboxManager::ProcessPhysicsAudio(TArray<float>& OutBuffer)
@@ -248,7 +1011,7 @@ void FResonantSurfaceSandbox::SetSurfaceDamping(float Damping)
 FGranularPhysicsSandbox::FGranularPhysicsSandbox(float InSampleRate)
 	: FSandboxManager(InSampleRate, 2048)
 	, GrainDuration(0.05f)
-	, GrainOverlap(4)
+	, GrainOverlap(FMath::Min(4, GetSandboxArrayLimit(FSandboxCapacity::MaxVoices)))
 {
 	// Create grain voices
 	for (int32 i = 0; i < GrainOverlap; ++i)
@@ -261,7 +1024,7 @@ FGranularPhysicsSandbox::FGranularPhysicsSandbox(float InSampleRate)
 void FGranularPhysicsSandbox::ConfigureGrains(float InGrainDuration, int32 InGrainOverlap)
 {
 	GrainDuration = FMath::Max(InGrainDuration, 0.01f);
-	GrainOverlap = FMath::Max(InGrainOverlap, 1);
+	GrainOverlap = FMath::Clamp(InGrainOverlap, 1, GetSandboxArrayLimit(FSandboxCapacity::MaxVoices));
 
 	// Recreate grain voices
 	GrainVoices.Clear();
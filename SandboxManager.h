@@ -5,6 +5,83 @@
 #include "Physics/PhysicsCore.h"
 #include "Integration/AudioPhysicsIntegration.h"
 #include "Procedural/ProceduralGeneration.h"
+#include "SandboxArchive.h"
+#include "SceneTimeline.h"
+#include "SceneScript.h"
+#include "Procedural/RhythmGenerator.h"
+#include "Physics/ForceField.h"
+#include "Audio/ChannelLayout.h"
+#include "AssetHotReload.h"
+#include "MemoryAccounting.h"
+
+/**
+ * Mix buses; every source renders into one of them before the master clip
+ */
+enum class ESandboxBus : uint8
+{
+	Physics,      // Impacts and their resonance
+	Procedural,   // Procedural voice
+	Count
+};
+
+/** Short lowercase bus name, e.g. for stem file names */
+inline const TCHAR* GetSandboxBusName(ESandboxBus Bus)
+{
+	switch (Bus)
+	{
+	case ESandboxBus::Physics:    return TEXT("physics");
+	case ESandboxBus::Procedural: return TEXT("procedural");
+	default:                      return TEXT("unknown");
+	}
+}
+
+/**
+ * Stages hashed per block in determinism mode, in processing order
+ */
+enum class EDeterminismStage : uint8
+{
+	Physics,           // Body positions and velocities at the end of the block
+	PhysicsAudio,      // Impact and resonance voices
+	ProceduralAudio,
+	Mix,               // Clipped stereo mix
+	Output,            // Final output in the output layout
+	Count
+};
+
+inline const TCHAR* GetDeterminismStageName(EDeterminismStage Stage)
+{
+	switch (Stage)
+	{
+	case EDeterminismStage::Physics:         return TEXT("physics");
+	case EDeterminismStage::PhysicsAudio:    return TEXT("physics-audio");
+	case EDeterminismStage::ProceduralAudio: return TEXT("procedural-audio");
+	case EDeterminismStage::Mix:             return TEXT("mix");
+	case EDeterminismStage::Output:          return TEXT("output");
+	default:                                 return TEXT("unknown");
+	}
+}
+
+/**
+ * Bit-exact fingerprint of one block
+ */
+struct FDeterminismBlockHash
+{
+	int64 Frame;   // First frame of the block
+	uint64 Stages[(int32)EDeterminismStage::Count];
+};
+
+/** 64-bit FNV-1a over raw bytes; start from DeterminismHashSeed */
+constexpr uint64 DeterminismHashSeed = 0xCBF29CE484222325ull;
+
+inline uint64 HashDeterminismBytes(uint64 Hash, const void* Data, int32 NumBytes)
+{
+	const uint8* Bytes = static_cast<const uint8*>(Data);
+	for (int32 i = 0; i < NumBytes; ++i)
+	{
+		Hash = (Hash ^ Bytes[i]) * 0x100000001B3ull;
+	}
+	return Hash;
+}
 
 /**
  * Main Audio/Physics Sandbox
@@ -28,30 +105,183 @@ public:
 	/**
 	 * Main update loop - simulate physics, generate audio
 	 * @param DeltaTime Time step in seconds
-	 * @param OutAudioBuffer Generated stereo audio (interleaved)
+	 * @param OutAudioBuffer Generated audio, interleaved in the output layout (stereo by default)
 	 * @return Number of samples generated
 	 */
 	int32 Update(float DeltaTime, TArray<float>& OutAudioBuffer);
 
+	/**
+	 * Render a device callback of any size
+	 * Processing still runs in fixed sub-blocks of BufferSize frames, each simulating
+	 * BufferSize / SampleRate seconds. Whole sub-blocks are rendered straight into
+	 * OutAudio; the unused tail of a partial one is kept and delivered first next call.
+	 * Leftover frames are only handed out by this overload, so do not mix the two.
+	 * @param OutAudio Interleaved destination in the output layout with room for NumFrames frames
+	 * @param NumFrames Frames requested, clamped to the maximum callback size
+	 * @return Number of frames written
+	 */
+	int32 Update(float* OutAudio, int32 NumFrames);
+
+	/** Largest frame count accepted by the variable-size Update (default 8192) */
+	void SetMaxCallbackFrames(int32 MaxFrames) { MaxCallbackFrames = FMath::Max(MaxFrames, 1); }
+	int32 GetMaxCallbackFrames() const { return MaxCallbackFrames; }
+
+	/** Frames rendered ahead of the variable-size Update's output */
+	int32 GetBufferedFrames() const { return BufferSize - LeftoverOffset; }
+
+	/**
+	 * Channel layout of Update's output (default stereo)
+	 * The engine mixes in stereo; other layouts are produced from that mix by the
+	 * layout's panning kernel, so stereo output takes no extra pass.
+	 * Changing the layout drops frames buffered by the variable-size Update.
+	 */
+	void SetOutputLayout(EChannelLayout Layout);
+	EChannelLayout GetOutputLayout() const { return OutputPanner.GetLayout(); }
+	int32 GetNumOutputChannels() const { return OutputPanner.GetNumChannels(); }
+	const FChannelPanner& GetOutputPanner() const { return OutputPanner; }
+
 	// Physics world management
 	FPhysicsWorld* GetPhysicsWorld() { return &PhysicsWorld; }
-	void AddPhysicsObject(TSharedPtr<FPhysicsObject> Object);
+
+	/**
+	 * Procedural force fields applied to all bodies before each physics step
+	 * Fields are part of snapshots
+	 */
+	FForceFieldSystem* GetForceFields() { return &ForceFields; }
+
+	/**
+	 * Add a body; refused when the physics memory budget is exhausted or, in the
+	 * static-capacity profile, the world already holds FSandboxCapacity::MaxBodies
+	 * @return false if refused
+	 */
+	bool AddPhysicsObject(TSharedPtr<FPhysicsObject> Object);
 	void RemovePhysicsObject(TSharedPtr<FPhysicsObject> Object);
 
 	// Audio/Physics integration
 	FAudioPhysicsSandbox* GetAudioPhysics() { return &AudioPhysicsIntegration; }
 	FProceduralController* GetProceduralController() { return &ProceduralController; }
 
+	/**
+	 * Scripted events fired sample-accurately during Update
+	 * Event frames are on the sandbox sample clock (see GetRenderedFrames)
+	 * Events a script adds for its wake frame or earlier fire on the wake frame, unless already passed by the cursor
+	 */
+	FSceneTimeline* GetTimeline() { return &Timeline; }
+
+	/**
+	 * Coroutine scene scripts resumed during Update
+	 * Frames of scripts taking this sandbox as first parameter come from the runner's arena
+	 * Running scripts are not part of snapshots
+	 */
+	FSceneScriptRunner* GetScriptRunner() { return &ScriptRunner; }
+	bool StartScript(FSceneScript Script) { return ScriptRunner.Start(MoveTemp(Script)); }
+
+	/**
+	 * Tempo-synced rhythm patterns evaluated once per block
+	 * Each pattern fires its bound action (an event template) on its exact trigger frame;
+	 * impulse actions are scaled by the trigger velocity
+	 */
+	FRhythmGenerator* GetRhythmGenerator() { return &Rhythm; }
+	void SetRhythmAction(int32 PatternIndex, const FTimelineEvent& Action);
+
+	/**
+	 * Materials, synth presets and generator graphs reloaded in the background
+	 * Start its loader thread to watch a directory; newly published assets are
+	 * applied at the start of the next Update without blocking or allocating
+	 */
+	FAssetHotReloader* GetHotReloader() { return &HotReloader; }
+
+	/**
+	 * End initialization; rendering afterwards does not allocate
+	 * Creates every body the timeline and rhythm actions can spawn (up to
+	 * FSandboxCapacity::MaxBodies) and the generators their swaps need, and sizes
+	 * the scratch buffers. Spawns then reinitialize pooled bodies and swaps take
+	 * pooled generators, returning the ones they replace to the pool; a swap with no
+	 * room to retire the generator it replaces is refused and counted in RefusedSpawns
+	 * rather than freeing it on the render thread. Call once the
+	 * scene is built, before the first Update. Determinism traces still grow
+	 * per block, so leave tracing off in sealed runs.
+	 * @return false if the scene spawns or swaps more than the capacity allows
+	 */
+	bool SealAllocations();
+	bool IsSealed() const { return bSealed; }
+
 	// Configuration
 	void SetMasterVolume(float Volume);
 	void EnableProceduralGeneration(bool bEnable) { bUseProceduralGeneration = bEnable; }
 	void EnablePhysicsAudio(bool bEnable) { bUsePhysicsAudio = bEnable; }
 	void EnableResonance(bool bEnable) { bUseResonanceSynthesis = bEnable; }
 
+	/**
+	 * Keep each bus's share of the last rendered block, for stem export
+	 * Bus audio is stereo and scaled by the bus's mix gain before clipping, so the
+	 * buses sum to the unclipped mix
+	 */
+	void EnableBusCapture(bool bEnable);
+	bool IsBusCaptureEnabled() const { return bCaptureBuses; }
+
+	/** Whether a bus currently receives audio; disabled sources leave their bus silent */
+	bool IsBusActive(ESandboxBus Bus) const;
+
+	/** BufferSize interleaved stereo frames; empty unless bus capture is enabled */
+	const TArray<float>& GetBusAudio(ESandboxBus Bus) const { return BusAudio[(int32)Bus]; }
+
+	/**
+	 * Determinism mode: hash the output of every stage of every block
+	 * Identical traces mean bit-identical renders; the first differing entry
+	 * locates the block and stage where two runs diverged
+	 */
+	void EnableDeterminismTrace(bool bEnable) { bTraceDeterminism = bEnable; }
+	bool IsDeterminismTraceEnabled() const { return bTraceDeterminism; }
+	const TArray<FDeterminismBlockHash>& GetDeterminismTrace() const { return DeterminismTrace; }
+	void ClearDeterminismTrace() { DeterminismTrace.Reset(); }
+
+	/**
+	 * Low-latency mode for small blocks (32-128 frames)
+	 * Procedural parameters are evaluated on a fixed control-rate schedule instead of
+	 * once per Update, so neither their cost nor the generators' evolution scales with
+	 * the call rate. Pair with a small BufferSize.
+	 * @param ControlPeriodFrames Frames between procedural parameter updates
+	 */
+	void EnableLowLatencyMode(bool bEnable, int32 ControlPeriodFrames = 256)
+	{
+		// Tick numbers differ between the schedules; the next segment refreshes on either
+		ControlPeriod = bEnable ? FMath::Max(ControlPeriodFrames, 1) : 0;
+		LastControlTick = -1;
+	}
+	bool IsLowLatencyMode() const { return ControlPeriod > 0; }
+
 	// Runtime parameters
 	void SetSimulationSpeed(float Speed) { SimulationSpeed = FMath::Max(Speed, 0.1f); }
 	float GetSimulationSpeed() const { return SimulationSpeed; }
 
+	// Snapshots and forking
+	/**
+	 * Capture the full simulation state into a contiguous image
+	 * Bodies, voice states, generator states and the sample clock
+	 * @param OutSnapshot Receives the image; copies of it share the same memory
+	 */
+	void CaptureSnapshot(FSandboxSnapshot& OutSnapshot) const;
+
+	/**
+	 * Restore simulation state from a snapshot
+	 * Bodies are updated in place when the body layout matches, otherwise rebuilt
+	 * @return false if the snapshot is invalid or was taken with another sample rate or buffer size
+	 */
+	bool RestoreSnapshot(const FSandboxSnapshot& Snapshot);
+
+	/**
+	 * Create a new sandbox that resumes from a snapshot's warm state
+	 * Custom procedural generators cannot be rebuilt and must be set on the fork
+	 * @return nullptr if the snapshot could not be restored
+	 */
+	static TUniquePtr<FSandboxManager> Fork(const FSandboxSnapshot& Snapshot);
+
+	/** Frames rendered since construction (sample clock), including buffered frames */
+	int64 GetRenderedFrames() const { return RenderedFrames; }
+	float GetSampleRate() const { return SampleRate; }
+	int32 GetBufferSize() const { return BufferSize; }
+
 	// Statistics
 	struct FSandboxStats
 	{
@@ -59,14 +289,26 @@ public:
 		int32 QueuedImpacts;
 		float AverageAudioLevel;
 		float SimulationFrameTime;
+
+		// Memory per EMemoryTag: this sandbox's share, and the process-wide totals and budgets it counts against
+		int64 SandboxMemory[(int32)EMemoryTag::Count];
+		int64 MemoryUsed[(int32)EMemoryTag::Count];
+		int64 MemoryPeak[(int32)EMemoryTag::Count];
+		int64 MemoryBudget[(int32)EMemoryTag::Count];   // 0 = unlimited
+		int32 RefusedSpawns;
 	};
 
 	bool GetStats(FSandboxStats& OutStats) const;
 
 private:
 	FPhysicsWorld PhysicsWorld;
+	FForceFieldSystem ForceFields;
 	FAudioPhysicsSandbox AudioPhysicsIntegration;
 	FProceduralController ProceduralController;
+	FSceneTimeline Timeline;
+	FSceneScriptRunner ScriptRunner;
+	FRhythmGenerator Rhythm;
+	FAssetHotReloader HotReloader;
 
 	float SampleRate;
 	int32 BufferSize;
@@ -78,12 +320,93 @@ private:
 	bool bUseResonanceSynthesis;
 	bool bInitialized;
 
-	// Performance tracking
+	// Performance tracking (ring of the last FrameTimeHistorySize frames)
+	static constexpr int32 FrameTimeHistorySize = 100;
 	float LastFrameTime;
 	TArray<float> FrameTimeHistory;
+	int32 FrameTimeIndex;
+
+	// Sample clock
+	int64 RenderedFrames;
+
+	// Output layout; non-stereo layouts render the mix into StereoMix first
+	FChannelPanner OutputPanner;
+	TArray<float> StereoMix;
+
+	// Variable-size callbacks: the last sub-block rendered and how much of it was delivered
+	int32 MaxCallbackFrames;
+	TArray<float> LeftoverAudio;
+	int32 LeftoverOffset;
+
+	// Determinism mode: stage hashes of every block rendered, and of the block in progress
+	bool bTraceDeterminism;
+	TArray<FDeterminismBlockHash> DeterminismTrace;
+	FDeterminismBlockHash BlockHash;
+
+	// Per-bus copies of the last block (bus capture only)
+	bool bCaptureBuses;
+	TArray<float> BusAudio[(int32)ESandboxBus::Count];
+
+	// Scratch buffers reused across segments
+	TArray<float> PhysicsAudioBuffer;
+	TArray<float> ProceduralAudioBuffer;
+
+	// Procedural voice, kept across blocks; its parameters are refreshed once per control tick
+	FOscillator ProceduralOscillator;
+	int32 ControlPeriod;        // 0 = refresh once per block
+	int64 LastControlTick;
+	float ControlAmplitude;
+
+	// Rhythm actions per pattern and the triggers scheduled for the current block
+	struct FRhythmBinding
+	{
+		FTimelineEvent Action;
+		bool bBound;
+	};
+	TSandboxArray<FRhythmBinding, FSandboxCapacity::MaxGenerators> RhythmBindings;
+	FRhythmTriggerArray RhythmTriggers;
+	FTimelineEventArray RhythmEvents;
+	int32 NextRhythmEvent;
+
+	// Hot-reload reader slot, the newest published version seen, and the version of each asset applied
+	int32 HotReloadReader;
+	uint32 AppliedAssetVersion;
+	uint32 AppliedMaterialVersion;
+	uint32 AppliedPresetVersion;
+	uint32 AppliedGraphVersions[(int32)EProceduralParameter::Count];
+
+	// Memory this sandbox holds, charged per tag and refreshed after every block
+	// A body costs the object, its shared-pointer control block and its slots in the world and audio lists
+	// MakeShared puts the control block (vtable pointer, shared and weak counts) in the object's allocation
+	static constexpr int64 SharedControlBlockBytes = sizeof(void*) + 2 * sizeof(int32);
+	static constexpr int64 BodyFootprintBytes = sizeof(FPhysicsSphere) + SharedControlBlockBytes + 3 * sizeof(TSharedPtr<FPhysicsObject>);
+	FMemoryCharge MemoryCharges[(int32)EMemoryTag::Count];
+	int32 RefusedSpawns;
+
+	// Sealed scenes spawn from these pools; PooledGenerators lists every generator the pool created,
+	// and replaced generators from elsewhere are retired rather than freed, or the swap is refused
+	// once RetiredGenerators is full
+	bool bSealed;
+	TSandboxArray<TSharedPtr<FPhysicsSphere>, FSandboxCapacity::MaxBodies> SpherePool;
+	TSandboxArray<TUniquePtr<FProceduralGenerator>, FSandboxCapacity::MaxGenerators> GeneratorPool;
+	TSandboxArray<const FProceduralGenerator*, FSandboxCapacity::MaxGenerators> PooledGenerators;
+	TSandboxArray<TUniquePtr<FProceduralGenerator>, FSandboxCapacity::MaxGenerators> RetiredGenerators;
 
 	void Initialize();
-	void ProcessProceduralAudio(TArray<float>& OutBuffer);
+	void AttachPhysicsObject(TSharedPtr<FPhysicsObject> Object);
+	void UpdateMemoryCharges();
+	void SerializeState(FSandboxArchive& Ar);
+	void MatchBodyLayout(const TArray<EPhysicsShape>& Shapes);
+	void RenderBlock(float DeltaTime, float* OutAudio);
+	void RenderSegment(float DeltaTime, int32 FrameOffset, int32 NumFrames, float* OutAudio);
+	void ApplyTimelineEvents(int64 Frame);
+	void ScheduleRhythmEvents();
+	void ApplyHotAssets();
+	void ApplyEvent(const FTimelineEvent& Event);
+	void SpawnSphere(const FTimelineEvent& Event);
+	void SwapGenerator(const FTimelineEvent& Event);
+	void ApplyTimelineParameter(ETimelineParameter Parameter, float Value);
+	void ProcessProceduralAudio(TArray<float>& OutBuffer, int64 Frame, int32 NumFrames);
 	void ProcessPhysicsAudio(TArray<float>& OutBuffer);
 	void MixAudio(TArray<float>& OutBuffer, const TArray<float>& InBuffer, float Volume);
 };
@@ -137,7 +460,7 @@ public:
 	/**
 	 * Configure grain synthesis
 	 * @param GrainDuration Duration of each grain (seconds)
-	 * @param GrainOverlap Number of overlapping grains
+	 * @param GrainOverlap Number of overlapping grains, at most FSandboxCapacity::MaxVoices in the static profile
 	 */
 	void ConfigureGrains(float GrainDuration, int32 GrainOverlap);
 
@@ -146,5 +469,5 @@ public:
 private:
 	float GrainDuration;
 	int32 GrainOverlap;
-	TArray<TSharedPtr<FImpactSynthesizer>> GrainVoices;
+	TSandboxArray<TSharedPtr<FImpactSynthesizer>, FSandboxCapacity::MaxVoices> GrainVoices;
 };
@@ -0,0 +1,281 @@
+#include "SceneScript.h"
+#include "SandboxManager.h"
+
+namespace
+{
+	/**
+	 * Every frame is prefixed with the arena it came from (nullptr = heap)
+	 * 16 bytes keeps the coroutine frame itself 16-byte aligned
+	 */
+	constexpr size_t FrameHeaderSize = 16;
+
+	bool WakesEarlier(const FSceneScript::FHandle& A, const FSceneScript::FHandle& B)
+	{
+		return A.promise().WakeFrame < B.promise().WakeFrame;
+	}
+}
+
+// ============================================================================
+// FScriptFrameArena Implementation
+// ============================================================================
+
+FScriptFrameArena::FScriptFrameArena(int32 InCapacityBytes)
+	: Memory(nullptr)
+	, Capacity(FMath::Max(InCapacityBytes, Granularity))
+	, Top(0)
+	, LiveFrames(0)
+{
+	Memory = static_cast<uint8*>(FMemory::Malloc(Capacity, Granularity));
+	for (int32 i = 0; i < NumSizeClasses; ++i)
+	{
+		FreeLists[i] = nullptr;
+	}
+}
+
+FScriptFrameArena::~FScriptFrameArena()
+{
+	FMemory::Free(Memory);
+}
+
+void* FScriptFrameArena::Allocate(size_t Size)
+{
+	const size_t SizeClass = (Size + Granularity - 1) / Granularity;
+	if (SizeClass == 0 || SizeClass >= NumSizeClasses)
+	{
+		return nullptr;
+	}
+
+	void* Ptr = FreeLists[SizeClass];
+	if (Ptr)
+	{
+		FreeLists[SizeClass] = *static_cast<void**>(Ptr);
+	}
+	else
+	{
+		const int32 Bytes = (int32)SizeClass * Granularity;
+		if (Top + Bytes > Capacity)
+		{
+			return nullptr;
+		}
+		Ptr = Memory + Top;
+		Top += Bytes;
+	}
+
+	++LiveFrames;
+	return Ptr;
+}
+
+void FScriptFrameArena::Free(void* Ptr, size_t Size)
+{
+	const size_t SizeClass = (Size + Granularity - 1) / Granularity;
+	*static_cast<void**>(Ptr) = FreeLists[SizeClass];
+	FreeLists[SizeClass] = Ptr;
+	--LiveFrames;
+}
+
+// ============================================================================
+// FSceneScript Implementation
+// ============================================================================
+
+void* FSceneScript::promise_type::AllocateFrame(FScriptFrameArena* Arena, size_t Size) noexcept
+{
+	const size_t Total = Size + FrameHeaderSize;
+	uint8* Block = static_cast<uint8*>(Arena ? Arena->Allocate(Total) : FMemory::Malloc(Total, FrameHeaderSize));
+	if (!Block)
+	{
+		return nullptr;
+	}
+
+	*reinterpret_cast<FScriptFrameArena**>(Block) = Arena;
+	return Block + FrameHeaderSize;
+}
+
+void FSceneScript::promise_type::operator delete(void* Ptr, size_t Size) noexcept
+{
+	uint8* Block = static_cast<uint8*>(Ptr) - FrameHeaderSize;
+	FScriptFrameArena* Arena = *reinterpret_cast<FScriptFrameArena**>(Block);
+	if (Arena)
+	{
+		Arena->Free(Block, Size + FrameHeaderSize);
+	}
+	else
+	{
+		FMemory::Free(Block);
+	}
+}
+
+FScriptFrameArena* FSceneScript::promise_type::GetSandboxArena(FSandboxManager& Sandbox)
+{
+	return &Sandbox.GetScriptRunner()->GetArena();
+}
+
+FScriptFrameArena* FSceneScript::promise_type::GetRunnerArena(FSceneScriptRunner& Runner)
+{
+	return &Runner.GetArena();
+}
+
+// ============================================================================
+// FSceneScriptRunner Implementation
+// ============================================================================
+
+FSceneScriptRunner::FSceneScriptRunner(float InSampleRate, int32 ArenaBytes, int32 InMaxScripts)
+	: Arena(ArenaBytes)
+	, SampleRate(InSampleRate)
+	, MaxScripts(FMath::Max(InMaxScripts, 1))
+	, CurrentFrame(0)
+	, ResumeCount(0)
+	, Granularity(EResumeGranularity::Block)
+	, NumResuming(0)
+{
+	TimedWaits.Reserve(MaxScripts);
+	ImpactWaits.Reserve(MaxScripts);
+	ReadyScripts.Reserve(MaxScripts);
+}
+
+FSceneScriptRunner::~FSceneScriptRunner()
+{
+	StopAll();
+}
+
+bool FSceneScriptRunner::Start(FSceneScript Script)
+{
+	if (!Script.IsValid() || Num() >= MaxScripts)
+	{
+		return false;
+	}
+
+	FSceneScript::FHandle Handle = Script.Release();
+	FSceneScript::promise_type& Promise = Handle.promise();
+	Promise.Runner = this;
+	Promise.Wait = EScriptWait::Frame;
+	Promise.WakeFrame = CurrentFrame;
+	PushTimed(Handle);
+	return true;
+}
+
+void FSceneScriptRunner::Resume(int64 Frame)
+{
+	CurrentFrame = Frame;
+
+	// Collect everything that is due first, so rescheduled scripts wait for the next call
+	ReadyScripts.Reset();
+	while (TimedWaits.Num() > 0 && TimedWaits[0].promise().WakeFrame <= Frame)
+	{
+		ReadyScripts.Add(PopTimed());
+	}
+
+	for (int32 i = ImpactWaits.Num() - 1; i >= 0; --i)
+	{
+		FSceneScript::promise_type& Promise = ImpactWaits[i].promise();
+		const FVector3 Velocity = Promise.WaitBody->GetVelocity();
+		if ((Velocity - Promise.LastVelocity).Magnitude() > Promise.ImpactThreshold)
+		{
+			ReadyScripts.Add(ImpactWaits[i]);
+			ImpactWaits.RemoveAtSwap(i);
+		}
+		else
+		{
+			Promise.LastVelocity = Velocity;
+		}
+	}
+
+	// Scripts started from a resumed script count those still in flight, so the limit holds
+	NumResuming = ReadyScripts.Num();
+	for (FSceneScript::FHandle Handle : ReadyScripts)
+	{
+		Handle.promise().WaitBody.Reset();
+		Handle.resume();
+		++ResumeCount;
+		--NumResuming;
+		Schedule(Handle);
+	}
+	ReadyScripts.Reset();
+}
+
+void FSceneScriptRunner::StopAll()
+{
+	for (FSceneScript::FHandle Handle : TimedWaits)
+	{
+		Handle.destroy();
+	}
+	for (FSceneScript::FHandle Handle : ImpactWaits)
+	{
+		Handle.destroy();
+	}
+	TimedWaits.Reset();
+	ImpactWaits.Reset();
+}
+
+int64 FSceneScriptRunner::GetNextWakeFrame() const
+{
+	if (Granularity == EResumeGranularity::Block || TimedWaits.Num() == 0)
+	{
+		return MAX_int64;
+	}
+	return TimedWaits[0].promise().WakeFrame;
+}
+
+void FSceneScriptRunner::Schedule(FSceneScript::FHandle Handle)
+{
+	if (Handle.done())
+	{
+		Handle.destroy();
+		return;
+	}
+
+	if (Handle.promise().Wait == EScriptWait::Impact)
+	{
+		ImpactWaits.Add(Handle);
+	}
+	else
+	{
+		PushTimed(Handle);
+	}
+}
+
+void FSceneScriptRunner::PushTimed(FSceneScript::FHandle Handle)
+{
+	// Sift up
+	int32 Index = TimedWaits.Add(Handle);
+	while (Index > 0)
+	{
+		const int32 Parent = (Index - 1) / 2;
+		if (!WakesEarlier(TimedWaits[Index], TimedWaits[Parent]))
+		{
+			break;
+		}
+		Swap(TimedWaits[Index], TimedWaits[Parent]);
+		Index = Parent;
+	}
+}
+
+FSceneScript::FHandle FSceneScriptRunner::PopTimed()
+{
+	FSceneScript::FHandle Top = TimedWaits[0];
+	TimedWaits.RemoveAtSwap(0);
+
+	// Sift down
+	int32 Index = 0;
+	const int32 Count = TimedWaits.Num();
+	for (;;)
+	{
+		const int32 Left = Index * 2 + 1;
+		const int32 Right = Left + 1;
+		int32 Smallest = Index;
+		if (Left < Count && WakesEarlier(TimedWaits[Left], TimedWaits[Smallest]))
+		{
+			Smallest = Left;
+		}
+		if (Right < Count && WakesEarlier(TimedWaits[Right], TimedWaits[Smallest]))
+		{
+			Smallest = Right;
+		}
+		if (Smallest == Index)
+		{
+			break;
+		}
+		Swap(TimedWaits[Index], TimedWaits[Smallest]);
+		Index = Smallest;
+	}
+	return Top;
+}
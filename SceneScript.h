@@ -0,0 +1,275 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Physics/PhysicsCore.h"
+#include <coroutine>
+#include <exception>
+
+class FSandboxManager;
+class FSceneScriptRunner;
+
+/**
+ * Fixed-capacity arena for scene script coroutine frames
+ * One upfront block carved into 64-byte size classes with per-class free lists,
+ * so starting and finishing scripts never touches the heap
+ */
+class FScriptFrameArena
+{
+public:
+	FScriptFrameArena(int32 InCapacityBytes = 256 * 1024);
+	~FScriptFrameArena();
+
+	FScriptFrameArena(const FScriptFrameArena&) = delete;
+	FScriptFrameArena& operator=(const FScriptFrameArena&) = delete;
+
+	/** @return nullptr when the arena is exhausted or Size exceeds the largest size class */
+	void* Allocate(size_t Size);
+	void Free(void* Ptr, size_t Size);
+
+	int32 GetUsedBytes() const { return Top; }
+	int32 GetCapacityBytes() const { return Capacity; }
+	int32 GetLiveFrames() const { return LiveFrames; }
+
+private:
+	static constexpr int32 Granularity = 64;
+	static constexpr int32 NumSizeClasses = 64; // Frames up to 4 KB
+
+	uint8* Memory;
+	int32 Capacity;
+	int32 Top;
+	int32 LiveFrames;
+	void* FreeLists[NumSizeClasses];
+};
+
+/**
+ * What a suspended script is waiting for
+ */
+enum class EScriptWait : uint8
+{
+	Frame,   // Resume once the sample clock reaches WakeFrame
+	Impact   // Resume when WaitBody's velocity jumps by more than ImpactThreshold
+};
+
+/**
+ * Coroutine-based scene script
+ *
+ * Usage:
+ *   FSceneScript DropTwice(FSandboxManager& Sandbox, TSharedPtr<FPhysicsSphere> Ball)
+ *   {
+ *       co_await Seconds(0.5f);
+ *       Sandbox.AddPhysicsObject(Ball);
+ *       co_await ImpactOn(Ball);
+ *       ...
+ *   }
+ *   Sandbox.StartScript(DropTwice(Sandbox, Ball));
+ *
+ * Scripts whose first parameter is an FSandboxManager& or FSceneScriptRunner&
+ * allocate their frame from that runner's arena; others fall back to the heap.
+ */
+class FSceneScript
+{
+public:
+	struct promise_type
+	{
+		FSceneScriptRunner* Runner = nullptr;
+		EScriptWait Wait = EScriptWait::Frame;
+		int64 WakeFrame = 0;
+		TSharedPtr<FPhysicsObject> WaitBody;
+		FVector3 LastVelocity;
+		float ImpactThreshold = 0.0f;
+
+		FSceneScript get_return_object() { return FSceneScript(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		static FSceneScript get_return_object_on_allocation_failure() { return FSceneScript(); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+
+		static void* operator new(size_t Size) noexcept { return AllocateFrame(nullptr, Size); }
+
+		template<typename... TArgs>
+		static void* operator new(size_t Size, FSandboxManager& Sandbox, TArgs&...) noexcept
+		{
+			return AllocateFrame(GetSandboxArena(Sandbox), Size);
+		}
+
+		template<typename... TArgs>
+		static void* operator new(size_t Size, FSceneScriptRunner& Runner, TArgs&...) noexcept
+		{
+			return AllocateFrame(GetRunnerArena(Runner), Size);
+		}
+
+		static void operator delete(void* Ptr, size_t Size) noexcept;
+
+	private:
+		static void* AllocateFrame(FScriptFrameArena* Arena, size_t Size) noexcept;
+		static FScriptFrameArena* GetSandboxArena(FSandboxManager& Sandbox);
+		static FScriptFrameArena* GetRunnerArena(FSceneScriptRunner& Runner);
+	};
+
+	typedef std::coroutine_handle<promise_type> FHandle;
+
+	FSceneScript() = default;
+	FSceneScript(FSceneScript&& Other) noexcept : Handle(Other.Handle) { Other.Handle = nullptr; }
+	FSceneScript& operator=(FSceneScript&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			Reset();
+			Handle = Other.Handle;
+			Other.Handle = nullptr;
+		}
+		return *this;
+	}
+	~FSceneScript() { Reset(); }
+
+	FSceneScript(const FSceneScript&) = delete;
+	FSceneScript& operator=(const FSceneScript&) = delete;
+
+	/** False if the frame could not be allocated */
+	bool IsValid() const { return (bool)Handle; }
+
+	/** Hand ownership of the coroutine to a runner */
+	FHandle Release()
+	{
+		FHandle Released = Handle;
+		Handle = nullptr;
+		return Released;
+	}
+
+private:
+	explicit FSceneScript(FHandle InHandle) : Handle(InHandle) {}
+
+	void Reset()
+	{
+		if (Handle)
+		{
+			Handle.destroy();
+			Handle = nullptr;
+		}
+	}
+
+	FHandle Handle;
+};
+
+/**
+ * Owns running scene scripts and resumes them on the sandbox sample clock
+ * Timed waits are kept in a min-heap by wake frame; impact waits are polled
+ */
+class FSceneScriptRunner
+{
+public:
+	enum class EResumeGranularity : uint8
+	{
+		Block,   // Due scripts resume at the next Update segment (cheapest)
+		Sample   // Update splits blocks so timed waits resume on their exact frame
+	};
+
+	FSceneScriptRunner(float InSampleRate = 48000.0f, int32 ArenaBytes = 256 * 1024, int32 InMaxScripts = 4096);
+	~FSceneScriptRunner();
+
+	FSceneScriptRunner(const FSceneScriptRunner&) = delete;
+	FSceneScriptRunner& operator=(const FSceneScriptRunner&) = delete;
+
+	/**
+	 * Start a script; it first runs on the next Resume call
+	 * @return false if the script frame failed to allocate or the runner is full
+	 */
+	bool Start(FSceneScript Script);
+
+	/** Resume every script whose wait is satisfied at Frame */
+	void Resume(int64 Frame);
+
+	/** Destroy all running scripts */
+	void StopAll();
+
+	/** Earliest timed wake-up, or MAX_int64 when nothing needs a sample-accurate split */
+	int64 GetNextWakeFrame() const;
+
+	void SetGranularity(EResumeGranularity InGranularity) { Granularity = InGranularity; }
+	EResumeGranularity GetGranularity() const { return Granularity; }
+
+	int64 GetCurrentFrame() const { return CurrentFrame; }
+	float GetSampleRate() const { return SampleRate; }
+	/** Running scripts, including those Resume has collected but not yet rescheduled */
+	int32 Num() const { return TimedWaits.Num() + ImpactWaits.Num() + NumResuming; }
+	uint64 GetResumeCount() const { return ResumeCount; }
+	FScriptFrameArena& GetArena() { return Arena; }
+
+private:
+	FScriptFrameArena Arena;
+	float SampleRate;
+	int32 MaxScripts;
+	int64 CurrentFrame;
+	uint64 ResumeCount;
+	EResumeGranularity Granularity;
+
+	TArray<FSceneScript::FHandle> TimedWaits;   // Min-heap on WakeFrame
+	TArray<FSceneScript::FHandle> ImpactWaits;
+	TArray<FSceneScript::FHandle> ReadyScripts; // Scratch, preallocated
+	int32 NumResuming;                          // Entries of ReadyScripts still to be resumed
+
+	void Schedule(FSceneScript::FHandle Handle);
+	void PushTimed(FSceneScript::FHandle Handle);
+	FSceneScript::FHandle PopTimed();
+};
+
+// ============================================================================
+// Awaitables
+// ============================================================================
+
+/** Suspend for a number of frames on the sample clock */
+struct FWaitFrames
+{
+	int64 NumFrames;
+
+	bool await_ready() const noexcept { return NumFrames <= 0; }
+	void await_suspend(FSceneScript::FHandle Handle) const noexcept
+	{
+		FSceneScript::promise_type& Promise = Handle.promise();
+		Promise.Wait = EScriptWait::Frame;
+		Promise.WakeFrame = Promise.Runner->GetCurrentFrame() + NumFrames;
+	}
+	void await_resume() const noexcept {}
+};
+
+/** Suspend for a duration in seconds (rounded to whole frames, at least one) */
+struct FWaitSeconds
+{
+	float Duration;
+
+	bool await_ready() const noexcept { return Duration <= 0.0f; }
+	void await_suspend(FSceneScript::FHandle Handle) const noexcept
+	{
+		FSceneScript::promise_type& Promise = Handle.promise();
+		const int64 NumFrames = (int64)(Duration * Promise.Runner->GetSampleRate() + 0.5f);
+		Promise.Wait = EScriptWait::Frame;
+		Promise.WakeFrame = Promise.Runner->GetCurrentFrame() + FMath::Max<int64>(NumFrames, 1);
+	}
+	void await_resume() const noexcept {}
+};
+
+/** Suspend until a body's velocity changes abruptly (collision or ground bounce) */
+struct FWaitImpact
+{
+	TSharedPtr<FPhysicsObject> Body;
+	float MinVelocityChange;
+
+	bool await_ready() const noexcept { return !Body.IsValid(); }
+	void await_suspend(FSceneScript::FHandle Handle) const noexcept
+	{
+		FSceneScript::promise_type& Promise = Handle.promise();
+		Promise.Wait = EScriptWait::Impact;
+		Promise.WaitBody = Body;
+		Promise.LastVelocity = Body->GetVelocity();
+		Promise.ImpactThreshold = MinVelocityChange;
+	}
+	void await_resume() const noexcept {}
+};
+
+inline FWaitFrames Frames(int64 NumFrames) { return FWaitFrames{ NumFrames }; }
+inline FWaitSeconds Seconds(float Duration) { return FWaitSeconds{ Duration }; }
+inline FWaitImpact ImpactOn(TSharedPtr<FPhysicsObject> Body, float MinVelocityChange = 2.0f)
+{
+	return FWaitImpact{ MoveTemp(Body), MinVelocityChange };
+}
@@ -0,0 +1,118 @@
+#include "SceneTimeline.h"
+
+// ============================================================================
+// FSceneTimeline Implementation
+// ============================================================================
+
+FSceneTimeline::FSceneTimeline(int32 InMaxEvents)
+	: MaxEvents(FMath::Clamp(InMaxEvents, 1, GetSandboxArrayLimit(FSandboxCapacity::MaxEvents)))
+	, Cursor(0)
+{
+	Events.Reserve(MaxEvents);
+}
+
+bool FSceneTimeline::AddEvent(const FTimelineEvent& Event)
+{
+	if (Events.Num() >= MaxEvents)
+	{
+		return false;
+	}
+
+	// Insert after any events on the same frame to keep insertion order
+	const int32 Index = FindBound(Event.Frame, true);
+	Events.Insert(Event, Index);
+
+	// Inserting behind the cursor must not re-fire consumed events
+	if (Index < Cursor)
+	{
+		++Cursor;
+	}
+	return true;
+}
+
+bool FSceneTimeline::AddSpawnSphere(int64 Frame, const FVector3& Position, float Radius, float Mass)
+{
+	FTimelineEvent Event;
+	Event.Frame = Frame;
+	Event.Type = ETimelineEventType::SpawnSphere;
+	Event.Vector = Position;
+	Event.Values[0] = Radius;
+	Event.Values[1] = Mass;
+	return AddEvent(Event);
+}
+
+bool FSceneTimeline::AddImpulse(int64 Frame, int32 BodyIndex, const FVector3& Impulse)
+{
+	FTimelineEvent Event;
+	Event.Frame = Frame;
+	Event.Type = ETimelineEventType::ApplyImpulse;
+	Event.BodyIndex = BodyIndex;
+	Event.Vector = Impulse;
+	return AddEvent(Event);
+}
+
+bool FSceneTimeline::AddParameterChange(int64 Frame, ETimelineParameter Parameter, float Value)
+{
+	FTimelineEvent Event;
+	Event.Frame = Frame;
+	Event.Type = ETimelineEventType::SetParameter;
+	Event.Parameter = Parameter;
+	Event.Values[0] = Value;
+	return AddEvent(Event);
+}
+
+bool FSceneTimeline::AddGeneratorSwap(int64 Frame, EProceduralParameter Slot, EProceduralGeneratorType Type, uint32 Seed)
+{
+	FTimelineEvent Event;
+	Event.Frame = Frame;
+	Event.Type = ETimelineEventType::SwapGenerator;
+	Event.Slot = Slot;
+	Event.GeneratorType = Type;
+	Event.Seed = Seed;
+	return AddEvent(Event);
+}
+
+void FSceneTimeline::Seek(int64 Frame)
+{
+	Cursor = FindBound(Frame, false);
+}
+
+int64 FSceneTimeline::GetNextEventFrame() const
+{
+	return Cursor < Events.Num() ? Events[Cursor].Frame : MAX_int64;
+}
+
+const FTimelineEvent* FSceneTimeline::PopDueEvent(int64 Frame)
+{
+	if (Cursor < Events.Num() && Events[Cursor].Frame <= Frame)
+	{
+		return &Events[Cursor++];
+	}
+	return nullptr;
+}
+
+void FSceneTimeline::Clear()
+{
+	Events.Reset();
+	Cursor = 0;
+}
+
+int32 FSceneTimeline::FindBound(int64 Frame, bool bInclusive) const
+{
+	int32 Low = 0;
+	int32 High = Events.Num();
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		const bool bBefore = bInclusive ? Events[Mid].Frame <= Frame : Events[Mid].Frame < Frame;
+		if (bBefore)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+	return Low;
+}
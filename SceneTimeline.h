@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StaticCapacity.h"
+#include "Physics/PhysicsCore.h"
+#include "Procedural/ProceduralGeneration.h"
+
+/**
+ * Scripted scene event kinds
+ */
+enum class ETimelineEventType : uint8
+{
+	SpawnSphere,     // Add a sphere at Vector with Values = {Radius, Mass}
+	ApplyImpulse,    // Impulse Vector on body BodyIndex
+	SetParameter,    // Set Parameter to Values[0]
+	SwapGenerator    // Replace the generator in Slot with a built-in GeneratorType seeded with Seed
+};
+
+/**
+ * Sandbox parameters that timeline events can change
+ */
+enum class ETimelineParameter : uint8
+{
+	MasterVolume,
+	SimulationSpeed,
+	FrequencyMin,
+	FrequencyMax,
+	AmplitudeMin,
+	AmplitudeMax,
+	DurationMin,
+	DurationMax
+};
+
+/**
+ * A single event on the scene timeline
+ * Plain data so the whole timeline is one contiguous array
+ */
+struct FTimelineEvent
+{
+	int64 Frame;               // Sample-accurate position on the sandbox sample clock
+	ETimelineEventType Type;
+	ETimelineParameter Parameter;
+	EProceduralParameter Slot;
+	EProceduralGeneratorType GeneratorType;
+	int32 BodyIndex;
+	uint32 Seed;
+	FVector3 Vector;
+	float Values[2];
+
+	FTimelineEvent()
+		: Frame(0)
+		, Type(ETimelineEventType::SetParameter)
+		, Parameter(ETimelineParameter::MasterVolume)
+		, Slot(EProceduralParameter::Frequency)
+		, GeneratorType(EProceduralGeneratorType::PerlinNoise)
+		, BodyIndex(INDEX_NONE)
+		, Seed(0)
+	{
+		Values[0] = 0.0f;
+		Values[1] = 0.0f;
+	}
+};
+
+/** Events held at once by a timeline or a block's rhythm schedule */
+using FTimelineEventArray = TSandboxArray<FTimelineEvent, FSandboxCapacity::MaxEvents>;
+
+/**
+ * Sample-accurate event timeline consumed by FSandboxManager::Update
+ *
+ * Events are kept sorted by frame in a preallocated array (inline storage
+ * of FSandboxCapacity::MaxEvents in the static-capacity profile, which also
+ * caps InMaxEvents); events on the same frame fire in insertion order. A playback cursor marks the next
+ * event to fire and Seek() repositions it with a binary search.
+ */
+class FSceneTimeline
+{
+public:
+	FSceneTimeline(int32 InMaxEvents = 1024);
+
+	/**
+	 * Insert an event in frame order
+	 * Events earlier than the playback cursor are skipped until the timeline is seeked back
+	 * @return false if the timeline is full
+	 */
+	bool AddEvent(const FTimelineEvent& Event);
+
+	// Authoring helpers
+	bool AddSpawnSphere(int64 Frame, const FVector3& Position, float Radius, float Mass);
+	bool AddImpulse(int64 Frame, int32 BodyIndex, const FVector3& Impulse);
+	bool AddParameterChange(int64 Frame, ETimelineParameter Parameter, float Value);
+	bool AddGeneratorSwap(int64 Frame, EProceduralParameter Slot, EProceduralGeneratorType Type, uint32 Seed);
+
+	/** Move the cursor to the first event at or after Frame */
+	void Seek(int64 Frame);
+
+	/** Frame of the next unfired event, or MAX_int64 if none remain */
+	int64 GetNextEventFrame() const;
+
+	/**
+	 * Pop the next event if it is due at or before Frame
+	 * @return nullptr once all due events are consumed
+	 */
+	const FTimelineEvent* PopDueEvent(int64 Frame);
+
+	void Clear();
+
+	int32 Num() const { return Events.Num(); }
+	int32 GetMaxEvents() const { return MaxEvents; }
+	int32 GetCursor() const { return Cursor; }
+	const FTimelineEventArray& GetEvents() const { return Events; }
+
+	static int64 SecondsToFrames(float Seconds, float SampleRate) { return (int64)(Seconds * SampleRate + 0.5f); }
+
+private:
+	FTimelineEventArray Events;
+	int32 MaxEvents;
+	int32 Cursor;
+
+	/** First index whose frame is greater than Frame (or >= when bInclusive is false) */
+	int32 FindBound(int64 Frame, bool bInclusive) const;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SANDBOX_HAS_SSE2 1
+#else
+#define SANDBOX_HAS_SSE2 0
+#endif
+
+/**
+ * Instruction-set paths a vectorized kernel can take
+ * Every level must produce the same output as Scalar; forcing a lower level
+ * at run time lets the determinism checker and golden tests compare them
+ */
+enum class ESimdLevel : uint8
+{
+	Scalar,
+	SSE2,
+	Count
+};
+
+/** Highest level this build can run */
+inline ESimdLevel GetSupportedSimdLevel()
+{
+	return SANDBOX_HAS_SSE2 ? ESimdLevel::SSE2 : ESimdLevel::Scalar;
+}
+
+namespace SimdLevelPrivate
+{
+	inline std::atomic<uint8> ActiveLevel((uint8)GetSupportedSimdLevel());
+}
+
+/** Level kernels dispatch on; read once per call, not per sample */
+inline ESimdLevel GetSimdLevel()
+{
+	return (ESimdLevel)SimdLevelPrivate::ActiveLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * Force kernels down to a level (clamped to what the build supports)
+ * Process-wide; change it only while no audio is being rendered
+ */
+inline void SetSimdLevel(ESimdLevel Level)
+{
+	const uint8 Supported = (uint8)GetSupportedSimdLevel();
+	SimdLevelPrivate::ActiveLevel.store((uint8)Level < Supported ? (uint8)Level : Supported, std::memory_order_relaxed);
+}
+
+inline const TCHAR* GetSimdLevelName(ESimdLevel Level)
+{
+	switch (Level)
+	{
+	case ESimdLevel::Scalar: return TEXT("scalar");
+	case ESimdLevel::SSE2:   return TEXT("sse2");
+	default:                 return TEXT("unknown");
+	}
+}
@@ -0,0 +1,652 @@
+#include "SimplexNoise.h"
+#include "SimdLevel.h"
+#include <cmath>
+
+#if SANDBOX_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Skew/unskew factors: (sqrt(N+1)-1)/N and (1-1/sqrt(N+1))/N
+	constexpr float F2 = 0.366025403f;
+	constexpr float G2 = 0.211324865f;
+	constexpr float F3 = 1.0f / 3.0f;
+	constexpr float G3 = 1.0f / 6.0f;
+	constexpr float F4 = 0.309016994f;
+	constexpr float G4 = 0.138196601f;
+
+	// Positions per chunk in the fractal/body helpers (stack buffers)
+	constexpr int32 ChunkSize = 256;
+
+	struct FPermutationTable
+	{
+		int32 Values[512];
+	};
+
+	/** Fisher-Yates with xorshift32 so every platform builds the same table, doubled to avoid index wrapping */
+	constexpr FPermutationTable BuildPermutation(uint32 Seed)
+	{
+		FPermutationTable Table = {};
+		for (int32 i = 0; i < 256; ++i)
+		{
+			Table.Values[i] = i;
+		}
+
+		uint32 State = Seed ? Seed : 0x9E3779B9u;
+		for (int32 i = 255; i > 0; --i)
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			const int32 j = (int32)(State % (uint32)(i + 1));
+			const int32 Temp = Table.Values[i];
+			Table.Values[i] = Table.Values[j];
+			Table.Values[j] = Temp;
+		}
+
+		for (int32 i = 0; i < 256; ++i)
+		{
+			Table.Values[i + 256] = Table.Values[i];
+		}
+		return Table;
+	}
+
+	constexpr FPermutationTable DefaultPermutation = BuildPermutation(FSimplexNoise::DefaultSeed);
+
+	/**
+	 * Gradients are derived from hash bits rather than table lookups so the
+	 * scalar and SIMD paths share one definition. 2D: 8 directions, 3D: the 12
+	 * cube edge midpoints, 4D: the 32 tesseract edge midpoints.
+	 */
+	inline float Grad2(int32 Hash, float X, float Y)
+	{
+		const int32 H = Hash & 7;
+		const float U = H < 4 ? X : Y;
+		const float V = (H < 4 ? Y : X) * 2.0f;
+		return ((H & 1) ? -U : U) + ((H & 2) ? -V : V);
+	}
+
+	inline float Grad3(int32 Hash, float X, float Y, float Z)
+	{
+		const int32 H = Hash & 15;
+		const float U = H < 8 ? X : Y;
+		const float V = H < 4 ? Y : ((H == 12 || H == 14) ? X : Z);
+		return ((H & 1) ? -U : U) + ((H & 2) ? -V : V);
+	}
+
+	inline float Grad4(int32 Hash, float X, float Y, float Z, float W)
+	{
+		const int32 H = Hash & 31;
+		const float U = H < 24 ? X : Y;
+		const float V = H < 16 ? Y : Z;
+		const float R = H < 8 ? Z : W;
+		return ((H & 1) ? -U : U) + ((H & 2) ? -V : V) + ((H & 4) ? -R : R);
+	}
+
+	/** Radial falloff (R - d^2)^4 times the gradient; clamped rather than branched to match the SIMD path */
+	inline float Corner(float T, float Gradient)
+	{
+		T = FMath::Max(T, 0.0f);
+		T *= T;
+		return T * T * Gradient;
+	}
+
+#if SANDBOX_HAS_SSE2
+	inline __m128 VFloor(__m128 V)
+	{
+		const __m128 Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(V));
+		return _mm_sub_ps(Truncated, _mm_and_ps(_mm_cmpgt_ps(Truncated, V), _mm_set1_ps(1.0f)));
+	}
+
+	inline __m128 VSelect(__m128 Mask, __m128 A, __m128 B)
+	{
+		return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+	}
+
+	inline __m128 VLess(__m128i H, int32 Value)
+	{
+		return _mm_castsi128_ps(_mm_cmplt_epi32(H, _mm_set1_epi32(Value)));
+	}
+
+	inline __m128 VEqual(__m128i H, int32 Value)
+	{
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(H, _mm_set1_epi32(Value)));
+	}
+
+	/** Flip the sign of lanes whose hash has Bit set */
+	inline __m128 VNegateIf(__m128i H, int32 Bit, __m128 V)
+	{
+		const __m128i Mask = _mm_cmpeq_epi32(_mm_and_si128(H, _mm_set1_epi32(Bit)), _mm_set1_epi32(Bit));
+		return _mm_xor_ps(V, _mm_castsi128_ps(_mm_slli_epi32(Mask, 31)));
+	}
+
+	inline __m128 VGrad2(__m128i Hash, __m128 X, __m128 Y)
+	{
+		const __m128i H = _mm_and_si128(Hash, _mm_set1_epi32(7));
+		const __m128 Lt4 = VLess(H, 4);
+		const __m128 U = VSelect(Lt4, X, Y);
+		const __m128 V = _mm_mul_ps(VSelect(Lt4, Y, X), _mm_set1_ps(2.0f));
+		return _mm_add_ps(VNegateIf(H, 1, U), VNegateIf(H, 2, V));
+	}
+
+	inline __m128 VGrad3(__m128i Hash, __m128 X, __m128 Y, __m128 Z)
+	{
+		const __m128i H = _mm_and_si128(Hash, _mm_set1_epi32(15));
+		const __m128 U = VSelect(VLess(H, 8), X, Y);
+		const __m128 XorZ = VSelect(_mm_or_ps(VEqual(H, 12), VEqual(H, 14)), X, Z);
+		const __m128 V = VSelect(VLess(H, 4), Y, XorZ);
+		return _mm_add_ps(VNegateIf(H, 1, U), VNegateIf(H, 2, V));
+	}
+
+	inline __m128 VGrad4(__m128i Hash, __m128 X, __m128 Y, __m128 Z, __m128 W)
+	{
+		const __m128i H = _mm_and_si128(Hash, _mm_set1_epi32(31));
+		const __m128 U = VSelect(VLess(H, 24), X, Y);
+		const __m128 V = VSelect(VLess(H, 16), Y, Z);
+		const __m128 R = VSelect(VLess(H, 8), Z, W);
+		return _mm_add_ps(_mm_add_ps(VNegateIf(H, 1, U), VNegateIf(H, 2, V)), VNegateIf(H, 4, R));
+	}
+
+	inline __m128 VCorner(__m128 T, __m128 Gradient)
+	{
+		T = _mm_max_ps(T, _mm_setzero_ps());
+		T = _mm_mul_ps(T, T);
+		return _mm_mul_ps(_mm_mul_ps(T, T), Gradient);
+	}
+
+	/** Squared distance subtracted from the falloff radius, in the scalar evaluation order */
+	inline __m128 VFalloff(float Radius, __m128 X, __m128 Y)
+	{
+		return _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(Radius), _mm_mul_ps(X, X)), _mm_mul_ps(Y, Y));
+	}
+
+	inline __m128 VFalloff(float Radius, __m128 X, __m128 Y, __m128 Z)
+	{
+		return _mm_sub_ps(VFalloff(Radius, X, Y), _mm_mul_ps(Z, Z));
+	}
+
+	inline __m128 VFalloff(float Radius, __m128 X, __m128 Y, __m128 Z, __m128 W)
+	{
+		return _mm_sub_ps(VFalloff(Radius, X, Y, Z), _mm_mul_ps(W, W));
+	}
+
+	/** 0/1 offset per lane from a comparison mask */
+	inline __m128i VMaskToInt(__m128i Mask)
+	{
+		return _mm_and_si128(Mask, _mm_set1_epi32(1));
+	}
+
+	/** Lattice cell index wrapped to the permutation table */
+	inline __m128i VCell(__m128 Floored)
+	{
+		return _mm_and_si128(_mm_cvttps_epi32(Floored), _mm_set1_epi32(255));
+	}
+
+	/** How many of A > B, A > C, ... hold; used for the simplex traversal order */
+	inline __m128i VCount(__m128 M0, __m128 M1)
+	{
+		return _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(_mm_castps_si128(M0), _mm_castps_si128(M1)));
+	}
+
+	inline __m128i VCount(__m128 M0, __m128 M1, __m128 M2)
+	{
+		return _mm_sub_epi32(VCount(M0, M1), _mm_castps_si128(M2));
+	}
+#endif
+}
+
+// ============================================================================
+// FSimplexNoise Implementation
+// ============================================================================
+
+FSimplexNoise::FSimplexNoise(uint32 InSeed)
+{
+	SetSeed(InSeed);
+}
+
+void FSimplexNoise::SetSeed(uint32 InSeed)
+{
+	Seed = InSeed;
+
+	if (InSeed == DefaultSeed)
+	{
+		FMemory::Memcpy(Perm, DefaultPermutation.Values, sizeof(Perm));
+	}
+	else
+	{
+		const FPermutationTable Table = BuildPermutation(InSeed);
+		FMemory::Memcpy(Perm, Table.Values, sizeof(Perm));
+	}
+}
+
+float FSimplexNoise::Noise2D(float X, float Y) const
+{
+	const float S = (X + Y) * F2;
+	const float I = std::floor(X + S);
+	const float J = std::floor(Y + S);
+	const float T = (I + J) * G2;
+	const float X0 = X - (I - T);
+	const float Y0 = Y - (J - T);
+
+	const int32 I1 = X0 > Y0 ? 1 : 0;
+	const int32 J1 = 1 - I1;
+
+	const float X1 = X0 - (float)I1 + G2;
+	const float Y1 = Y0 - (float)J1 + G2;
+	const float X2 = X0 - 1.0f + 2.0f * G2;
+	const float Y2 = Y0 - 1.0f + 2.0f * G2;
+
+	const int32 Ii = (int32)I & 255;
+	const int32 Jj = (int32)J & 255;
+
+	const float N0 = Corner(0.5f - X0 * X0 - Y0 * Y0, Grad2(Perm[Ii + Perm[Jj]], X0, Y0));
+	const float N1 = Corner(0.5f - X1 * X1 - Y1 * Y1, Grad2(Perm[Ii + I1 + Perm[Jj + J1]], X1, Y1));
+	const float N2 = Corner(0.5f - X2 * X2 - Y2 * Y2, Grad2(Perm[Ii + 1 + Perm[Jj + 1]], X2, Y2));
+
+	return 40.0f * (N0 + N1 + N2);
+}
+
+float FSimplexNoise::Noise3D(float X, float Y, float Z) const
+{
+	const float S = (X + Y + Z) * F3;
+	const float I = std::floor(X + S);
+	const float J = std::floor(Y + S);
+	const float K = std::floor(Z + S);
+	const float T = (I + J + K) * G3;
+	const float X0 = X - (I - T);
+	const float Y0 = Y - (J - T);
+	const float Z0 = Z - (K - T);
+
+	// Rank the offsets to find which simplex of the cube we are in
+	const int32 RankX = (X0 > Y0) + (X0 > Z0);
+	const int32 RankY = (X0 <= Y0) + (Y0 > Z0);
+	const int32 RankZ = (X0 <= Z0) + (Y0 <= Z0);
+
+	const int32 I1 = RankX >= 2, J1 = RankY >= 2, K1 = RankZ >= 2;
+	const int32 I2 = RankX >= 1, J2 = RankY >= 1, K2 = RankZ >= 1;
+
+	const float X1 = X0 - (float)I1 + G3;
+	const float Y1 = Y0 - (float)J1 + G3;
+	const float Z1 = Z0 - (float)K1 + G3;
+	const float X2 = X0 - (float)I2 + 2.0f * G3;
+	const float Y2 = Y0 - (float)J2 + 2.0f * G3;
+	const float Z2 = Z0 - (float)K2 + 2.0f * G3;
+	const float X3 = X0 - 1.0f + 3.0f * G3;
+	const float Y3 = Y0 - 1.0f + 3.0f * G3;
+	const float Z3 = Z0 - 1.0f + 3.0f * G3;
+
+	const int32 Ii = (int32)I & 255;
+	const int32 Jj = (int32)J & 255;
+	const int32 Kk = (int32)K & 255;
+
+	const int32 H0 = Perm[Ii + Perm[Jj + Perm[Kk]]];
+	const int32 H1 = Perm[Ii + I1 + Perm[Jj + J1 + Perm[Kk + K1]]];
+	const int32 H2 = Perm[Ii + I2 + Perm[Jj + J2 + Perm[Kk + K2]]];
+	const int32 H3 = Perm[Ii + 1 + Perm[Jj + 1 + Perm[Kk + 1]]];
+
+	const float N0 = Corner(0.6f - X0 * X0 - Y0 * Y0 - Z0 * Z0, Grad3(H0, X0, Y0, Z0));
+	const float N1 = Corner(0.6f - X1 * X1 - Y1 * Y1 - Z1 * Z1, Grad3(H1, X1, Y1, Z1));
+	const float N2 = Corner(0.6f - X2 * X2 - Y2 * Y2 - Z2 * Z2, Grad3(H2, X2, Y2, Z2));
+	const float N3 = Corner(0.6f - X3 * X3 - Y3 * Y3 - Z3 * Z3, Grad3(H3, X3, Y3, Z3));
+
+	return 32.0f * (N0 + N1 + N2 + N3);
+}
+
+float FSimplexNoise::Noise4D(float X, float Y, float Z, float W) const
+{
+	const float S = (X + Y + Z + W) * F4;
+	const float I = std::floor(X + S);
+	const float J = std::floor(Y + S);
+	const float K = std::floor(Z + S);
+	const float L = std::floor(W + S);
+	const float T = (I + J + K + L) * G4;
+	const float X0 = X - (I - T);
+	const float Y0 = Y - (J - T);
+	const float Z0 = Z - (K - T);
+	const float W0 = W - (L - T);
+
+	const int32 RankX = (X0 > Y0) + (X0 > Z0) + (X0 > W0);
+	const int32 RankY = (X0 <= Y0) + (Y0 > Z0) + (Y0 > W0);
+	const int32 RankZ = (X0 <= Z0) + (Y0 <= Z0) + (Z0 > W0);
+	const int32 RankW = (X0 <= W0) + (Y0 <= W0) + (Z0 <= W0);
+
+	const int32 I1 = RankX >= 3, J1 = RankY >= 3, K1 = RankZ >= 3, L1 = RankW >= 3;
+	const int32 I2 = RankX >= 2, J2 = RankY >= 2, K2 = RankZ >= 2, L2 = RankW >= 2;
+	const int32 I3 = RankX >= 1, J3 = RankY >= 1, K3 = RankZ >= 1, L3 = RankW >= 1;
+
+	const float X1 = X0 - (float)I1 + G4;
+	const float Y1 = Y0 - (float)J1 + G4;
+	const float Z1 = Z0 - (float)K1 + G4;
+	const float W1 = W0 - (float)L1 + G4;
+	const float X2 = X0 - (float)I2 + 2.0f * G4;
+	const float Y2 = Y0 - (float)J2 + 2.0f * G4;
+	const float Z2 = Z0 - (float)K2 + 2.0f * G4;
+	const float W2 = W0 - (float)L2 + 2.0f * G4;
+	const float X3 = X0 - (float)I3 + 3.0f * G4;
+	const float Y3 = Y0 - (float)J3 + 3.0f * G4;
+	const float Z3 = Z0 - (float)K3 + 3.0f * G4;
+	const float W3 = W0 - (float)L3 + 3.0f * G4;
+	const float X4 = X0 - 1.0f + 4.0f * G4;
+	const float Y4 = Y0 - 1.0f + 4.0f * G4;
+	const float Z4 = Z0 - 1.0f + 4.0f * G4;
+	const float W4 = W0 - 1.0f + 4.0f * G4;
+
+	const int32 Ii = (int32)I & 255;
+	const int32 Jj = (int32)J & 255;
+	const int32 Kk = (int32)K & 255;
+	const int32 Ll = (int32)L & 255;
+
+	const int32 H0 = Perm[Ii + Perm[Jj + Perm[Kk + Perm[Ll]]]];
+	const int32 H1 = Perm[Ii + I1 + Perm[Jj + J1 + Perm[Kk + K1 + Perm[Ll + L1]]]];
+	const int32 H2 = Perm[Ii + I2 + Perm[Jj + J2 + Perm[Kk + K2 + Perm[Ll + L2]]]];
+	const int32 H3 = Perm[Ii + I3 + Perm[Jj + J3 + Perm[Kk + K3 + Perm[Ll + L3]]]];
+	const int32 H4 = Perm[Ii + 1 + Perm[Jj + 1 + Perm[Kk + 1 + Perm[Ll + 1]]]];
+
+	const float N0 = Corner(0.6f - X0 * X0 - Y0 * Y0 - Z0 * Z0 - W0 * W0, Grad4(H0, X0, Y0, Z0, W0));
+	const float N1 = Corner(0.6f - X1 * X1 - Y1 * Y1 - Z1 * Z1 - W1 * W1, Grad4(H1, X1, Y1, Z1, W1));
+	const float N2 = Corner(0.6f - X2 * X2 - Y2 * Y2 - Z2 * Z2 - W2 * W2, Grad4(H2, X2, Y2, Z2, W2));
+	const float N3 = Corner(0.6f - X3 * X3 - Y3 * Y3 - Z3 * Z3 - W3 * W3, Grad4(H3, X3, Y3, Z3, W3));
+	const float N4 = Corner(0.6f - X4 * X4 - Y4 * Y4 - Z4 * Z4 - W4 * W4, Grad4(H4, X4, Y4, Z4, W4));
+
+	return 27.0f * (N0 + N1 + N2 + N3 + N4);
+}
+
+void FSimplexNoise::Evaluate2D(const float* X, const float* Y, float* Out, int32 Count) const
+{
+	int32 Index = 0;
+
+#if SANDBOX_HAS_SSE2
+	alignas(16) int32 Ii[4], Jj[4], I1[4], J1[4];
+	alignas(16) int32 H0[4], H1[4], H2[4];
+
+	const int32 VectorCount = GetSimdLevel() >= ESimdLevel::SSE2 ? Count : 0;
+	for (; Index + 4 <= VectorCount; Index += 4)
+	{
+		const __m128 VX = _mm_loadu_ps(X + Index);
+		const __m128 VY = _mm_loadu_ps(Y + Index);
+
+		const __m128 S = _mm_mul_ps(_mm_add_ps(VX, VY), _mm_set1_ps(F2));
+		const __m128 I = VFloor(_mm_add_ps(VX, S));
+		const __m128 J = VFloor(_mm_add_ps(VY, S));
+		const __m128 T = _mm_mul_ps(_mm_add_ps(I, J), _mm_set1_ps(G2));
+		const __m128 X0 = _mm_sub_ps(VX, _mm_sub_ps(I, T));
+		const __m128 Y0 = _mm_sub_ps(VY, _mm_sub_ps(J, T));
+
+		const __m128i VI1 = VMaskToInt(_mm_castps_si128(_mm_cmpgt_ps(X0, Y0)));
+		const __m128i VJ1 = _mm_sub_epi32(_mm_set1_epi32(1), VI1);
+
+		const __m128 X1 = _mm_add_ps(_mm_sub_ps(X0, _mm_cvtepi32_ps(VI1)), _mm_set1_ps(G2));
+		const __m128 Y1 = _mm_add_ps(_mm_sub_ps(Y0, _mm_cvtepi32_ps(VJ1)), _mm_set1_ps(G2));
+		const __m128 X2 = _mm_add_ps(_mm_sub_ps(X0, _mm_set1_ps(1.0f)), _mm_set1_ps(2.0f * G2));
+		const __m128 Y2 = _mm_add_ps(_mm_sub_ps(Y0, _mm_set1_ps(1.0f)), _mm_set1_ps(2.0f * G2));
+
+		_mm_store_si128((__m128i*)Ii, VCell(I));
+		_mm_store_si128((__m128i*)Jj, VCell(J));
+		_mm_store_si128((__m128i*)I1, VI1);
+		_mm_store_si128((__m128i*)J1, VJ1);
+
+		// SSE2 has no gather; the permutation chain is resolved per lane
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			H0[Lane] = Perm[Ii[Lane] + Perm[Jj[Lane]]];
+			H1[Lane] = Perm[Ii[Lane] + I1[Lane] + Perm[Jj[Lane] + J1[Lane]]];
+			H2[Lane] = Perm[Ii[Lane] + 1 + Perm[Jj[Lane] + 1]];
+		}
+
+		const __m128 N0 = VCorner(VFalloff(0.5f, X0, Y0), VGrad2(_mm_load_si128((const __m128i*)H0), X0, Y0));
+		const __m128 N1 = VCorner(VFalloff(0.5f, X1, Y1), VGrad2(_mm_load_si128((const __m128i*)H1), X1, Y1));
+		const __m128 N2 = VCorner(VFalloff(0.5f, X2, Y2), VGrad2(_mm_load_si128((const __m128i*)H2), X2, Y2));
+
+		_mm_storeu_ps(Out + Index, _mm_mul_ps(_mm_set1_ps(40.0f), _mm_add_ps(_mm_add_ps(N0, N1), N2)));
+	}
+#endif
+
+	for (; Index < Count; ++Index)
+	{
+		Out[Index] = Noise2D(X[Index], Y[Index]);
+	}
+}
+
+void FSimplexNoise::Evaluate3D(const float* X, const float* Y, const float* Z, float* Out, int32 Count) const
+{
+	int32 Index = 0;
+
+#if SANDBOX_HAS_SSE2
+	alignas(16) int32 Ii[4], Jj[4], Kk[4];
+	alignas(16) int32 I1[4], J1[4], K1[4], I2[4], J2[4], K2[4];
+	alignas(16) int32 H0[4], H1[4], H2[4], H3[4];
+
+	const int32 VectorCount = GetSimdLevel() >= ESimdLevel::SSE2 ? Count : 0;
+	for (; Index + 4 <= VectorCount; Index += 4)
+	{
+		const __m128 VX = _mm_loadu_ps(X + Index);
+		const __m128 VY = _mm_loadu_ps(Y + Index);
+		const __m128 VZ = _mm_loadu_ps(Z + Index);
+
+		const __m128 S = _mm_mul_ps(_mm_add_ps(_mm_add_ps(VX, VY), VZ), _mm_set1_ps(F3));
+		const __m128 I = VFloor(_mm_add_ps(VX, S));
+		const __m128 J = VFloor(_mm_add_ps(VY, S));
+		const __m128 K = VFloor(_mm_add_ps(VZ, S));
+		const __m128 T = _mm_mul_ps(_mm_add_ps(_mm_add_ps(I, J), K), _mm_set1_ps(G3));
+		const __m128 X0 = _mm_sub_ps(VX, _mm_sub_ps(I, T));
+		const __m128 Y0 = _mm_sub_ps(VY, _mm_sub_ps(J, T));
+		const __m128 Z0 = _mm_sub_ps(VZ, _mm_sub_ps(K, T));
+
+		const __m128i RankX = VCount(_mm_cmpgt_ps(X0, Y0), _mm_cmpgt_ps(X0, Z0));
+		const __m128i RankY = VCount(_mm_cmple_ps(X0, Y0), _mm_cmpgt_ps(Y0, Z0));
+		const __m128i RankZ = VCount(_mm_cmple_ps(X0, Z0), _mm_cmple_ps(Y0, Z0));
+
+		const __m128i One = _mm_set1_epi32(1);
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i VI1 = VMaskToInt(_mm_cmpgt_epi32(RankX, One));
+		const __m128i VJ1 = VMaskToInt(_mm_cmpgt_epi32(RankY, One));
+		const __m128i VK1 = VMaskToInt(_mm_cmpgt_epi32(RankZ, One));
+		const __m128i VI2 = VMaskToInt(_mm_cmpgt_epi32(RankX, Zero));
+		const __m128i VJ2 = VMaskToInt(_mm_cmpgt_epi32(RankY, Zero));
+		const __m128i VK2 = VMaskToInt(_mm_cmpgt_epi32(RankZ, Zero));
+
+		const __m128 X1 = _mm_add_ps(_mm_sub_ps(X0, _mm_cvtepi32_ps(VI1)), _mm_set1_ps(G3));
+		const __m128 Y1 = _mm_add_ps(_mm_sub_ps(Y0, _mm_cvtepi32_ps(VJ1)), _mm_set1_ps(G3));
+		const __m128 Z1 = _mm_add_ps(_mm_sub_ps(Z0, _mm_cvtepi32_ps(VK1)), _mm_set1_ps(G3));
+		const __m128 X2 = _mm_add_ps(_mm_sub_ps(X0, _mm_cvtepi32_ps(VI2)), _mm_set1_ps(2.0f * G3));
+		const __m128 Y2 = _mm_add_ps(_mm_sub_ps(Y0, _mm_cvtepi32_ps(VJ2)), _mm_set1_ps(2.0f * G3));
+		const __m128 Z2 = _mm_add_ps(_mm_sub_ps(Z0, _mm_cvtepi32_ps(VK2)), _mm_set1_ps(2.0f * G3));
+		const __m128 X3 = _mm_add_ps(_mm_sub_ps(X0, _mm_set1_ps(1.0f)), _mm_set1_ps(3.0f * G3));
+		const __m128 Y3 = _mm_add_ps(_mm_sub_ps(Y0, _mm_set1_ps(1.0f)), _mm_set1_ps(3.0f * G3));
+		const __m128 Z3 = _mm_add_ps(_mm_sub_ps(Z0, _mm_set1_ps(1.0f)), _mm_set1_ps(3.0f * G3));
+
+		_mm_store_si128((__m128i*)Ii, VCell(I));
+		_mm_store_si128((__m128i*)Jj, VCell(J));
+		_mm_store_si128((__m128i*)Kk, VCell(K));
+		_mm_store_si128((__m128i*)I1, VI1);
+		_mm_store_si128((__m128i*)J1, VJ1);
+		_mm_store_si128((__m128i*)K1, VK1);
+		_mm_store_si128((__m128i*)I2, VI2);
+		_mm_store_si128((__m128i*)J2, VJ2);
+		_mm_store_si128((__m128i*)K2, VK2);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			H0[Lane] = Perm[Ii[Lane] + Perm[Jj[Lane] + Perm[Kk[Lane]]]];
+			H1[Lane] = Perm[Ii[Lane] + I1[Lane] + Perm[Jj[Lane] + J1[Lane] + Perm[Kk[Lane] + K1[Lane]]]];
+			H2[Lane] = Perm[Ii[Lane] + I2[Lane] + Perm[Jj[Lane] + J2[Lane] + Perm[Kk[Lane] + K2[Lane]]]];
+			H3[Lane] = Perm[Ii[Lane] + 1 + Perm[Jj[Lane] + 1 + Perm[Kk[Lane] + 1]]];
+		}
+
+		const __m128 N0 = VCorner(VFalloff(0.6f, X0, Y0, Z0), VGrad3(_mm_load_si128((const __m128i*)H0), X0, Y0, Z0));
+		const __m128 N1 = VCorner(VFalloff(0.6f, X1, Y1, Z1), VGrad3(_mm_load_si128((const __m128i*)H1), X1, Y1, Z1));
+		const __m128 N2 = VCorner(VFalloff(0.6f, X2, Y2, Z2), VGrad3(_mm_load_si128((const __m128i*)H2), X2, Y2, Z2));
+		const __m128 N3 = VCorner(VFalloff(0.6f, X3, Y3, Z3), VGrad3(_mm_load_si128((const __m128i*)H3), X3, Y3, Z3));
+
+		const __m128 Sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(N0, N1), N2), N3);
+		_mm_storeu_ps(Out + Index, _mm_mul_ps(_mm_set1_ps(32.0f), Sum));
+	}
+#endif
+
+	for (; Index < Count; ++Index)
+	{
+		Out[Index] = Noise3D(X[Index], Y[Index], Z[Index]);
+	}
+}
+
+void FSimplexNoise::Evaluate4D(const float* X, const float* Y, const float* Z, const float* W, float* Out, int32 Count) const
+{
+	int32 Index = 0;
+
+#if SANDBOX_HAS_SSE2
+	alignas(16) int32 Cell[4][4];        // [Axis][Lane]
+	alignas(16) int32 Offset[3][4][4];   // [Corner][Axis][Lane]
+	alignas(16) int32 Hash[5][4];        // [Corner][Lane]
+
+	const int32 VectorCount = GetSimdLevel() >= ESimdLevel::SSE2 ? Count : 0;
+	for (; Index + 4 <= VectorCount; Index += 4)
+	{
+		const __m128 VX = _mm_loadu_ps(X + Index);
+		const __m128 VY = _mm_loadu_ps(Y + Index);
+		const __m128 VZ = _mm_loadu_ps(Z + Index);
+		const __m128 VW = _mm_loadu_ps(W + Index);
+
+		const __m128 S = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(VX, VY), VZ), VW), _mm_set1_ps(F4));
+		const __m128 I = VFloor(_mm_add_ps(VX, S));
+		const __m128 J = VFloor(_mm_add_ps(VY, S));
+		const __m128 K = VFloor(_mm_add_ps(VZ, S));
+		const __m128 L = VFloor(_mm_add_ps(VW, S));
+		const __m128 T = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(I, J), K), L), _mm_set1_ps(G4));
+		const __m128 P0[4] = {
+			_mm_sub_ps(VX, _mm_sub_ps(I, T)),
+			_mm_sub_ps(VY, _mm_sub_ps(J, T)),
+			_mm_sub_ps(VZ, _mm_sub_ps(K, T)),
+			_mm_sub_ps(VW, _mm_sub_ps(L, T))
+		};
+
+		const __m128i Rank[4] = {
+			VCount(_mm_cmpgt_ps(P0[0], P0[1]), _mm_cmpgt_ps(P0[0], P0[2]), _mm_cmpgt_ps(P0[0], P0[3])),
+			VCount(_mm_cmple_ps(P0[0], P0[1]), _mm_cmpgt_ps(P0[1], P0[2]), _mm_cmpgt_ps(P0[1], P0[3])),
+			VCount(_mm_cmple_ps(P0[0], P0[2]), _mm_cmple_ps(P0[1], P0[2]), _mm_cmpgt_ps(P0[2], P0[3])),
+			VCount(_mm_cmple_ps(P0[0], P0[3]), _mm_cmple_ps(P0[1], P0[3]), _mm_cmple_ps(P0[2], P0[3]))
+		};
+
+		_mm_store_si128((__m128i*)Cell[0], VCell(I));
+		_mm_store_si128((__m128i*)Cell[1], VCell(J));
+		_mm_store_si128((__m128i*)Cell[2], VCell(K));
+		_mm_store_si128((__m128i*)Cell[3], VCell(L));
+
+		// Corner c (1-3) steps along every axis ranked at least 3 - c + 1
+		__m128 P[5][4];
+		for (int32 Axis = 0; Axis < 4; ++Axis)
+		{
+			P[0][Axis] = P0[Axis];
+			for (int32 Corner = 1; Corner <= 3; ++Corner)
+			{
+				const __m128i Step = VMaskToInt(_mm_cmpgt_epi32(Rank[Axis], _mm_set1_epi32(3 - Corner)));
+				_mm_store_si128((__m128i*)Offset[Corner - 1][Axis], Step);
+				P[Corner][Axis] = _mm_add_ps(_mm_sub_ps(P0[Axis], _mm_cvtepi32_ps(Step)), _mm_set1_ps((float)Corner * G4));
+			}
+			P[4][Axis] = _mm_add_ps(_mm_sub_ps(P0[Axis], _mm_set1_ps(1.0f)), _mm_set1_ps(4.0f * G4));
+		}
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const int32 Ii = Cell[0][Lane], Jj = Cell[1][Lane], Kk = Cell[2][Lane], Ll = Cell[3][Lane];
+			Hash[0][Lane] = Perm[Ii + Perm[Jj + Perm[Kk + Perm[Ll]]]];
+			for (int32 Corner = 1; Corner <= 3; ++Corner)
+			{
+				const int32 (&O)[4][4] = Offset[Corner - 1];
+				Hash[Corner][Lane] = Perm[Ii + O[0][Lane] + Perm[Jj + O[1][Lane] + Perm[Kk + O[2][Lane] + Perm[Ll + O[3][Lane]]]]];
+			}
+			Hash[4][Lane] = Perm[Ii + 1 + Perm[Jj + 1 + Perm[Kk + 1 + Perm[Ll + 1]]]];
+		}
+
+		__m128 Sum = _mm_setzero_ps();
+		for (int32 Corner = 0; Corner < 5; ++Corner)
+		{
+			const __m128 N = VCorner(
+				VFalloff(0.6f, P[Corner][0], P[Corner][1], P[Corner][2], P[Corner][3]),
+				VGrad4(_mm_load_si128((const __m128i*)Hash[Corner]), P[Corner][0], P[Corner][1], P[Corner][2], P[Corner][3]));
+			Sum = Corner == 0 ? N : _mm_add_ps(Sum, N);
+		}
+		_mm_storeu_ps(Out + Index, _mm_mul_ps(_mm_set1_ps(27.0f), Sum));
+	}
+#endif
+
+	for (; Index < Count; ++Index)
+	{
+		Out[Index] = Noise4D(X[Index], Y[Index], Z[Index], W[Index]);
+	}
+}
+
+void FSimplexNoise::EvaluateFractal(const FVector3* Positions, int32 Count, float W, const FSimplexFractalParams& Params, float* Out) const
+{
+	alignas(16) float X[ChunkSize], Y[ChunkSize], Z[ChunkSize], WW[ChunkSize], Octave[ChunkSize];
+
+	const int32 NumOctaves = FMath::Max(Params.Octaves, 1);
+	float AmplitudeSum = 0.0f;
+	for (int32 o = 0; o < NumOctaves; ++o)
+	{
+		AmplitudeSum += std::pow(Params.Persistence, (float)o);
+	}
+	const float Normalise = AmplitudeSum > 0.0f ? 1.0f / AmplitudeSum : 1.0f;
+
+	for (int32 Start = 0; Start < Count; Start += ChunkSize)
+	{
+		const int32 Num = FMath::Min(ChunkSize, Count - Start);
+		float* Dest = Out + Start;
+		FMemory::Memzero(Dest, sizeof(float) * Num);
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			WW[i] = W;
+		}
+
+		float Frequency = Params.Frequency;
+		float Amplitude = 1.0f;
+		for (int32 o = 0; o < NumOctaves; ++o)
+		{
+			for (int32 i = 0; i < Num; ++i)
+			{
+				const FVector3& P = Positions[Start + i];
+				X[i] = P.X * Frequency;
+				Y[i] = P.Y * Frequency;
+				Z[i] = P.Z * Frequency;
+			}
+
+			Evaluate4D(X, Y, Z, WW, Octave, Num);
+
+			for (int32 i = 0; i < Num; ++i)
+			{
+				Dest[i] += Octave[i] * Amplitude;
+			}
+
+			Frequency *= Params.Lacunarity;
+			Amplitude *= Params.Persistence;
+		}
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Dest[i] *= Normalise;
+		}
+	}
+}
+
+void FSimplexNoise::EvaluateFractal(const TArray<FVector3>& Positions, float W, const FSimplexFractalParams& Params, TArray<float>& Out) const
+{
+	Out.SetNum(Positions.Num());
+	EvaluateFractal(Positions.GetData(), Positions.Num(), W, Params, Out.GetData());
+}
+
+void FSimplexNoise::EvaluateAtBodies(const FPhysicsObjectArray& Bodies, float W, const FSimplexFractalParams& Params, TArray<float>& Out) const
+{
+	FVector3 Positions[ChunkSize];
+
+	Out.SetNum(Bodies.Num());
+	for (int32 Start = 0; Start < Bodies.Num(); Start += ChunkSize)
+	{
+		const int32 Num = FMath::Min(ChunkSize, Bodies.Num() - Start);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Positions[i] = Bodies[Start + i]->GetPosition();
+		}
+		EvaluateFractal(Positions, Num, W, Params, Out.GetData() + Start);
+	}
+}
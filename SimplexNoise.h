@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Physics/PhysicsCore.h"
+
+/**
+ * Octave settings for fractal (fBm) noise
+ */
+struct FSimplexFractalParams
+{
+	float Frequency;    // Spatial frequency of the first octave (cycles per metre)
+	int32 Octaves;
+	float Lacunarity;   // Frequency multiplier per octave
+	float Persistence;  // Amplitude multiplier per octave
+
+	FSimplexFractalParams(float InFrequency = 1.0f, int32 InOctaves = 1, float InLacunarity = 2.0f, float InPersistence = 0.5f)
+		: Frequency(InFrequency), Octaves(InOctaves), Lacunarity(InLacunarity), Persistence(InPersistence) {}
+};
+
+/**
+ * Seeded 2D/3D/4D simplex noise for spatially varying parameters
+ * (wind fields, material variation, ambient texture) sampled at body positions
+ *
+ * Output is in [-1, 1]. The batched functions take structure-of-arrays input
+ * and evaluate four positions per SSE2 instruction where available; they
+ * return exactly the same values as the scalar functions.
+ */
+class FSimplexNoise
+{
+public:
+	/** Seed whose permutation is generated at compile time */
+	static constexpr uint32 DefaultSeed = 12345;
+
+	FSimplexNoise(uint32 InSeed = DefaultSeed);
+
+	void SetSeed(uint32 InSeed);
+	uint32 GetSeed() const { return Seed; }
+
+	// Single-point evaluation
+	float Noise2D(float X, float Y) const;
+	float Noise3D(float X, float Y, float Z) const;
+	float Noise4D(float X, float Y, float Z, float W) const;
+
+	// Batched evaluation over Count positions (SoA)
+	void Evaluate2D(const float* X, const float* Y, float* Out, int32 Count) const;
+	void Evaluate3D(const float* X, const float* Y, const float* Z, float* Out, int32 Count) const;
+	void Evaluate4D(const float* X, const float* Y, const float* Z, const float* W, float* Out, int32 Count) const;
+
+	/**
+	 * Fractal noise over positions with W as a fourth (usually time) coordinate
+	 * Normalised back to [-1, 1] regardless of octave count
+	 * @param W Fourth coordinate shared by all positions; it is not scaled by Frequency
+	 */
+	void EvaluateFractal(const FVector3* Positions, int32 Count, float W, const FSimplexFractalParams& Params, float* Out) const;
+	void EvaluateFractal(const TArray<FVector3>& Positions, float W, const FSimplexFractalParams& Params, TArray<float>& Out) const;
+
+	/** Fractal noise sampled at each body's position */
+	void EvaluateAtBodies(const FPhysicsObjectArray& Bodies, float W, const FSimplexFractalParams& Params, TArray<float>& Out) const;
+
+private:
+	uint32 Seed;
+	int32 Perm[512];  // Permutation doubled to avoid index wrapping
+};
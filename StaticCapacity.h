@@ -0,0 +1,294 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <algorithm>
+#include <new>
+#include <utility>
+
+/**
+ * Static-capacity build profile
+ *
+ * Build with SANDBOX_STATIC_CAPACITY=1 (CMake option of the same name) for
+ * deployments that must never touch the heap while rendering. The limits
+ * below become compile-time capacities of the engine's bounded containers,
+ * which then keep their elements inline, and FSandboxManager::SealAllocations
+ * ends initialization by creating every body and generator the scene can
+ * spawn. In the default profile the same containers are heap arrays and the
+ * limits only size the spawn pools.
+ */
+#ifndef SANDBOX_STATIC_CAPACITY
+#define SANDBOX_STATIC_CAPACITY 0
+#endif
+
+#ifndef SANDBOX_MAX_BODIES
+#define SANDBOX_MAX_BODIES 64
+#endif
+
+#ifndef SANDBOX_MAX_VOICES
+#define SANDBOX_MAX_VOICES 16
+#endif
+
+#ifndef SANDBOX_MAX_SOURCES
+#define SANDBOX_MAX_SOURCES 16
+#endif
+
+#ifndef SANDBOX_MAX_EVENTS
+#define SANDBOX_MAX_EVENTS 256
+#endif
+
+#ifndef SANDBOX_MAX_GENERATORS
+#define SANDBOX_MAX_GENERATORS 16
+#endif
+
+/**
+ * Compile-time limits of a build
+ * Bodies are physics objects, voices synthesizer voices, sources mixer inputs,
+ * events the timeline, rhythm and impact events held at once, and generators
+ * procedural generators and rhythm patterns
+ */
+template <int32 InMaxBodies, int32 InMaxVoices, int32 InMaxSources, int32 InMaxEvents, int32 InMaxGenerators>
+struct TSandboxCapacity
+{
+	static_assert(InMaxBodies > 0 && InMaxVoices > 0 && InMaxSources > 0 && InMaxEvents > 0 && InMaxGenerators > 0,
+		"Sandbox capacities must be positive");
+
+	static constexpr int32 MaxBodies = InMaxBodies;
+	static constexpr int32 MaxVoices = InMaxVoices;
+	static constexpr int32 MaxSources = InMaxSources;
+	static constexpr int32 MaxEvents = InMaxEvents;
+	static constexpr int32 MaxGenerators = InMaxGenerators;
+};
+
+using FSandboxCapacity = TSandboxCapacity<SANDBOX_MAX_BODIES, SANDBOX_MAX_VOICES, SANDBOX_MAX_SOURCES,
+	SANDBOX_MAX_EVENTS, SANDBOX_MAX_GENERATORS>;
+
+/** Most elements a bounded container of this capacity accepts; unlimited outside the static profile */
+constexpr int32 GetSandboxArrayLimit(int32 Capacity)
+{
+	return SANDBOX_STATIC_CAPACITY ? Capacity : MAX_int32;
+}
+
+/**
+ * Array with inline storage for up to Capacity elements
+ *
+ * Supports the TArray calls the engine's bounded containers make. Adding to a
+ * full array does nothing and returns INDEX_NONE, and SetNum clamps to the
+ * capacity, so code that already respects a Max limit works unchanged.
+ */
+template <typename T, int32 Capacity>
+class TFixedArray
+{
+	static_assert(Capacity > 0, "TFixedArray needs a positive capacity");
+
+public:
+	TFixedArray() : Count(0) {}
+	TFixedArray(const TFixedArray& Other) : Count(0) { Append(Other); }
+	TFixedArray(TFixedArray&& Other) : Count(0) { MoveFrom(Other); }
+	~TFixedArray() { Reset(); }
+
+	TFixedArray& operator=(const TFixedArray& Other)
+	{
+		if (this != &Other)
+		{
+			Reset();
+			Append(Other);
+		}
+		return *this;
+	}
+
+	TFixedArray& operator=(TFixedArray&& Other)
+	{
+		if (this != &Other)
+		{
+			Reset();
+			MoveFrom(Other);
+		}
+		return *this;
+	}
+
+	int32 Num() const { return Count; }
+	int32 Max() const { return Capacity; }
+	bool IsEmpty() const { return Count == 0; }
+	bool IsFull() const { return Count == Capacity; }
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < Count; }
+
+	T* GetData() { return reinterpret_cast<T*>(Storage); }
+	const T* GetData() const { return reinterpret_cast<const T*>(Storage); }
+
+	T& operator[](int32 Index) { return GetData()[Index]; }
+	const T& operator[](int32 Index) const { return GetData()[Index]; }
+	T& Last() { return GetData()[Count - 1]; }
+	const T& Last() const { return GetData()[Count - 1]; }
+
+	T* begin() { return GetData(); }
+	T* end() { return GetData() + Count; }
+	const T* begin() const { return GetData(); }
+	const T* end() const { return GetData() + Count; }
+
+	/** @return Index of the new element, or INDEX_NONE if the array is full */
+	int32 Add(const T& Item) { return Emplace(Item); }
+	int32 Add(T&& Item) { return Emplace(MoveTemp(Item)); }
+
+	template <typename... ArgTypes>
+	int32 Emplace(ArgTypes&&... Args)
+	{
+		if (Count >= Capacity)
+		{
+			return INDEX_NONE;
+		}
+		new (GetData() + Count) T(std::forward<ArgTypes>(Args)...);
+		return Count++;
+	}
+
+	/** Insert before Index; dropped if the array is full */
+	void Insert(const T& Item, int32 Index)
+	{
+		if (Count >= Capacity)
+		{
+			return;
+		}
+		if (Index >= Count)
+		{
+			Emplace(Item);
+			return;
+		}
+		T* Data = GetData();
+		new (Data + Count) T(MoveTemp(Data[Count - 1]));
+		for (int32 i = Count - 1; i > Index; --i)
+		{
+			Data[i] = MoveTemp(Data[i - 1]);
+		}
+		Data[Index] = Item;
+		++Count;
+	}
+
+	/** bAllowShrinking is accepted for TArray compatibility; inline storage never shrinks */
+	void RemoveAt(int32 Index, int32 NumToRemove = 1, bool bAllowShrinking = true)
+	{
+		(void)bAllowShrinking;
+		T* Data = GetData();
+		for (int32 i = Index; i + NumToRemove < Count; ++i)
+		{
+			Data[i] = MoveTemp(Data[i + NumToRemove]);
+		}
+		DestroyFrom(Count - NumToRemove);
+	}
+
+	void RemoveAtSwap(int32 Index)
+	{
+		T* Data = GetData();
+		if (Index != Count - 1)
+		{
+			Data[Index] = MoveTemp(Data[Count - 1]);
+		}
+		DestroyFrom(Count - 1);
+	}
+
+	/** Remove every element equal to Item, keeping the order of the rest */
+	int32 Remove(const T& Item)
+	{
+		T* Data = GetData();
+		int32 Kept = 0;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (!(Data[i] == Item))
+			{
+				if (Kept != i)
+				{
+					Data[Kept] = MoveTemp(Data[i]);
+				}
+				++Kept;
+			}
+		}
+		const int32 Removed = Count - Kept;
+		DestroyFrom(Kept);
+		return Removed;
+	}
+
+	int32 Find(const T& Item) const
+	{
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (GetData()[i] == Item)
+			{
+				return i;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	bool Contains(const T& Item) const { return Find(Item) != INDEX_NONE; }
+
+	/** Remove and return the last element; the array must not be empty */
+	T Pop(bool bAllowShrinking = true)
+	{
+		(void)bAllowShrinking;
+		T Item(MoveTemp(Last()));
+		DestroyFrom(Count - 1);
+		return Item;
+	}
+
+	/** Grow with default-constructed elements or shrink; clamped to the capacity */
+	void SetNum(int32 NewNum)
+	{
+		NewNum = FMath::Clamp(NewNum, 0, Capacity);
+		while (Count < NewNum)
+		{
+			Emplace();
+		}
+		DestroyFrom(NewNum);
+	}
+
+	void Append(const TFixedArray& Other)
+	{
+		for (const T& Item : Other)
+		{
+			Emplace(Item);
+		}
+	}
+
+	template <typename PredicateType>
+	void Sort(PredicateType Predicate) { std::sort(begin(), end(), Predicate); }
+
+	void Reset(int32 Slack = 0) { (void)Slack; DestroyFrom(0); }
+	void Empty(int32 Slack = 0) { Reset(Slack); }
+	void Clear() { Reset(); }
+	void Reserve(int32 NumElements) { (void)NumElements; }
+
+	/** Heap bytes owned; the inline storage is part of the owning object */
+	int64 GetAllocatedSize() const { return 0; }
+
+private:
+	alignas(T) uint8 Storage[Capacity * sizeof(T)];
+	int32 Count;
+
+	void DestroyFrom(int32 First)
+	{
+		for (int32 i = First; i < Count; ++i)
+		{
+			GetData()[i].~T();
+		}
+		Count = FMath::Min(Count, First);
+	}
+
+	void MoveFrom(TFixedArray& Other)
+	{
+		for (T& Item : Other)
+		{
+			Emplace(MoveTemp(Item));
+		}
+		Other.Reset();
+	}
+};
+
+/**
+ * Container bounded by one of the FSandboxCapacity limits
+ * Inline TFixedArray storage in the static profile, TArray otherwise
+ */
+#if SANDBOX_STATIC_CAPACITY
+template <typename T, int32 Capacity>
+using TSandboxArray = TFixedArray<T, Capacity>;
+#else
+template <typename T, int32 Capacity>
+using TSandboxArray = TArray<T>;
+#endif
@@ -0,0 +1,142 @@
+#include "StressScene.h"
+#include "Procedural/ExpressionGenerator.h"
+
+namespace
+{
+	/** xorshift32; the scene must not depend on the platform's rand() */
+	struct FStressRandom
+	{
+		uint32 State;
+
+		explicit FStressRandom(uint32 Seed) : State(Seed != 0 ? Seed : 0x9E3779B9u) {}
+
+		uint32 Next()
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			return State;
+		}
+
+		float Range(float Min, float Max)
+		{
+			return Min + (Max - Min) * ((Next() >> 8) / 16777216.0f);
+		}
+	};
+
+	struct FStressMaterial
+	{
+		float Radius;
+		float Mass;
+		float Damping;
+	};
+
+	/**
+	 * Keeps every stress voice sounding: each one is retriggered when it
+	 * falls silent, checked every 1024 frames
+	 */
+	FSceneScript RetriggerVoices(FSceneScriptRunner& Runner, TArray<TSharedPtr<FImpactSynthesizer>> Voices, uint32 Seed)
+	{
+		FStressRandom Random(Seed);
+		while (Runner.GetCurrentFrame() >= 0)
+		{
+			for (const TSharedPtr<FImpactSynthesizer>& Voice : Voices)
+			{
+				if (!Voice->IsPlaying())
+				{
+					Voice->TriggerImpact(Random.Range(80.0f, 4000.0f), Random.Range(0.2f, 1.0f) / Voices.Num(), Random.Range(0.05f, 0.5f));
+				}
+			}
+			co_await Frames(1024);
+		}
+	}
+}
+
+// ============================================================================
+// FStressSceneGenerator Implementation
+// ============================================================================
+
+void FStressSceneGenerator::Build(FSandboxManager& Sandbox, const FStressSceneConfig& Config)
+{
+	FStressRandom Random(Config.Seed);
+
+	TArray<FStressMaterial> Materials;
+	Materials.SetNum(FMath::Max(Config.NumMaterials, 1));
+	for (FStressMaterial& Material : Materials)
+	{
+		Material.Radius = Random.Range(0.1f, 0.6f);
+		Material.Mass = Random.Range(0.2f, 20.0f);
+		Material.Damping = Random.Range(0.0f, 0.2f);
+	}
+
+	const float HalfSize = Config.WorldSize * 0.5f;
+	for (int32 i = 0; i < Config.NumBodies; ++i)
+	{
+		const FStressMaterial& Material = Materials[Random.Next() % (uint32)Materials.Num()];
+		auto Sphere = MakeShared<FPhysicsSphere>(Material.Radius, Material.Mass);
+		Sphere->SetDamping(Material.Damping);
+		Sphere->SetPosition(FVector3(Random.Range(-HalfSize, HalfSize), Random.Range(0.5f, Config.WorldSize), Random.Range(-HalfSize, HalfSize)));
+		Sphere->SetVelocity(FVector3(Random.Range(-2.0f, 2.0f), Random.Range(-2.0f, 2.0f), Random.Range(-2.0f, 2.0f)));
+		Sandbox.AddPhysicsObject(Sphere);
+	}
+
+	// Routings only run from lower to higher parameter slots, so they never form a cycle.
+	// Each routing adds an input to its target's expression.
+	FProceduralController* Controller = Sandbox.GetProceduralController();
+	Controller->SetSeed(Config.Seed);
+
+	const int32 NumParameters = (int32)EProceduralParameter::Count;
+	const int32 NumRoutings = FMath::Clamp(Config.NumRoutings, 0, (int32)FProceduralController::MaxBindings);
+	TArray<FString> Inputs[(int32)EProceduralParameter::Count];
+	TArray<EProceduralParameter> Sources[(int32)EProceduralParameter::Count];
+	for (int32 Routing = 0; Routing < NumRoutings; ++Routing)
+	{
+		const int32 Target = 1 + (int32)(Random.Next() % (uint32)(NumParameters - 1));
+		const int32 Source = (int32)(Random.Next() % (uint32)Target);
+		Inputs[Target].Add(FString::Printf(TEXT("r%d"), Routing));
+		Sources[Target].Add((EProceduralParameter)Source);
+	}
+
+	for (int32 Target = 0; Target < NumParameters; ++Target)
+	{
+		if (Inputs[Target].Num() == 0)
+		{
+			continue;
+		}
+
+		FString Expression = FString::Printf(TEXT("clamp(0.5 + 0.2 * sin(t * tau * %.3f)"), Random.Range(0.1f, 4.0f));
+		for (const FString& Input : Inputs[Target])
+		{
+			Expression += FString::Printf(TEXT(" + %.3f * (%s - 0.5)"), Random.Range(-0.3f, 0.3f), *Input);
+		}
+		Expression += TEXT(", 0, 1)");
+
+		TUniquePtr<FExpressionGenerator> Generator = MakeUnique<FExpressionGenerator>(Config.Seed + Target);
+		if (!Generator->Compile(Expression))
+		{
+			continue;
+		}
+		Controller->SetGenerator((EProceduralParameter)Target, MoveTemp(Generator));
+		for (int32 i = 0; i < Inputs[Target].Num(); ++i)
+		{
+			Controller->BindInput((EProceduralParameter)Target, Inputs[Target][i], Sources[Target][i]);
+		}
+	}
+
+	// The static-capacity profile bounds both the voices and the mixer sources they occupy
+	FAudioMixer* Mixer = Sandbox.GetAudioPhysics()->GetMixer();
+	const int32 NumVoices = FMath::Min(FMath::Min(Config.NumVoices, GetSandboxArrayLimit(FSandboxCapacity::MaxVoices)),
+		GetSandboxArrayLimit(FSandboxCapacity::MaxSources) - Mixer->GetNumSources());
+	if (NumVoices > 0)
+	{
+		TArray<TSharedPtr<FImpactSynthesizer>> Voices;
+		Voices.Reserve(NumVoices);
+		for (int32 i = 0; i < NumVoices; ++i)
+		{
+			TSharedPtr<FImpactSynthesizer> Voice = MakeShared<FImpactSynthesizer>(Sandbox.GetSampleRate());
+			Mixer->AddSource(Voice);
+			Voices.Add(Voice);
+		}
+		Sandbox.StartScript(RetriggerVoices(*Sandbox.GetScriptRunner(), MoveTemp(Voices), Random.Next()));
+	}
+}
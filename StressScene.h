@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SandboxManager.h"
+
+/**
+ * Size of a generated stress scene along each scaling dimension
+ */
+struct FStressSceneConfig
+{
+	uint32 Seed;
+	int32 NumBodies;      // Spheres scattered through the world with random velocities
+	int32 NumMaterials;   // Distinct radius/mass/damping presets the bodies are drawn from
+	int32 NumRoutings;    // Procedural parameter bindings (at most FProceduralController::MaxBindings)
+	int32 NumVoices;      // Extra impact voices on the physics mixer, retriggered by a scene script; capped by the voice and source limits
+	float WorldSize;      // Edge of the cube bodies spawn in (meters)
+
+	FStressSceneConfig()
+		: Seed(1)
+		, NumBodies(8)
+		, NumMaterials(4)
+		, NumRoutings(4)
+		, NumVoices(8)
+		, WorldSize(10.0f)
+	{
+	}
+};
+
+/**
+ * Random scene generator for scalability testing
+ *
+ * Builds a scene of any size into a sandbox. The same config and seed always
+ * build the same scene, so a measurement can be repeated, and one dimension
+ * can be scaled while the others stay put.
+ */
+class FStressSceneGenerator
+{
+public:
+	/** Populate a freshly constructed sandbox */
+	static void Build(FSandboxManager& Sandbox, const FStressSceneConfig& Config);
+};
@@ -0,0 +1,113 @@
+#include "WavWriter.h"
+#include <fstream>
+
+namespace
+{
+	void AppendTag(TArray<uint8>& Out, const char* Tag)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(Tag), 4);
+	}
+
+	template<typename T>
+	void AppendValue(TArray<uint8>& Out, T Value)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+}
+
+bool FWavWriter::WriteFloat32(const FString& Filename, const TArray<float>& Samples, int32 NumChannels, int32 SampleRate)
+{
+	if (NumChannels <= 0 || SampleRate <= 0)
+	{
+		return false;
+	}
+
+	std::ofstream Stream(*Filename, std::ios::binary | std::ios::trunc);
+	if (!Stream)
+	{
+		return false;
+	}
+
+	const uint32 DataBytes = (uint32)Samples.Num() * sizeof(float);
+
+	TArray<uint8> Header;
+	BuildHeader(Header, NumChannels, SampleRate, ESampleFormat::Float32, DataBytes);
+	Stream.write(reinterpret_cast<const char*>(Header.GetData()), Header.Num());
+	Stream.write(reinterpret_cast<const char*>(Samples.GetData()), DataBytes);
+
+	return (bool)Stream;
+}
+
+bool FWavWriter::WritePcm(const FString& Filename, const TArray<float>& Samples, int32 NumChannels, int32 SampleRate,
+	ESampleFormat Format, EDitherMode Dither, uint32 DitherSeed)
+{
+	if (Format == ESampleFormat::Float32)
+	{
+		return WriteFloat32(Filename, Samples, NumChannels, SampleRate);
+	}
+	if (NumChannels <= 0 || SampleRate <= 0)
+	{
+		return false;
+	}
+
+	std::ofstream Stream(*Filename, std::ios::binary | std::ios::trunc);
+	if (!Stream)
+	{
+		return false;
+	}
+
+	const int32 SampleBytes = GetSampleFormatBytes(Format);
+	const int32 NumFrames = Samples.Num() / NumChannels;
+	const uint32 DataBytes = (uint32)(NumFrames * NumChannels * SampleBytes);
+	TArray<uint8> Header;
+	BuildHeader(Header, NumChannels, SampleRate, Format, DataBytes);
+	Stream.write(reinterpret_cast<const char*>(Header.GetData()), Header.Num());
+
+	const int32 BlockFrames = 4096;
+	FSampleFormatConverter Converter(Format, Dither, DitherSeed);
+	TArray<uint8> Block;
+	Block.SetNum(Converter.GetOutputBytes(NumChannels, BlockFrames));
+	for (int32 Frame = 0; Frame < NumFrames; Frame += BlockFrames)
+	{
+		const int32 Count = FMath::Min(BlockFrames, NumFrames - Frame);
+		Converter.ConvertInterleaved(Samples.GetData() + Frame * NumChannels, NumChannels, Count, Block.GetData());
+		Stream.write(reinterpret_cast<const char*>(Block.GetData()), Converter.GetOutputBytes(NumChannels, Count));
+	}
+
+	return (bool)Stream;
+}
+
+void FWavWriter::BuildHeader(TArray<uint8>& OutHeader, int32 NumChannels, int32 SampleRate, ESampleFormat Format, uint32 DataBytes)
+{
+	const int32 SampleBytes = GetSampleFormatBytes(Format);
+	const uint16 BlockAlign = (uint16)(NumChannels * SampleBytes);
+	const bool bFloat = Format == ESampleFormat::Float32;
+	const uint32 FormatBytes = bFloat ? 18 : 16;
+	const uint32 FactBytes = bFloat ? 12 : 0;
+
+	OutHeader.Reset();
+	AppendTag(OutHeader, "RIFF");
+	AppendValue<uint32>(OutHeader, 4 + (8 + FormatBytes) + FactBytes + 8 + DataBytes);
+	AppendTag(OutHeader, "WAVE");
+
+	AppendTag(OutHeader, "fmt ");
+	AppendValue<uint32>(OutHeader, FormatBytes);
+	AppendValue<uint16>(OutHeader, bFloat ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+	AppendValue<uint16>(OutHeader, (uint16)NumChannels);
+	AppendValue<uint32>(OutHeader, (uint32)SampleRate);
+	AppendValue<uint32>(OutHeader, (uint32)SampleRate * BlockAlign);
+	AppendValue<uint16>(OutHeader, BlockAlign);
+	AppendValue<uint16>(OutHeader, (uint16)(SampleBytes * 8));
+
+	if (bFloat)
+	{
+		// cbSize, then the frame count every non-PCM file must give
+		AppendValue<uint16>(OutHeader, 0);
+		AppendTag(OutHeader, "fact");
+		AppendValue<uint32>(OutHeader, 4);
+		AppendValue<uint32>(OutHeader, BlockAlign > 0 ? DataBytes / BlockAlign : 0);
+	}
+
+	AppendTag(OutHeader, "data");
+	AppendValue<uint32>(OutHeader, DataBytes);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Audio/SampleFormat.h"
+
+/**
+ * Minimal RIFF/WAVE file writer for offline renders
+ * Writes interleaved 32-bit float or dithered integer PCM
+ */
+class FWavWriter
+{
+public:
+	/**
+	 * Write an interleaved float buffer to disk
+	 * @param Filename Output path
+	 * @param Samples Interleaved samples (NumFrames * NumChannels)
+	 * @param NumChannels Channel count
+	 * @param SampleRate Sample rate in Hz
+	 * @return true if the whole file was written
+	 */
+	static bool WriteFloat32(const FString& Filename, const TArray<float>& Samples, int32 NumChannels, int32 SampleRate);
+
+	/**
+	 * Write an interleaved float buffer as 16, 24 or 32-bit integer PCM (Float32 writes float)
+	 * Conversion runs in blocks, so memory use does not grow with the file
+	 * @param Dither Applied to 16 and 24-bit output
+	 * @param DitherSeed Seed of the dither noise; equal seeds give identical files
+	 */
+	static bool WritePcm(const FString& Filename, const TArray<float>& Samples, int32 NumChannels, int32 SampleRate,
+		ESampleFormat Format, EDitherMode Dither = EDitherMode::TPDF, uint32 DitherSeed = 1);
+
+	/**
+	 * Build the RIFF/WAVE header for DataBytes bytes of sample data
+	 * 44 bytes for integer PCM; float also carries cbSize and the fact chunk that non-PCM formats require
+	 * Streaming writers emit it with a size of 0 and rewrite it once the length is known
+	 */
+	static void BuildHeader(TArray<uint8>& OutHeader, int32 NumChannels, int32 SampleRate, ESampleFormat Format, uint32 DataBytes);
+};